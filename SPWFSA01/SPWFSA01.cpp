@@ -27,13 +27,29 @@ SPWFSA01::SPWFSA01(PinName tx, PinName rx,
 : SPWFSAxx(tx, rx, rts, cts, ifce, debug, wakeup, reset) {
 }
 
-bool SPWFSA01::open(const char *type, int* spwf_id, const char* addr, int port)
+bool SPWFSA01::open(const char *type, int* spwf_id, const char* addr, int port, const char *tls_domain)
 {
     int socket_id;
     int value;
     int trials;
 
-    if(!_parser.send("AT+S.SOCKON=%s,%d,%s,ind", addr, port, type))
+    /* Note: TLS domain name is a module setting (applying to all secure sockets opened afterwards),
+     *       so it must be cleared again for secure sockets not checking the server name */
+    if(type[0] == 's') {
+        if((tls_domain != NULL) && (tls_domain[0] != '\0')) {
+            if(!(_send_cmd(SPWFXX_SEND_TLS_DOMAIN "%s", tls_domain) && _recv_ok())) {
+                debug_if(_dbg_on, "\r\nSPWF> `SPWFSA01::open`: error setting TLS domain (%d)\r\n", __LINE__);
+                return false;
+            }
+        } else {
+            if(!(_send_cmd(SPWFXX_SEND_TLS_DOMAIN_CLEAN) && _recv_ok())) {
+                debug_if(_dbg_on, "\r\nSPWF> `SPWFSA01::open`: error clearing TLS domain (%d)\r\n", __LINE__);
+                return false;
+            }
+        }
+    }
+
+    if(!_send_cmd("AT+S.SOCKON=%s,%d,%s,ind", addr, port, type))
     {
         debug_if(_dbg_on, "\r\nSPWF> `SPWFSA01::open`: error opening socket (%d)\r\n", __LINE__);
         return false;
@@ -105,7 +121,7 @@ int SPWFSA01::_read_in(char* buffer, int spwf_id, uint32_t amount) {
     }
 
     /* read in data */
-    if(_parser.send("AT+S.SOCKR=%d,%u", spwf_id, (unsigned int)amount)) {
+    if(_send_cmd(SpwfCmd(SPWFXX_SEND_SOCKR).arg(spwf_id).arg(amount))) {
         /* set high timeout */
         _parser.set_timeout(SPWF_READ_BIN_TIMEOUT);
         /* read in binary data */
@@ -259,7 +275,7 @@ int SPWFSA01::scan(WiFiAccessPoint *res, unsigned limit)
     unsigned cnt = 0;
     nsapi_wifi_ap_t ap;
 
-    if (!_parser.send("AT+S.SCAN=a,s")) {
+    if (!_send_cmd("AT+S.SCAN=a,s")) {
         return NSAPI_ERROR_DEVICE_ERROR;
     }
 
@@ -40,13 +40,14 @@ public:
     /**
      * Open a socketed connection
      *
-     * @param type the type of socket to open "u" (UDP) or "t" (TCP)
+     * @param type the type of socket to open "u" (UDP), "t" (TCP) or "s" (TCP with module TLS)
      * @param id id to get the new socket number, valid 0-7
      * @param port port to open connection with
      * @param addr the IP address of the destination
+     * @param tls_domain server name to be checked against the server certificate ("s" only, NULL for no check)
      * @return true only if socket opened successfully
      */
-    bool open(const char *type, int* id, const char* addr, int port);
+    bool open(const char *type, int* id, const char* addr, int port, const char *tls_domain = NULL);
 
     /** Scan for available networks
      *
@@ -60,7 +61,9 @@ public:
 private:
     bool _recv_ap(nsapi_wifi_ap_t *ap);
 
-    virtual int _read_in(char*, int, uint32_t);
+    int _read_in(char*, int, uint32_t);
+
+    friend class SPWFSAxx;
 };
 
 #endif // SPWFSA01_H
@@ -26,15 +26,64 @@
 #define SPWFXX_OOB_ERROR            "ERROR:"                                            // "AT-S.ERROR:"
 
 #define SPWFXX_RECV_OK              "OK\n"                                              // "AT-S.OK\n"
-#define SPWFXX_RECV_WIFI_UP         "+WIND:24:WiFi Up:%u.%u.%u.%u\n"                    // "+WIND:24:WiFi Up:%*u:%u.%u.%u.%u\n"
 #define SPWFXX_RECV_IP_ADDR         "#  ip_ipaddr = %u.%u.%u.%u\n"                      // "AT-S.Var:ip_ipaddr=%u.%u.%u.%u\n"
 #define SPWFXX_RECV_GATEWAY         "#  ip_gw = %u.%u.%u.%u\n"                          // "AT-S.Var:ip_gw=%u.%u.%u.%u\n"
 #define SPWFXX_RECV_NETMASK         "#  ip_netmask = %u.%u.%u.%u\n"                     // "AT-S.Var:ip_netmask=%u.%u.%u.%u\n"
 #define SPWFXX_RECV_RX_RSSI         "#  0.rx_rssi = %d\n"                               // "AT-S.Var:0.rx_rssi=%d\n"
 #define SPWFXX_RECV_MAC_ADDR        "#  nv_wifi_macaddr = %x:%x:%x:%x:%x:%x\n"          // "AT-S.Var:nv_wifi_macaddr=%x:%x:%x:%x:%x:%x\n"
-#define SPWFXX_RECV_DATALEN         " DATALEN: %u\n"                                    // "AT-S.Query:%u\n"
-#define SPWFXX_RECV_PENDING_DATA    ":%d:%d\n"                                          // "::%u:%*u:%u\n"
-#define SPWFXX_RECV_SOCKET_CLOSED   ":%d\n"                                             // ":%u:%*u\n"
+#define SPWFXX_RECV_DATALEN         " DATALEN:"     /* value follows after blank(s) */  // "AT-S.Query:"
+
+/* field layout of WIND arguments following the description (see `SPWFSAxx::_split_fields()`) */
+#define SPWFXX_PENDING_DATA_FIELDS  (3)     /* ":<id>:<amount>" */                      // (5) "::<id>:<?>:<amount>"
+#define SPWFXX_PENDING_DATA_ID      (1)                                                 // (2)
+#define SPWFXX_PENDING_DATA_AMOUNT  (2)                                                 // (4)
+#define SPWFXX_SOCKET_CLOSED_FIELDS (2)     /* ":<id>" */                               // (3) ":<id>:<?>"
+#define SPWFXX_SOCKET_CLOSED_ID     (1)                                                 // (1)
+
+/* module identity & firmware version (see `SPWFSAxx::_probe_firmware()`) */
+#define SPWFXX_FW_PRODUCT           "SPWF01S"                                           // "SPWF04S"
+#define SPWFXX_FW_DATE_TESTED       (170111)    /* Version 3.5.3 */                     // (171117) /* Version 1.1.0 */
+
+/* TLS (secure sockets) */
+#define SPWFXX_SEND_TLS_CERT        "AT+S.TLSCERT="                                     // "AT+S.TLSCERT="
+#define SPWFXX_SEND_TLS_CLEAN       "AT+S.TLSCERT2=clean,all"                           // "AT+S.TLSCERT=clean"
+#define SPWFXX_SEND_TLS_DOMAIN      "AT+S.TLSDOMAIN=f_domain,"                          // n.a. (passed to "AT+S.SOCKON")
+#define SPWFXX_SEND_TLS_DOMAIN_CLEAN "AT+S.TLSCERT2=clean,f_domain"                    // n.a. (passed to "AT+S.SOCKON")
+#define SPWFXX_TLS_CERT_CA          "f_ca"                                              // "ca"
+#define SPWFXX_TLS_CERT_CLIENT      "f_cert"                                            // "cert"
+#define SPWFXX_TLS_CERT_KEY         "f_key"                                             // "key"
+
+/* HTTP client (see `SPWFSAxx::httpRequest()`) */
+#define SPWFXX_SEND_HTTP_GET        "AT+S.HTTPGET=%s,%s,%d,%d"  /* <host>,<path>,<port>,<tls> */    // "AT+S.HTTPGET=%s,%s,%d,%d"
+#define SPWFXX_SEND_HTTP_POST       "AT+S.HTTPPOST=%s,%s,%s,%d,%d" /* <host>,<path>,<form>,... */ // "AT+S.HTTPPOST=%s,%s,%s,%d,%d"
+#define SPWFXX_RECV_HTTP_STATUS     "HTTP/%*u.%*u %d"   /* raw status line */                   // "AT-S.Http Server Status Code:%d"
+#define SPWFXX_HTTP_RAW_HEADERS     (1)     /* response headers precede the body */             // (0)
+
+/* end of variable length data output (see `SPWFSAxx::_recv_data()`) */
+#define SPWFXX_DATA_END             "\r\nOK\r\n"                                          // "\r\nAT-S.OK\r\n"
+
+/* module file system (see `SPWFSAxx::fileList()`) */
+#define SPWFXX_SEND_FS_CREATE       "AT+S.FSC="         /* <name>,<size> */                 // "AT+S.FSC="
+#define SPWFXX_SEND_FS_APPEND       "AT+S.FSA="         /* <name>,<len> */                  // "AT+S.FSA="
+#define SPWFXX_SEND_FS_DELETE       "AT+S.FSD="                                             // "AT+S.FSD="
+#define SPWFXX_SEND_FS_LIST         "AT+S.FSL"                                              // "AT+S.FSL"
+#define SPWFXX_SEND_FS_PRINT        "AT+S.FSP="         /* <name>[,<offset>,<len>] */       // "AT+S.FSP="
+#define SPWFXX_RECV_FS_ENTRY        "%*c %u %31s"       /* "<type> <size> <name>" */        // "AT-S.File:%31[^:]:%u"
+#define SPWFXX_FS_ENTRY_SIZE_FIRST  (1)                                                     // (0)
+                                                                                      // "AT+S.HTTPGET=%s,%s,%d,%d,,,,%s" (into file)
+
+/* ping (see `SPWFSAxx::ping()`) */
+#define SPWFXX_SEND_PING            "AT+S.PING=%d,%d,%s"    /* <count>,<size>,<host> */     // "AT+S.PING=%d,%d,%s"
+#define SPWFXX_RECV_PING_REPLY      "Ping reply "       /* "<seq> from <ip>: time <ms> ms" */ // "AT-S.Reply:"
+#define SPWFXX_PING_REPLY_SEP       ' '                                                     // ':'
+#define SPWFXX_PING_REPLY_FIELDS    (6)                                                     // (3)
+#define SPWFXX_PING_REPLY_TIME      (4)                                                     // (2)
+
+/* socket server: n.a. */                                                             // "AT+S.SOCKDON=" ...
+
+/* WebSocket client: n.a. */                                                          // "AT+S.WSOCKON=" ...
+
+/* MQTT client: n.a. */                                                               // "AT+S.MQTTCONN=" ...
 
 #define SPWFXX_SEND_FWCFG           "AT&F"                                              // "AT+S.FCFG"
 #define SPWFXX_SEND_DISABLE_LE      "AT+S.SCFG=localecho1,0"                            // "AT+S.SCFG=console_echo,0"
@@ -24,16 +24,21 @@ SPWFSA04::SPWFSA04(PinName tx, PinName rx,
                    PinName rts, PinName cts,
                    SpwfSAInterface &ifce, bool debug,
                    PinName wakeup, PinName reset)
-: SPWFSAxx(tx, rx, rts, cts, ifce, debug, wakeup, reset) {
+: SPWFSAxx(tx, rx, rts, cts, ifce, debug, wakeup, reset),
+  _sockd_client_cnt(0), _sockd_refused_cnt(0),
+  _mqtt_callback() {
+    _wsock_reset();
+    _mqtt_reset();
 }
 
-bool SPWFSA04::open(const char *type, int* spwf_id, const char* addr, int port)
+bool SPWFSA04::open(const char *type, int* spwf_id, const char* addr, int port, const char *tls_domain)
 {
     int socket_id;
     int value;
     int trials;
 
-    if(!_parser.send("AT+S.SOCKON=%s,%d,NULL,%s", addr, port, type))
+    if(!_send_cmd("AT+S.SOCKON=%s,%d,%s,%s", addr, port,
+                  ((type[0] == 's') && (tls_domain != NULL)) ? tls_domain : "NULL", type))
     {
         debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::open`: error opening socket (%d)\r\n", __LINE__);
         return false;
@@ -103,7 +108,9 @@ bool SPWFSA04::open(const char *type, int* spwf_id, const char* addr, int port)
 
 int SPWFSA04::_read_in(char* buffer, int spwf_id, uint32_t amount) {
     int ret = -1;
-    int received, cumulative;
+    char line[SPWFXX_LINE_BUF_SIZE];
+    char *fields[2];
+    uint32_t received;
 
     MBED_ASSERT(buffer != NULL);
 
@@ -113,9 +120,11 @@ int SPWFSA04::_read_in(char* buffer, int spwf_id, uint32_t amount) {
     }
 
     /* read in data */
-    if(_parser.send("AT+S.SOCKR=%d,%d", spwf_id, (unsigned int)amount)) {
-        if(!(_parser.recv("AT-S.Reading:%d:%d\n", &received, &cumulative) &&
-                _recv_delim_lf())) {
+    if(_send_cmd(SpwfCmd(SPWFXX_SEND_SOCKR).arg(spwf_id).arg(amount))) {
+        if(!(_parser.recv("AT-S.Reading:")
+                && (_recv_line(line, sizeof(line)) >= 0)
+                && (_split_fields(line, ':', fields, 2) == 2) // "<received>:<cumulative>"
+                && _parse_uint(fields[0], &received))) {
             debug_if(_dbg_on, "\r\nSPWF> failed to receive AT-S.Reading (%s, %d)\r\n", __func__, __LINE__);
             empty_rx_buffer();
         } else {
@@ -284,7 +293,7 @@ nsapi_size_or_error_t SPWFSA04::scan(WiFiAccessPoint *res, unsigned limit)
     unsigned int cnt = 0, found;
     nsapi_wifi_ap_t ap;
 
-    if (!_parser.send("AT+S.SCAN=s,")) {
+    if (!_send_cmd("AT+S.SCAN=s,")) {
         return NSAPI_ERROR_DEVICE_ERROR;
     }
 
@@ -315,4 +324,806 @@ nsapi_size_or_error_t SPWFSA04::scan(WiFiAccessPoint *res, unsigned limit)
     return cnt;
 }
 
+bool SPWFSA04::sockd_open(const char *type, int port, int *sid)
+{
+    char line[SPWFXX_LINE_BUF_SIZE];
+    char *last;
+    uint32_t value;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    /* "AT-S.On:<?>:<sid>" */
+    if(!(_send_cmd(SPWFXX_SEND_SOCKD_ON "%d,%s", port, type)
+            && _parser.recv("AT-S.On:")
+            && (_recv_line(line, sizeof(line)) >= 0)
+            && ((last = strrchr(line, ':')) != NULL)
+            && _parse_uint(last + 1, &value)
+            && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::sockd_open`: error starting socket server (%d)\r\n", __LINE__);
+        empty_rx_buffer();
+        return false;
+    }
+
+    debug_if(_dbg_on, "AT^ AT-S.On:%d:%u\r\n", port, value);
+
+    /* forget about stale clients of a previous server with the same id */
+    for(int idx = _sockd_client_cnt - 1; idx >= 0; idx--) {
+        if(_sockd_clients[idx].sid == (int)value) _sockd_remove_client(idx);
+    }
+
+    *sid = (int)value;
+    return true;
+}
+
+bool SPWFSA04::sockd_close(int sid)
+{
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    for(int idx = _sockd_client_cnt - 1; idx >= 0; idx--) {
+        if(_sockd_clients[idx].sid == sid) _sockd_remove_client(idx);
+    }
+    _sockd_remove_refused(sid, -1);
+
+    if(!(_send_cmd(SPWFXX_SEND_SOCKD_OFF "%d", sid) && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::sockd_close`: error stopping socket server (%d)\r\n", __LINE__);
+        return false;
+    }
+
+    return true;
+}
+
+bool SPWFSA04::sockd_disconnect(int sid, int cid)
+{
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    if(!(_send_cmd(SPWFXX_SEND_SOCKD_DISC "%d,%d", sid, cid) && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::sockd_disconnect`: error disconnecting client (%d)\r\n", __LINE__);
+        return false;
+    }
+
+    return true;
+}
+
+bool SPWFSA04::sockd_accept(int sid, int *cid, char *addr)
+{
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    _process_winds(); // perform async indication handling (to get eventually connected clients)
+    _sockd_disconnect_refused();
+
+    for(int idx = 0; idx < _sockd_client_cnt; idx++) {
+        if(_sockd_clients[idx].sid == sid) {
+            *cid = _sockd_clients[idx].cid;
+            strcpy(addr, _sockd_clients[idx].addr);
+            _sockd_remove_client(idx);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+nsapi_size_or_error_t SPWFSA04::sockd_send(int sid, int cid, const void *data, uint32_t amount)
+{
+    uint32_t sent = 0U, to_send;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    /* betzw - WORK AROUND module FW issues: split up big packages in smaller ones */
+    for(; sent < amount; sent += to_send) {
+        to_send = ((amount - sent) > SPWFXX_SEND_RECV_PKTSIZE) ? SPWFXX_SEND_RECV_PKTSIZE : (amount - sent);
+
+        if(!(_send_cmd(SPWFXX_SEND_SOCKD_W "%d,%d,%u", sid, cid, (unsigned int)to_send)
+                && (_parser.write(((const char*)data) + sent, (int)to_send) == (int)to_send)
+                && _recv_ok())) {
+            debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::sockd_send`: failed (sent=%u, to_send=%u)\r\n", sent, to_send);
+            break;
+        }
+    }
+
+    if(sent > 0) return sent;
+    if(amount == 0) return NSAPI_ERROR_OK;
+    return NSAPI_ERROR_DEVICE_ERROR;
+}
+
+int SPWFSA04::_sockd_read_len(int sid, int cid)
+{
+    char line[SPWFXX_LINE_BUF_SIZE];
+    uint32_t amount;
+
+    if (!(_send_cmd(SPWFXX_SEND_SOCKD_Q "%d,%d", sid, cid)
+            && _parser.recv(SPWFXX_RECV_DATALEN)
+            && (_recv_line(line, sizeof(line)) >= 0)
+            && _parse_uint(line, &amount)
+            && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> %s failed\r\n", __func__);
+        return SPWFXX_ERR_LEN;
+    }
+
+    return (int)amount;
+}
+
+/* Note: data is read directly into the caller's buffer (i.e. without buffering on the host) */
+nsapi_size_or_error_t SPWFSA04::sockd_recv(int sid, int cid, void *data, uint32_t amount)
+{
+    char line[SPWFXX_LINE_BUF_SIZE];
+    char *fields[2];
+    uint32_t received;
+    int pending;
+    nsapi_size_or_error_t ret = NSAPI_ERROR_DEVICE_ERROR;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    /* block asynchronous indications */
+    if(!_winds_off()) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    pending = _sockd_read_len(sid, cid);
+    if(pending <= 0) {
+        ret = (pending < 0) ? NSAPI_ERROR_DEVICE_ERROR : 0;
+    } else {
+        if(amount > (uint32_t)pending) amount = pending;
+        if(amount > SPWFXX_SEND_RECV_PKTSIZE) amount = SPWFXX_SEND_RECV_PKTSIZE;
+
+        if(!(_send_cmd(SPWFXX_SEND_SOCKD_R "%d,%d,%u", sid, cid, (unsigned int)amount)
+                && _parser.recv("AT-S.Reading:")
+                && (_recv_line(line, sizeof(line)) >= 0)
+                && (_split_fields(line, ':', fields, 2) == 2) // "<received>:<cumulative>"
+                && _parse_uint(fields[0], &received)
+                && (received == amount))) {
+            debug_if(_dbg_on, "\r\nSPWF> failed to receive AT-S.Reading (%s, %d)\r\n", __func__, __LINE__);
+            empty_rx_buffer();
+        } else {
+            /* set high timeout */
+            _parser.set_timeout(SPWF_READ_BIN_TIMEOUT);
+            /* read in binary data */
+            int read = _parser.read((char*)data, amount);
+            /* reset timeout value */
+            _parser.set_timeout(_timeout);
+            if((read == (int)amount) && _recv_ok()) {
+                ret = amount;
+            } else {
+                debug_if(_dbg_on, "\r\nSPWF> failed to read binary data (%s, %d)\r\n", __func__, __LINE__);
+                empty_rx_buffer();
+            }
+        }
+    }
+
+    /* unblock asynchronous indications */
+    _winds_on();
+
+    return ret;
+}
+
+bool SPWFSA04::_sockd_has_client(int sid)
+{
+    for(int idx = 0; idx < _sockd_client_cnt; idx++) {
+        if(_sockd_clients[idx].sid == sid) return true;
+    }
+    return false;
+}
+
+void SPWFSA04::_sockd_remove_client(int idx)
+{
+    MBED_ASSERT((idx >= 0) && (idx < _sockd_client_cnt));
+
+    for(; idx < (_sockd_client_cnt - 1); idx++) {
+        _sockd_clients[idx] = _sockd_clients[idx + 1];
+    }
+    _sockd_client_cnt--;
+}
+
+/* Forget refused clients of server `sid` (all of them if `cid < 0`) */
+void SPWFSA04::_sockd_remove_refused(int sid, int cid)
+{
+    for(int idx = _sockd_refused_cnt - 1; idx >= 0; idx--) {
+        if((_sockd_refused[idx].sid == sid) && ((cid < 0) || (_sockd_refused[idx].cid == cid))) {
+            _sockd_refused[idx] = _sockd_refused[_sockd_refused_cnt - 1];
+            _sockd_refused_cnt--;
+        }
+    }
+}
+
+/* Disconnect clients refused by `_sockd_client_handler()` */
+void SPWFSA04::_sockd_disconnect_refused(void)
+{
+    while(_sockd_refused_cnt > 0) {
+        int sid = _sockd_refused[_sockd_refused_cnt - 1].sid;
+        int cid = _sockd_refused[_sockd_refused_cnt - 1].cid;
+
+        _sockd_refused_cnt--;
+        if(!sockd_disconnect(sid, cid)) {
+            debug("\r\nSPWF> SPWFSA04::%s: unable to disconnect refused client %d:%d!\r\n", __func__, sid, cid);
+        }
+    }
+}
+
+/* Called at initialization or after module hard fault */
+void SPWFSA04::_sockd_reset(void)
+{
+    _sockd_client_cnt = 0;
+    _sockd_refused_cnt = 0;
+}
+
+void SPWFSA04::_sockd_client_handler(char *args)
+{
+    char *fields[SPWFXX_SOCKD_CLIENT_FIELDS];
+    uint32_t sid, cid;
+
+    /* parse out the client's address, server & client id (following the description) */
+    if(!(((args = strchr(args, ':')) != NULL)
+            && (_split_fields(args, ':', fields, SPWFXX_SOCKD_CLIENT_FIELDS) == SPWFXX_SOCKD_CLIENT_FIELDS)
+            && _parse_uint(fields[SPWFXX_SOCKD_CLIENT_SID], &sid)
+            && _parse_uint(fields[SPWFXX_SOCKD_CLIENT_CID], &cid))) {
+        debug_if(_dbg_on, "\r\nSPWF> SPWFSA04::%s failed!\r\n", __func__);
+        return;
+    }
+
+    debug_if(_dbg_on, "AT^ +WIND:61:Incoming Socket Client:%s:%u:%u\r\n", fields[SPWFXX_SOCKD_CLIENT_IP], sid, cid);
+
+    if(_sockd_client_cnt == SPWFSA_SOCKD_BACKLOG) {
+        /* Note: AT commands cannot be issued from within asynchronous indication handling */
+        if(_sockd_refused_cnt == SPWFSA_SOCKD_BACKLOG) {
+            debug("\r\nSPWF> SPWFSA04::%s: backlog full, leaving client %u:%u connected!\r\n", __func__, sid, cid);
+            return;
+        }
+        debug_if(_dbg_on, "\r\nSPWF> SPWFSA04::%s: backlog full, refusing client %u:%u\r\n", __func__, sid, cid);
+        _sockd_refused[_sockd_refused_cnt].sid = (int8_t)sid;
+        _sockd_refused[_sockd_refused_cnt].cid = (int8_t)cid;
+        _sockd_refused_cnt++;
+        return;
+    }
+
+    _sockd_clients[_sockd_client_cnt].sid = (int8_t)sid;
+    _sockd_clients[_sockd_client_cnt].cid = (int8_t)cid;
+    strncpy(_sockd_clients[_sockd_client_cnt].addr, fields[SPWFXX_SOCKD_CLIENT_IP], sizeof(_sockd_clients[0].addr) - 1);
+    _sockd_clients[_sockd_client_cnt].addr[sizeof(_sockd_clients[0].addr) - 1] = '\0';
+    _sockd_client_cnt++;
+
+    /* force call of (external) callback (signals listening sockets) */
+    _call_callback();
+}
+
+void SPWFSA04::_sockd_gone_handler(char *args)
+{
+    char *fields[SPWFXX_SOCKD_CLIENT_FIELDS];
+    uint32_t sid, cid;
+    int internal_id;
+
+    if(!(((args = strchr(args, ':')) != NULL)
+            && (_split_fields(args, ':', fields, SPWFXX_SOCKD_CLIENT_FIELDS) == SPWFXX_SOCKD_CLIENT_FIELDS)
+            && _parse_uint(fields[SPWFXX_SOCKD_CLIENT_SID], &sid)
+            && _parse_uint(fields[SPWFXX_SOCKD_CLIENT_CID], &cid))) {
+        debug_if(_dbg_on, "\r\nSPWF> SPWFSA04::%s failed!\r\n", __func__);
+        return;
+    }
+
+    debug_if(_dbg_on, "AT^ +WIND:62:Socket Client Gone:%u:%u\r\n", sid, cid);
+
+    /* not yet accepted (or refused) */
+    for(int idx = _sockd_client_cnt - 1; idx >= 0; idx--) {
+        if((_sockd_clients[idx].sid == (int)sid) && (_sockd_clients[idx].cid == (int)cid)) {
+            _sockd_remove_client(idx);
+        }
+    }
+    _sockd_remove_refused(sid, cid);
+
+    /* already accepted: only set `server_gone` (user still can receive data & must still explicitly close the socket) */
+    internal_id = _associated_interface.get_sockd_internal_id(sid, cid);
+    if(internal_id != SPWFSA_SOCKET_COUNT) {
+        _associated_interface._ids[internal_id].server_gone = true;
+        _associated_interface._rx_signal(internal_id);
+    }
+
+    /* force call of (external) callback */
+    _call_callback();
+}
+
+void SPWFSA04::_sockd_data_handler(char *args)
+{
+    char *fields[SPWFXX_SOCKD_DATA_FIELDS];
+    uint32_t sid, cid;
+    int internal_id;
+
+    if(!(((args = strchr(args, ':')) != NULL)
+            && (_split_fields(args, ':', fields, SPWFXX_SOCKD_DATA_FIELDS) == SPWFXX_SOCKD_DATA_FIELDS)
+            && _parse_uint(fields[SPWFXX_SOCKD_DATA_SID], &sid)
+            && _parse_uint(fields[SPWFXX_SOCKD_DATA_CID], &cid))) {
+        debug_if(_dbg_on, "\r\nSPWF> SPWFSA04::%s failed!\r\n", __func__);
+        return;
+    }
+
+    debug_if(_dbg_on, "AT^ +WIND:64:Sockd Pending Data:%u:%u\r\n", sid, cid);
+
+    internal_id = _associated_interface.get_sockd_internal_id(sid, cid);
+    if(internal_id != SPWFSA_SOCKET_COUNT) {
+        _associated_interface._ids[internal_id].sockd_pending = true;
+        _associated_interface._rx_signal(internal_id);
+    }
+
+    /* force call of (external) callback */
+    _call_callback();
+}
+
+bool SPWFSA04::wsock_open(const char *host, int port, const char *path, bool tls, int *id)
+{
+    char line[SPWFXX_LINE_BUF_SIZE];
+    char *last;
+    uint32_t value;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    /* "AT-S.On:<?>:<id>" */
+    if(!(_send_cmd(SPWFXX_SEND_WSOCK_ON "%s,%d,%s,%d", host, port, path, tls ? 1 : 0)
+            && _parser.recv("AT-S.On:")
+            && (_recv_line(line, sizeof(line)) >= 0)
+            && ((last = strrchr(line, ':')) != NULL)
+            && _parse_uint(last + 1, &value)
+            && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::wsock_open`: error opening WebSocket (%d)\r\n", __LINE__);
+        empty_rx_buffer();
+        return false;
+    }
+
+    debug_if(_dbg_on, "AT^ AT-S.On:%s:%u\r\n", host, value);
+
+    if(value >= SPWFSA_WSOCK_COUNT) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::wsock_open`: unexpected WebSocket id %u (%d)\r\n", value, __LINE__);
+        if(_send_cmd(SPWFXX_SEND_WSOCK_OFF "%u", value)) _recv_ok();
+        return false;
+    }
+
+    memset(&_wsocks[value], 0, sizeof(_wsocks[0]));
+    _wsocks[value].open = true;
+
+    *id = (int)value;
+    return true;
+}
+
+bool SPWFSA04::wsock_close(int id)
+{
+    bool closed;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    MBED_ASSERT(((unsigned int)id) < ((unsigned int)SPWFSA_WSOCK_COUNT));
+
+    closed = _wsocks[id].closed;
+    memset(&_wsocks[id], 0, sizeof(_wsocks[0]));
+    if(closed) return true; // already gone on module side
+
+    if(!(_send_cmd(SPWFXX_SEND_WSOCK_OFF "%d", id) && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::wsock_close`: error closing WebSocket (%d)\r\n", __LINE__);
+        return false;
+    }
+
+    return true;
+}
+
+/* Note: messages get not split up (as they would be received as several messages by the server) */
+nsapi_size_or_error_t SPWFSA04::wsock_send(int id, const void *data, uint32_t amount)
+{
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    MBED_ASSERT(((unsigned int)id) < ((unsigned int)SPWFSA_WSOCK_COUNT));
+
+    if(amount > SPWFXX_SEND_RECV_PKTSIZE) return NSAPI_ERROR_PARAMETER;
+    if(_wsocks[id].closed) return NSAPI_ERROR_CONNECTION_LOST;
+
+    if(!(_send_cmd(SPWFXX_SEND_WSOCK_W "%d,%u", id, (unsigned int)amount)
+            && (_parser.write((const char*)data, (int)amount) == (int)amount)
+            && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::wsock_send`: failed (amount=%u)\r\n", amount);
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    return amount;
+}
+
+/* Note: data is read directly into the caller's buffer (i.e. without buffering on the host) */
+nsapi_size_or_error_t SPWFSA04::wsock_recv(int id, void *data, uint32_t amount)
+{
+    uint32_t len;
+    bool read;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    MBED_ASSERT(((unsigned int)id) < ((unsigned int)SPWFSA_WSOCK_COUNT));
+
+    _process_winds(); // perform async indication handling (to get eventually completed messages)
+
+    if(_wsocks[id].msg_cnt == 0) {
+        if(_wsocks[id].overflow) return NSAPI_ERROR_DEVICE_ERROR;
+        return _wsocks[id].closed ? NSAPI_ERROR_CONNECTION_LOST : NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    len = _wsocks[id].msgs[0];
+    if(len > amount) return NSAPI_ERROR_NO_MEMORY;
+
+    /* block asynchronous indications */
+    if(!_winds_off()) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    read = _wsock_read(id, (char*)data, len);
+
+    /* unblock asynchronous indications */
+    _winds_on();
+
+    if(!read) return NSAPI_ERROR_DEVICE_ERROR;
+
+    _wsocks[id].msg_cnt--;
+    memmove(&_wsocks[id].msgs[0], &_wsocks[id].msgs[1], _wsocks[id].msg_cnt * sizeof(_wsocks[id].msgs[0]));
+
+    return len;
+}
+
+/* Read `amount` bytes in chunks of at most `SPWFXX_SEND_RECV_PKTSIZE` bytes (with asynchronous indications blocked) */
+bool SPWFSA04::_wsock_read(int id, char *data, uint32_t amount)
+{
+    char line[SPWFXX_LINE_BUF_SIZE];
+    char *fields[2];
+    uint32_t received, chunk;
+
+    for(; amount > 0; data += chunk, amount -= chunk) {
+        chunk = (amount > SPWFXX_SEND_RECV_PKTSIZE) ? SPWFXX_SEND_RECV_PKTSIZE : amount;
+
+        if(!(_send_cmd(SPWFXX_SEND_WSOCK_R "%d,%u", id, (unsigned int)chunk)
+                && _parser.recv("AT-S.Reading:")
+                && (_recv_line(line, sizeof(line)) >= 0)
+                && (_split_fields(line, ':', fields, 2) == 2) // "<received>:<cumulative>"
+                && _parse_uint(fields[0], &received)
+                && (received == chunk))) {
+            debug_if(_dbg_on, "\r\nSPWF> failed to receive AT-S.Reading (%s, %d)\r\n", __func__, __LINE__);
+            empty_rx_buffer();
+            return false;
+        }
+
+        /* set high timeout */
+        _parser.set_timeout(SPWF_READ_BIN_TIMEOUT);
+        /* read in binary data */
+        int read = _parser.read(data, chunk);
+        /* reset timeout value */
+        _parser.set_timeout(_timeout);
+        if(!((read == (int)chunk) && _recv_ok())) {
+            debug_if(_dbg_on, "\r\nSPWF> failed to read binary data (%s, %d)\r\n", __func__, __LINE__);
+            empty_rx_buffer();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Called at initialization or after module hard fault */
+void SPWFSA04::_wsock_reset(void)
+{
+    memset(_wsocks, 0, sizeof(_wsocks));
+}
+
+/* Called after module hard fault (session-preserving recovery) */
+void SPWFSA04::_wsock_lost(void)
+{
+    /* only set `closed` (user must still explicitly close the connection) */
+    for(int id = 0; id < SPWFSA_WSOCK_COUNT; id++) {
+        if(_wsocks[id].open) {
+            _wsocks[id].closed = true;
+            _wsocks[id].overflow = false;
+            _wsocks[id].partial = 0;
+            _wsocks[id].msg_cnt = 0;
+        }
+    }
+}
+
+void SPWFSA04::_wsock_closed_handler(char *args)
+{
+    char *fields[SPWFXX_WSOCK_CLOSED_FIELDS];
+    uint32_t id;
+
+    if(!(((args = strchr(args, ':')) != NULL)
+            && (_split_fields(args, ':', fields, SPWFXX_WSOCK_CLOSED_FIELDS) == SPWFXX_WSOCK_CLOSED_FIELDS)
+            && _parse_uint(fields[SPWFXX_WSOCK_CLOSED_ID], &id))) {
+        debug_if(_dbg_on, "\r\nSPWF> SPWFSA04::%s failed!\r\n", __func__);
+        return;
+    }
+
+    debug_if(_dbg_on, "AT^ +WIND:89:WebSocket Closed:%u\r\n", id);
+
+    /* only set `closed` (user still can receive complete messages & must still explicitly close the connection) */
+    if((id < SPWFSA_WSOCK_COUNT) && _wsocks[id].open) {
+        _wsocks[id].closed = true;
+    }
+
+    /* force call of (external) callback */
+    _call_callback();
+}
+
+/*
+ * Handling oob ("+WIND:90:WebSocket Data")
+ *
+ * Note: data is left on the module, only message boundaries (i.e. last frames) get recorded
+ */
+void SPWFSA04::_wsock_data_handler(char *args)
+{
+    char *fields[SPWFXX_WSOCK_DATA_FIELDS];
+    uint32_t id, last, len;
+
+    if(!(((args = strchr(args, ':')) != NULL)
+            && (_split_fields(args, ':', fields, SPWFXX_WSOCK_DATA_FIELDS) == SPWFXX_WSOCK_DATA_FIELDS)
+            && _parse_uint(fields[SPWFXX_WSOCK_DATA_ID], &id)
+            && _parse_uint(fields[SPWFXX_WSOCK_DATA_LAST], &last)
+            && _parse_uint(fields[SPWFXX_WSOCK_DATA_LEN], &len))) {
+        debug_if(_dbg_on, "\r\nSPWF> SPWFSA04::%s failed!\r\n", __func__);
+        return;
+    }
+
+    debug_if(_dbg_on, "AT^ +WIND:90:WebSocket Data:%u:%u:%u\r\n", id, last, len);
+
+    if(!((id < SPWFSA_WSOCK_COUNT) && _wsocks[id].open)) {
+        debug_if(_dbg_on, "\r\nSPWFSA04::%s got invalid id %u\r\n", __func__, id);
+        return;
+    }
+
+    if(_wsocks[id].overflow) return; // message boundaries are lost
+
+    _wsocks[id].partial += len;
+    if(!last) return; // wait for message to complete
+
+    if(_wsocks[id].msg_cnt < SPWFSA_WSOCK_MSG_QUEUE) {
+        _wsocks[id].msgs[_wsocks[id].msg_cnt++] = _wsocks[id].partial;
+    } else {
+        /* stop tracking messages (queued ones can still be received) */
+        debug_if(_dbg_on, "\r\nSPWF> SPWFSA04::%s: message queue full (%u)\r\n", __func__, id);
+        _wsocks[id].overflow = true;
+    }
+    _wsocks[id].partial = 0;
+
+    /* force call of (external) callback */
+    _call_callback();
+}
+
+/* Note: the body does not cross the UART, only the status & final result are received */
+bool SPWFSA04::httpGetToFile(const char *host, const char *path, int port, bool tls, const char *file, int *status)
+{
+    char line[SPWFXX_HTTP_LINE_SIZE];
+    bool ret = false;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    *status = 0;
+
+    /* block asynchronous indications (would otherwise get mixed into the response) */
+    if(!_winds_off()) {
+        return false;
+    }
+
+    if(_send_cmd(SPWFXX_SEND_HTTP_GET_FILE, host, path, port, tls ? 1 : 0, file)) {
+        while(_recv_line(line, sizeof(line)) >= 0) {
+            if(_is_ok_line(line)) {
+#if defined(SPWFSAXX_CMD_STATS)
+                _cmd_stats_stop();
+#endif
+                ret = true;
+                break;
+            }
+            if(strncmp(line, "ERROR", 5) == 0) {
+                debug_if(_dbg_on, "AT^ %s (%d)\r\n", line, __LINE__);
+                break;
+            }
+            sscanf(line, SPWFXX_RECV_HTTP_STATUS, status);
+        }
+    }
+
+    if(!ret) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::httpGetToFile`: failed (%d)\r\n", __LINE__);
+        empty_rx_buffer();
+    }
+
+    /* unblock asynchronous indications */
+    _winds_on();
+
+    return ret;
+}
+
+bool SPWFSA04::mqtt_connect(const char *host, int port, bool tls, const char *user, const char *pass,
+                            const char *client_id, int keepalive, int *id)
+{
+    char line[SPWFXX_LINE_BUF_SIZE];
+    char *last;
+    uint32_t value;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    /* "AT-S.On:<?>:<id>" */
+    if(!(_send_cmd(SPWFXX_SEND_MQTT_CONN "%s,%d,%d,%s,%s,%s,%d", host, port, tls ? 1 : 0,
+                   (user != NULL) ? user : "", (pass != NULL) ? pass : "", client_id, keepalive)
+            && _parser.recv("AT-S.On:")
+            && (_recv_line(line, sizeof(line)) >= 0)
+            && ((last = strrchr(line, ':')) != NULL)
+            && _parse_uint(last + 1, &value)
+            && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::mqtt_connect`: error connecting to broker (%d)\r\n", __LINE__);
+        empty_rx_buffer();
+        return false;
+    }
+
+    debug_if(_dbg_on, "AT^ AT-S.On:%s:%u\r\n", host, value);
+
+    if(value >= SPWFSA_MQTT_COUNT) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::mqtt_connect`: unexpected MQTT id %u (%d)\r\n", value, __LINE__);
+        if(_send_cmd(SPWFXX_SEND_MQTT_DISC "%u", value)) _recv_ok();
+        return false;
+    }
+
+    _mqtt_connected[value] = true;
+
+    *id = (int)value;
+    return true;
+}
+
+bool SPWFSA04::mqtt_disconnect(int id)
+{
+    bool connected;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    MBED_ASSERT(((unsigned int)id) < ((unsigned int)SPWFSA_MQTT_COUNT));
+
+    connected = _mqtt_connected[id];
+    _mqtt_connected[id] = false;
+    if(!connected) return true; // already gone on module side
+
+    if(!(_send_cmd(SPWFXX_SEND_MQTT_DISC "%d", id) && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::mqtt_disconnect`: error disconnecting (%d)\r\n", __LINE__);
+        return false;
+    }
+
+    return true;
+}
+
+/* Note: one single AT command per message (i.e. no per packet transactions like with `SOCKW`) */
+bool SPWFSA04::mqtt_publish(int id, const char *topic, const void *payload, uint32_t len, int qos, bool retain)
+{
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    MBED_ASSERT(((unsigned int)id) < ((unsigned int)SPWFSA_MQTT_COUNT));
+
+    if(!(_send_cmd(SPWFXX_SEND_MQTT_PUB "%d,%s,%d,%d,%u", id, topic, qos, retain ? 1 : 0, (unsigned int)len)
+            && (_parser.write((const char*)payload, (int)len) == (int)len)
+            && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::mqtt_publish`: failed (len=%u)\r\n", len);
+        empty_rx_buffer();
+        return false;
+    }
+
+    return true;
+}
+
+bool SPWFSA04::mqtt_subscribe(int id, const char *topic, int qos, bool subscribe)
+{
+    bool sent;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    MBED_ASSERT(((unsigned int)id) < ((unsigned int)SPWFSA_MQTT_COUNT));
+
+    if(subscribe) {
+        sent = _send_cmd(SPWFXX_SEND_MQTT_SUB "%d,%s,%d", id, topic, qos);
+    } else {
+        sent = _send_cmd(SPWFXX_SEND_MQTT_UNSUB "%d,%s", id, topic);
+    }
+
+    if(!(sent && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::mqtt_subscribe`: failed (%s)\r\n", topic);
+        return false;
+    }
+
+    return true;
+}
+
+bool SPWFSA04::mqtt_ping(int id)
+{
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    MBED_ASSERT(((unsigned int)id) < ((unsigned int)SPWFSA_MQTT_COUNT));
+
+    if(!(_send_cmd(SPWFXX_SEND_MQTT_PING "%d", id) && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> `SPWFSA04::mqtt_ping`: failed (%d)\r\n", __LINE__);
+        return false;
+    }
+
+    return true;
+}
+
+/* Called at initialization or after module hard fault */
+void SPWFSA04::_mqtt_reset(void)
+{
+    memset(_mqtt_connected, 0, sizeof(_mqtt_connected));
+}
+
+/*
+ * Handling oob ("+WIND:93:MQTT Published")
+ *
+ * Note: the payload immediately follows the indication & gets read in here,
+ *       bytes exceeding `SPWFSA_MQTT_PAYLOAD_SIZE` are discarded
+ */
+void SPWFSA04::_mqtt_published_handler(char *args)
+{
+    char *topic, *last;
+    uint32_t id, len, stored;
+    int c;
+
+    /* ":<id>:<topic>:<length>" (topic might contain ':') */
+    if(!(((args = strchr(args, ':')) != NULL)
+            && ((topic = strchr(args + 1, ':')) != NULL)
+            && ((last = strrchr(topic, ':')) != topic)
+            && _parse_uint(last + 1, &len))) {
+        debug_if(_dbg_on, "\r\nSPWF> SPWFSA04::%s failed!\r\n", __func__);
+        return;
+    }
+    *topic++ = '\0';
+    *last = '\0';
+
+    if(!_parse_uint(args + 1, &id)) {
+        debug_if(_dbg_on, "\r\nSPWF> SPWFSA04::%s failed!\r\n", __func__);
+        return;
+    }
+
+    debug_if(_dbg_on, "AT^ +WIND:93:MQTT Published:%u:%s:%u\r\n", id, topic, len);
+
+    /* read in payload */
+    stored = (len > SPWFSA_MQTT_PAYLOAD_SIZE) ? SPWFSA_MQTT_PAYLOAD_SIZE : len;
+    if(_parser.read((char*)_mqtt_payload, stored) != (int)stored) {
+        debug_if(_dbg_on, "\r\nSPWF> SPWFSA04::%s: failed to read payload\r\n", __func__);
+        empty_rx_buffer();
+        return;
+    }
+    for(uint32_t discarded = stored; discarded < len; discarded++) {
+        if((c = _parser.getc()) < 0) break;
+    }
+
+    if((id < SPWFSA_MQTT_COUNT) && _mqtt_connected[id] && _mqtt_callback) {
+        _mqtt_callback((int)id, topic, _mqtt_payload, stored, len);
+    }
+}
+
+void SPWFSA04::_mqtt_closed_handler(char *args)
+{
+    char *fields[SPWFXX_MQTT_CLOSED_FIELDS];
+    uint32_t id;
+
+    if(!(((args = strchr(args, ':')) != NULL)
+            && (_split_fields(args, ':', fields, SPWFXX_MQTT_CLOSED_FIELDS) == SPWFXX_MQTT_CLOSED_FIELDS)
+            && _parse_uint(fields[SPWFXX_MQTT_CLOSED_ID], &id))) {
+        debug_if(_dbg_on, "\r\nSPWF> SPWFSA04::%s failed!\r\n", __func__);
+        return;
+    }
+
+    debug_if(_dbg_on, "AT^ +WIND:94:MQTT Closed:%u\r\n", id);
+
+    if(id < SPWFSA_MQTT_COUNT) {
+        _mqtt_connected[id] = false;
+    }
+
+    /* force call of (external) callback */
+    _call_callback();
+}
+
 #endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD
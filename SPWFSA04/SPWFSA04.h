@@ -40,13 +40,14 @@ public:
     /**
      * Open a socketed connection
      *
-     * @param type the type of socket to open "u" (UDP) or "t" (TCP)
+     * @param type the type of socket to open "u" (UDP), "t" (TCP) or "s" (TCP with module TLS)
      * @param id id to get the new socket number, valid 0-7
      * @param port port to open connection with
      * @param addr the IP address of the destination
+     * @param tls_domain server name to be checked against the server certificate ("s" only, NULL for no check)
      * @return true only if socket opened successfully
      */
-    bool open(const char *type, int* id, const char* addr, int port);
+    bool open(const char *type, int* id, const char* addr, int port, const char *tls_domain = NULL);
 
     /** Scan for available networks
      *
@@ -57,10 +58,227 @@ public:
      */
     nsapi_size_or_error_t scan(WiFiAccessPoint *res, unsigned limit);
 
+    /**
+     * Start a socket server
+     *
+     * @param type the type of server to start "t" (TCP)
+     * @param port local port to listen on
+     * @param sid id to get the new server number
+     * @return true only if server started successfully
+     */
+    bool sockd_open(const char *type, int port, int *sid);
+
+    /**
+     * Stop a socket server (disconnecting all of its clients)
+     *
+     * @param sid server id
+     * @return true only if server stopped successfully
+     */
+    bool sockd_close(int sid);
+
+    /**
+     * Disconnect a single client of a socket server
+     *
+     * Note: relies on the optional client id argument of the server stop command (see `SPWFXX_SEND_SOCKD_DISC`),
+     *       which has not been verified on module hardware. A firmware ignoring it would stop the whole server.
+     *
+     * @param sid server id
+     * @param cid client id
+     * @return true only if client disconnected successfully
+     */
+    bool sockd_disconnect(int sid, int cid);
+
+    /**
+     * Get the oldest connected but not yet accepted client of a socket server
+     *
+     * @param sid server id
+     * @param cid id to get the client number
+     * @param addr buffer (of at least 16 bytes) to get the client's IP address
+     * @return true only if a client has been returned
+     */
+    bool sockd_accept(int sid, int *cid, char *addr);
+
+    /**
+     * Send data to a socket server client
+     *
+     * @return number of bytes sent or negative error code
+     */
+    nsapi_size_or_error_t sockd_send(int sid, int cid, const void *data, uint32_t amount);
+
+    /**
+     * Receive data (left on the module) from a socket server client
+     *
+     * @return number of bytes received, `0` if no data is pending, or negative error code
+     */
+    nsapi_size_or_error_t sockd_recv(int sid, int cid, void *data, uint32_t amount);
+
+    /**
+     * Open a WebSocket client connection
+     *
+     * @param host host name (or IP address) of the server
+     * @param port server port
+     * @param path resource path (e.g. "/")
+     * @param tls true to use a secure WebSocket ("wss")
+     * @param id id to get the new connection number (`0` to `SPWFSA_WSOCK_COUNT - 1`)
+     * @return true only if the connection has been established
+     */
+    bool wsock_open(const char *host, int port, const char *path, bool tls, int *id);
+
+    /**
+     * Close a WebSocket client connection
+     *
+     * @param id connection id
+     * @return true only if successful
+     */
+    bool wsock_close(int id);
+
+    /**
+     * Send a (single frame) message
+     *
+     * @return number of bytes sent or negative error code
+     */
+    nsapi_size_or_error_t wsock_send(int id, const void *data, uint32_t amount);
+
+    /**
+     * Receive the oldest complete message (left on the module)
+     *
+     * @return length of the message, `NSAPI_ERROR_WOULD_BLOCK` if no complete message is pending,
+     *         `NSAPI_ERROR_NO_MEMORY` if the message is longer than `amount` (it is left on the module),
+     *         or other negative error code
+     */
+    nsapi_size_or_error_t wsock_recv(int id, void *data, uint32_t amount);
+
+    /**
+     * Perform an HTTP GET request storing the response body into a file of the module's file system
+     *
+     * @param host host name (or IP address) of the server
+     * @param path path (& query) of the resource
+     * @param port server port
+     * @param tls true to use HTTPS
+     * @param file name of the file to store the body into
+     * @param status set to the HTTP status code (`0` if unknown)
+     * @return true only if successful
+     */
+    bool httpGetToFile(const char *host, const char *path, int port, bool tls, const char *file, int *status);
+
+    /**
+     * Connect the module's MQTT client to a broker
+     *
+     * @param host host name (or IP address) of the broker
+     * @param port broker port
+     * @param tls true to use MQTT over TLS
+     * @param user user name (`NULL` for none)
+     * @param pass password (`NULL` for none)
+     * @param client_id MQTT client identifier
+     * @param keepalive keep-alive interval (in seconds, handled by the module)
+     * @param id id to get the new connection number (`0` to `SPWFSA_MQTT_COUNT - 1`)
+     * @return true only if connected successfully
+     */
+    bool mqtt_connect(const char *host, int port, bool tls, const char *user, const char *pass,
+                      const char *client_id, int keepalive, int *id);
+
+    /**
+     * Disconnect from a broker
+     *
+     * @param id connection id
+     * @return true only if successful
+     */
+    bool mqtt_disconnect(int id);
+
+    /**
+     * Publish a message (of at most `SPWFXX_SEND_RECV_PKTSIZE` bytes)
+     *
+     * @return true only if successful
+     */
+    bool mqtt_publish(int id, const char *topic, const void *payload, uint32_t len, int qos, bool retain);
+
+    /**
+     * Subscribe to (`subscribe == true`) or unsubscribe from a topic (filter)
+     *
+     * @return true only if successful
+     */
+    bool mqtt_subscribe(int id, const char *topic, int qos, bool subscribe);
+
+    /**
+     * Send a ping request to the broker
+     *
+     * @return true only if successful
+     */
+    bool mqtt_ping(int id);
+
+    /**
+     * Check whether a connection is (still) established
+     */
+    bool mqtt_is_connected(int id) {
+        return _mqtt_connected[id];
+    }
+
+    /**
+     * Attach a function to be called (from within asynchronous indication handling) for each incoming message
+     */
+    void mqtt_attach(spwf_mqtt_cb_t func) {
+        _mqtt_callback = func;
+    }
+
 private:
     bool _recv_ap(nsapi_wifi_ap_t *ap);
 
-    virtual int _read_in(char*, int, uint32_t);
+    /* clients connected but not yet accepted */
+    struct {
+        int8_t sid;
+        int8_t cid;
+        char addr[16];
+    } _sockd_clients[SPWFSA_SOCKD_BACKLOG];
+    int _sockd_client_cnt;
+
+    /* clients refused (backlog full), to be disconnected outside of asynchronous indication handling */
+    struct {
+        int8_t sid;
+        int8_t cid;
+    } _sockd_refused[SPWFSA_SOCKD_BACKLOG];
+    int _sockd_refused_cnt;
+
+    bool _sockd_has_client(int sid);
+    int _sockd_read_len(int sid, int cid);
+    void _sockd_remove_client(int idx);
+    void _sockd_remove_refused(int sid, int cid);
+    void _sockd_disconnect_refused(void);
+    void _sockd_reset(void);
+
+    /* WebSocket client connections */
+    struct {
+        bool open;
+        bool closed;                            // closed by server or module
+        bool overflow;                          // message queue overflowed (further message boundaries unknown)
+        uint32_t partial;                       // bytes received so far of the message in progress
+        uint32_t msgs[SPWFSA_WSOCK_MSG_QUEUE];  // lengths of complete messages (oldest first)
+        int msg_cnt;
+    } _wsocks[SPWFSA_WSOCK_COUNT];
+
+    bool _wsock_read(int id, char *data, uint32_t amount);
+    void _wsock_reset(void);
+    void _wsock_lost(void);
+
+    /* MQTT client connections */
+    bool _mqtt_connected[SPWFSA_MQTT_COUNT];
+    spwf_mqtt_cb_t _mqtt_callback;
+    uint8_t _mqtt_payload[SPWFSA_MQTT_PAYLOAD_SIZE];
+
+    void _mqtt_reset(void);
+
+    /* WIND handlers (called by `SPWFSAxx::_wind_handler()`) */
+    void _sockd_client_handler(char *args);
+    void _sockd_gone_handler(char *args);
+    void _sockd_data_handler(char *args);
+    void _wsock_closed_handler(char *args);
+    void _wsock_data_handler(char *args);
+    void _mqtt_published_handler(char *args);
+    void _mqtt_closed_handler(char *args);
+
+    int _read_in(char*, int, uint32_t);
+
+    friend class SPWFSAxx;
+    friend class SpwfSAInterface;
 };
 
 #endif // SPWFSA04_H
@@ -33,15 +33,98 @@
 #define SPWFXX_OOB_ERROR            "AT-S.ERROR:"                                           // "ERROR:"
 
 #define SPWFXX_RECV_OK              "AT-S.OK\n"                                             // "OK\n"
-#define SPWFXX_RECV_WIFI_UP         "+WIND:24:WiFi Up:%*u:%u.%u.%u.%u\n"                    // "+WIND:24:WiFi Up:%u.%u.%u.%u\n"
 #define SPWFXX_RECV_IP_ADDR         "AT-S.Var:ip_ipaddr=%u.%u.%u.%u\n"                      // "#  ip_ipaddr = %u.%u.%u.%u\n"
 #define SPWFXX_RECV_GATEWAY         "AT-S.Var:ip_gw=%u.%u.%u.%u\n"                          // "#  ip_gw = %u.%u.%u.%u\n"
 #define SPWFXX_RECV_NETMASK         "AT-S.Var:ip_netmask=%u.%u.%u.%u\n"                     // "#  ip_netmask = %u.%u.%u.%u\n"
 #define SPWFXX_RECV_RX_RSSI         "AT-S.Var:0.rx_rssi=%d\n"                               // "#  0.rx_rssi = %d\n"
 #define SPWFXX_RECV_MAC_ADDR        "AT-S.Var:nv_wifi_macaddr=%x:%x:%x:%x:%x:%x\n"          // "#  nv_wifi_macaddr = %x:%x:%x:%x:%x:%x\n"
-#define SPWFXX_RECV_DATALEN         "AT-S.Query:%u\n"                                       // " DATALEN: %u\n"
-#define SPWFXX_RECV_PENDING_DATA    "::%u:%*u:%u\n"                                         // ":%d:%d\n"
-#define SPWFXX_RECV_SOCKET_CLOSED   ":%u:%*u\n"                                             // ":%d\n"
+#define SPWFXX_RECV_DATALEN         "AT-S.Query:"                                           // " DATALEN:"
+
+/* field layout of WIND arguments following the description (see `SPWFSAxx::_split_fields()`) */
+#define SPWFXX_PENDING_DATA_FIELDS  (5)     /* "::<id>:<?>:<amount>" */                     // (3) ":<id>:<amount>"
+#define SPWFXX_PENDING_DATA_ID      (2)                                                     // (1)
+#define SPWFXX_PENDING_DATA_AMOUNT  (4)                                                     // (2)
+#define SPWFXX_SOCKET_CLOSED_FIELDS (3)     /* ":<id>:<?>" */                               // (2) ":<id>"
+#define SPWFXX_SOCKET_CLOSED_ID     (1)                                                     // (1)
+
+/* module identity & firmware version (see `SPWFSAxx::_probe_firmware()`) */
+#define SPWFXX_FW_PRODUCT           "SPWF04S"                                               // "SPWF01S"
+#define SPWFXX_FW_DATE_TESTED       (171117)    /* Version 1.1.0 */                         // (170111) /* Version 3.5.3 */
+
+/* TLS (secure sockets) */
+#define SPWFXX_SEND_TLS_CERT        "AT+S.TLSCERT="                                         // "AT+S.TLSCERT="
+#define SPWFXX_SEND_TLS_CLEAN       "AT+S.TLSCERT=clean"                                    // "AT+S.TLSCERT2=clean,all"
+                                                                                            // "AT+S.TLSDOMAIN=f_domain,"
+                                                                                            // "AT+S.TLSCERT2=clean,f_domain"
+#define SPWFXX_TLS_CERT_CA          "ca"                                                    // "f_ca"
+#define SPWFXX_TLS_CERT_CLIENT      "cert"                                                  // "f_cert"
+#define SPWFXX_TLS_CERT_KEY         "key"                                                   // "f_key"
+
+/* HTTP client (see `SPWFSAxx::httpRequest()`) */
+#define SPWFXX_SEND_HTTP_GET        "AT+S.HTTPGET=%s,%s,%d,%d"  /* <host>,<path>,<port>,<tls> */        // "AT+S.HTTPGET=%s,%s,%d,%d"
+#define SPWFXX_SEND_HTTP_POST       "AT+S.HTTPPOST=%s,%s,%s,%d,%d" /* <host>,<path>,<form>,... */     // "AT+S.HTTPPOST=%s,%s,%s,%d,%d"
+#define SPWFXX_RECV_HTTP_STATUS     "AT-S.Http Server Status Code:%d"                               // "HTTP/%*u.%*u %d"
+#define SPWFXX_HTTP_RAW_HEADERS     (0)     /* module strips response headers */                    // (1)
+
+/* end of variable length data output (see `SPWFSAxx::_recv_data()`) */
+#define SPWFXX_DATA_END             "\r\nAT-S.OK\r\n"                                           // "\r\nOK\r\n"
+
+/* module file system (see `SPWFSAxx::fileList()`) */
+#define SPWFXX_SEND_FS_CREATE       "AT+S.FSC="         /* <name>,<size> */                     // "AT+S.FSC="
+#define SPWFXX_SEND_FS_APPEND       "AT+S.FSA="         /* <name>,<len> */                      // "AT+S.FSA="
+#define SPWFXX_SEND_FS_DELETE       "AT+S.FSD="                                                 // "AT+S.FSD="
+#define SPWFXX_SEND_FS_LIST         "AT+S.FSL"                                                  // "AT+S.FSL"
+#define SPWFXX_SEND_FS_PRINT        "AT+S.FSP="         /* <name>[,<offset>,<len>] */           // "AT+S.FSP="
+#define SPWFXX_RECV_FS_ENTRY        "AT-S.File:%31[^:]:%u"  /* "<name>:<size>" */               // "%*c %u %31s"
+#define SPWFXX_FS_ENTRY_SIZE_FIRST  (0)                                                         // (1)
+#define SPWFXX_SEND_HTTP_GET_FILE   "AT+S.HTTPGET=%s,%s,%d,%d,,,,%s" /* ...,<out file> */       // n.a.
+
+/* ping (see `SPWFSAxx::ping()`) */
+#define SPWFXX_SEND_PING            "AT+S.PING=%d,%d,%s"    /* <count>,<size>,<host> */         // "AT+S.PING=%d,%d,%s"
+#define SPWFXX_RECV_PING_REPLY      "AT-S.Reply:"       /* "<seq>:<ip>:<ms>" */                 // "Ping reply "
+#define SPWFXX_PING_REPLY_SEP       ':'                                                         // ' '
+#define SPWFXX_PING_REPLY_FIELDS    (3)                                                         // (6)
+#define SPWFXX_PING_REPLY_TIME      (2)                                                         // (4)
+
+/* socket server (not available on SPWFSA01) */
+#define SPWFXX_SEND_SOCKD_ON        "AT+S.SOCKDON="                                         // n.a.
+#define SPWFXX_SEND_SOCKD_OFF       "AT+S.SOCKDOFF="                                        // n.a.
+#define SPWFXX_SEND_SOCKD_DISC      "AT+S.SOCKDOFF="    /* <sid>,<cid>: one client only */  // n.a.
+#define SPWFXX_SEND_SOCKD_W         "AT+S.SOCKDW="                                          // n.a.
+#define SPWFXX_SEND_SOCKD_R         "AT+S.SOCKDR="                                          // n.a.
+#define SPWFXX_SEND_SOCKD_Q         "AT+S.SOCKDQ="                                          // n.a.
+
+#define SPWFXX_SOCKD_CLIENT_FIELDS  (4)     /* ":<ip>:<sid>:<cid>" */                       // n.a.
+#define SPWFXX_SOCKD_CLIENT_IP      (1)                                                     // n.a.
+#define SPWFXX_SOCKD_CLIENT_SID     (2)                                                     // n.a.
+#define SPWFXX_SOCKD_CLIENT_CID     (3)                                                     // n.a.
+#define SPWFXX_SOCKD_DATA_FIELDS    (5)     /* ":<sid>:<cid>:<amount>:<cumulative>" */      // n.a.
+#define SPWFXX_SOCKD_DATA_SID       (1)                                                     // n.a.
+#define SPWFXX_SOCKD_DATA_CID       (2)                                                     // n.a.
+
+/* WebSocket client (not available on SPWFSA01) */
+#define SPWFXX_SEND_WSOCK_ON        "AT+S.WSOCKON="     /* <host>,<port>,<path>,<tls> */    // n.a.
+#define SPWFXX_SEND_WSOCK_OFF       "AT+S.WSOCKC="                                          // n.a.
+#define SPWFXX_SEND_WSOCK_W         "AT+S.WSOCKW="                                          // n.a.
+#define SPWFXX_SEND_WSOCK_R         "AT+S.WSOCKR="                                          // n.a.
+
+#define SPWFXX_WSOCK_DATA_FIELDS    (5)     /* ":<id>:<last frame>:<length>:<cumulative>" */// n.a.
+#define SPWFXX_WSOCK_DATA_ID        (1)                                                     // n.a.
+#define SPWFXX_WSOCK_DATA_LAST      (2)                                                     // n.a.
+#define SPWFXX_WSOCK_DATA_LEN       (3)                                                     // n.a.
+#define SPWFXX_WSOCK_CLOSED_FIELDS  (2)     /* ":<id>" */                                   // n.a.
+#define SPWFXX_WSOCK_CLOSED_ID      (1)                                                     // n.a.
+
+/* MQTT client (not available on SPWFSA01) */
+#define SPWFXX_SEND_MQTT_CONN       "AT+S.MQTTCONN="    /* <host>,<port>,<tls>,<user>,<pwd>,<client id>,<keepalive> */ // n.a.
+#define SPWFXX_SEND_MQTT_DISC       "AT+S.MQTTDISC="                                        // n.a.
+#define SPWFXX_SEND_MQTT_PUB        "AT+S.MQTTPUB="     /* <id>,<topic>,<qos>,<retain>,<len> */ // n.a.
+#define SPWFXX_SEND_MQTT_SUB        "AT+S.MQTTSUB="     /* <id>,<topic>,<qos> */            // n.a.
+#define SPWFXX_SEND_MQTT_UNSUB      "AT+S.MQTTUNSUB="   /* <id>,<topic> */                  // n.a.
+#define SPWFXX_SEND_MQTT_PING       "AT+S.MQTTPING="                                        // n.a.
+/* "+WIND:93" arguments ":<id>:<topic>:<length>" are followed by <length> payload bytes */  // n.a.
+#define SPWFXX_MQTT_CLOSED_FIELDS   (2)     /* ":<id>" */                                   // n.a.
+#define SPWFXX_MQTT_CLOSED_ID       (1)                                                     // n.a.
 
 #define SPWFXX_SEND_FWCFG           "AT+S.FCFG"                                             // "AT&F"
 #define SPWFXX_SEND_DISABLE_LE      "AT+S.SCFG=console_echo,0"                              // "AT+S.SCFG=localecho1,0"
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <ctype.h>
 #include "mbed_debug.h"
 
 #include "SpwfSAInterface.h" /* must be included first */
@@ -25,35 +26,39 @@ SPWFSAxx::SPWFSAxx(PinName tx, PinName rx,
                    PinName rts, PinName cts,
                    SpwfSAInterface &ifce, bool debug,
                    PinName wakeup, PinName reset)
-: _serial(tx, rx, SPWFXX_DEFAULT_BAUD_RATE), _parser(&_serial, out_delim),
+: _serial(tx, rx, SPWFXX_DEFAULT_BAUD_RATE),
+#if defined(SPWFSAXX_TRACE)
+  _trace(&_serial), _parser(&_trace, out_delim),
+#else
+  _parser(&_serial, out_delim),
+#endif
   _wakeup(wakeup, 1), _reset(reset, 1),
   _rts(rts), _cts(cts),
   _timeout(SPWF_INIT_TIMEOUT), _dbg_on(debug),
   _pending_sockets_bitmap(0),
   _network_lost_flag(false),
   _associated_interface(ifce),
+  _connect_trials(0),
   _call_event_callback_blocked(0),
   _callback_func(),
-  _packets(0), _packets_end(&_packets)
+  _packets(0), _packets_end(&_packets),
+  _wind_queue_first(0), _wind_queue_cnt(0), _wind_waiting(false),
+  _fw_date(0), _fw_features(0)
 {
-    memset(_pending_pkt_sizes, 0, sizeof(_pending_pkt_sizes));
+    _fw_version[0] = '\0';
+    memset(_rx_buffered, 0, sizeof(_rx_buffered));
+    memset(&_stats, 0, sizeof(_stats));
+#if defined(SPWFSAXX_CMD_STATS)
+    reset_cmd_stats();
+#endif
 
     _serial.sigio(Callback<void()>(this, &SPWFSAxx::_event_handler));
     _parser.debug_on(debug);
     _parser.set_timeout(_timeout);
 
-    /* unlikely OOBs */
-    _parser.oob("+WIND:5:WiFi Hardware Failure", callback(this, &SPWFSAxx::_wifi_hwfault_handler));
-    _parser.oob("+WIND:33:WiFi Network Lost", callback(this, &SPWFSAxx::_network_lost_handler_th));
-#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
-    _parser.oob("+WIND:24:WiFi Up::", callback(this, &SPWFSAxx::_skip_oob));
-#endif
-    _parser.oob("+WIND:8:Hard Fault", callback(this, &SPWFSAxx::_hard_fault_handler));
-
-    /* most likely OOBs */
+    /* OOBs (all WINDs get dispatched by `_wind_handler()`) */
     _parser.oob(SPWFXX_OOB_ERROR, callback(this, &SPWFSAxx::_error_handler));
-    _parser.oob("+WIND:58:Socket Closed", callback(this, &SPWFSAxx::_server_gone_handler));
-    _parser.oob("+WIND:55:Pending Data", callback(this, &SPWFSAxx::_packet_handler_th));
+    _parser.oob(SPWFXX_OOB_WIND, callback(this, &SPWFSAxx::_wind_handler));
 }
 
 bool SPWFSAxx::startup(int mode)
@@ -67,43 +72,48 @@ bool SPWFSAxx::startup(int mode)
         return false;
     }
 
+    /* identify module & firmware (fails fast on a wrong `idw0xx1.expansion-board` setting) */
+    if(!_probe_firmware()) {
+        return false;
+    }
+
     /* factory reset */
-    if(!(_parser.send(SPWFXX_SEND_FWCFG) && _recv_ok()))
+    if(!(_send_cmd(SPWFXX_SEND_FWCFG) && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error restore factory default settings\r\n");
         return false;
     }
 
     /*switch off led*/
-    if(!(_parser.send("AT+S.SCFG=blink_led,0") && _recv_ok()))
+    if(!(_send_cmd("AT+S.SCFG=blink_led,0") && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error stop blinking led (%d)\r\n", __LINE__);
         return false;
     }
 
     /*set local echo to 0*/
-    if(!(_parser.send(SPWFXX_SEND_DISABLE_LE) && _recv_ok()))
+    if(!(_send_cmd(SPWFXX_SEND_DISABLE_LE) && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error local echo set\r\n");
         return false;
     }
 
     /*set the operational rates*/
-    if(!(_parser.send("AT+S.SCFG=wifi_opr_rate_mask,0x003FFFCF") && _recv_ok()))
+    if(!(_send_cmd("AT+S.SCFG=wifi_opr_rate_mask,0x003FFFCF") && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error setting ht_mode\r\n");
         return false;
     }
 
     /*enable the 802.11n mode*/
-    if(!(_parser.send("AT+S.SCFG=wifi_ht_mode,1") && _recv_ok()))
+    if(!(_send_cmd("AT+S.SCFG=wifi_ht_mode,1") && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error setting operational rates\r\n");
         return false;
     }
 
     /*set idle mode (0->idle, 1->STA,3->miniAP, 2->IBSS)*/
-    if(!(_parser.send("AT+S.SCFG=wifi_mode,%d", mode) && _recv_ok()))
+    if(!(_send_cmd("AT+S.SCFG=wifi_mode,%d", mode) && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error WiFi mode set idle (%d)\r\n", __LINE__);
         return false;
@@ -112,7 +122,7 @@ bool SPWFSAxx::startup(int mode)
 #if defined(MBED_MAJOR_VERSION)
 #if !DEVICE_SERIAL_FC || (MBED_VERSION < MBED_ENCODE_VERSION(5, 7, 0))
     /*disable HW flow control*/
-    if(!(_parser.send(SPWFXX_SEND_DISABLE_FC) && _recv_ok()))
+    if(!(_send_cmd(SPWFXX_SEND_DISABLE_FC) && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error disabling HW flow control\r\n");
         return false;
@@ -120,7 +130,7 @@ bool SPWFSAxx::startup(int mode)
 #else // DEVICE_SERIAL_FC && (MBED_VERSION >= MBED_ENCODE_VERSION(5, 7, 0))
     if((_rts != NC) && (_cts != NC)) {
         /*enable HW flow control*/
-        if(!(_parser.send(SPWFXX_SEND_ENABLE_FC) && _recv_ok()))
+        if(!(_send_cmd(SPWFXX_SEND_ENABLE_FC) && _recv_ok()))
         {
             debug_if(_dbg_on, "\r\nSPWF> error enabling HW flow control\r\n");
             return false;
@@ -130,7 +140,7 @@ bool SPWFSAxx::startup(int mode)
         _serial.set_flow_control(SerialBase::RTSCTS, _rts, _cts);
     } else {
         /*disable HW flow control*/
-        if(!(_parser.send(SPWFXX_SEND_DISABLE_FC) && _recv_ok()))
+        if(!(_send_cmd(SPWFXX_SEND_DISABLE_FC) && _recv_ok()))
         {
             debug_if(_dbg_on, "\r\nSPWF> error disabling HW flow control\r\n");
             return false;
@@ -140,7 +150,7 @@ bool SPWFSAxx::startup(int mode)
 #else // !defined(MBED_MAJOR_VERSION) - Assuming `master` branch
 #if !DEVICE_SERIAL_FC
     /*disable HW flow control*/
-    if(!(_parser.send(SPWFXX_SEND_DISABLE_FC) && _recv_ok()))
+    if(!(_send_cmd(SPWFXX_SEND_DISABLE_FC) && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error disabling HW flow control\r\n");
         return false;
@@ -148,7 +158,7 @@ bool SPWFSAxx::startup(int mode)
 #else // DEVICE_SERIAL_FC
     if((_rts != NC) && (_cts != NC)) {
         /*enable HW flow control*/
-        if(!(_parser.send(SPWFXX_SEND_ENABLE_FC) && _recv_ok()))
+        if(!(_send_cmd(SPWFXX_SEND_ENABLE_FC) && _recv_ok()))
         {
             debug_if(_dbg_on, "\r\nSPWF> error enabling HW flow control\r\n");
             return false;
@@ -158,7 +168,7 @@ bool SPWFSAxx::startup(int mode)
         _serial.set_flow_control(SerialBase::RTSCTS, _rts, _cts);
     } else {
         /*disable HW flow control*/
-        if(!(_parser.send(SPWFXX_SEND_DISABLE_FC) && _recv_ok()))
+        if(!(_send_cmd(SPWFXX_SEND_DISABLE_FC) && _recv_ok()))
         {
             debug_if(_dbg_on, "\r\nSPWF> error disabling HW flow control\r\n");
             return false;
@@ -177,54 +187,52 @@ bool SPWFSAxx::startup(int mode)
     }
 
 #ifndef NDEBUG
-    if (!(_parser.send(SPWFXX_SEND_GET_CONS_STATE)
+    if (!(_send_cmd(SPWFXX_SEND_GET_CONS_STATE)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> error getting console state\r\n");
         return false;
     }
 
-    if (!(_parser.send(SPWFXX_SEND_GET_CONS_SPEED)
+    if (!(_send_cmd(SPWFXX_SEND_GET_CONS_SPEED)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> error getting console speed\r\n");
         return false;
     }
 
-    if (!(_parser.send(SPWFXX_SEND_GET_HWFC_STATE)
+    if (!(_send_cmd(SPWFXX_SEND_GET_HWFC_STATE)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> error getting hwfc state\r\n");
         return false;
     }
 
-#if (MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1) || defined(IDW01M1_FW_REL_35X)
-    /* betzw: IDW01M1 FW versions <3.5 seem to have problems with the following two commands.
-     *        For the sake of simplicity, just excluding them for IDW01M1 in general.
-     */
-    if (!(_parser.send(SPWFXX_SEND_GET_CONS_DELIM)
-            && _recv_ok())) {
-        debug_if(_dbg_on, "\r\nSPWF> error getting console delimiter\r\n");
-        return false;
-    }
+    /* betzw: IDW01M1 FW versions <3.5 seem to have problems with the following two commands */
+    if(_fw_has(SPWFXX_FW_FEAT_CONS_QUERIES)) {
+        if (!(_send_cmd(SPWFXX_SEND_GET_CONS_DELIM)
+                && _recv_ok())) {
+            debug_if(_dbg_on, "\r\nSPWF> error getting console delimiter\r\n");
+            return false;
+        }
 
-    if (!(_parser.send(SPWFXX_SEND_GET_CONS_ERRS)
-            && _recv_ok())) {
-        debug_if(_dbg_on, "\r\nSPWF> error getting console error setting\r\n");
-        return false;
+        if (!(_send_cmd(SPWFXX_SEND_GET_CONS_ERRS)
+                && _recv_ok())) {
+            debug_if(_dbg_on, "\r\nSPWF> error getting console error setting\r\n");
+            return false;
+        }
     }
-#endif // (MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1) || defined(IDW01M1_FW_REL_35X)
 
-    if (!(_parser.send("AT+S.GCFG=sleep_enabled")
+    if (!(_send_cmd("AT+S.GCFG=sleep_enabled")
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> error getting sleep state enabled\r\n");
         return false;
     }
 
-    if (!(_parser.send("AT+S.GCFG=wifi_powersave")
+    if (!(_send_cmd("AT+S.GCFG=wifi_powersave")
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> error getting powersave mode\r\n");
         return false;
     }
 
-    if (!(_parser.send("AT+S.GCFG=standby_enabled")
+    if (!(_send_cmd("AT+S.GCFG=standby_enabled")
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> error getting standby state enabled\r\n");
         return false;
@@ -234,46 +242,132 @@ bool SPWFSAxx::startup(int mode)
     return true;
 }
 
-bool SPWFSAxx::_wait_console_active(void) {
-    int trials = 0;
+/* Query module identity & firmware version and derive the firmware feature set
+ *
+ * Note: returns `false` only if the module has been positively identified as not being the one
+ *       this driver has been built for, firmwares not supporting the query are handled as unknown
+ *       (i.e. with all workarounds enabled)
+ * Note: WINDs (e.g. the ones following a HW reset) received while waiting for the reply get
+ *       dispatched as usual and do not count as trials
+ */
+bool SPWFSAxx::_probe_firmware(void) {
+    char line[SPWFXX_WIND_LINE_SIZE];
+    char *fields[3];
+    char *version = NULL;
+    bool done = false;
+    uint32_t date;
+
+    _fw_version[0] = '\0';
+    _fw_date = 0;
+#if (MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1) || defined(IDW01M1_FW_REL_35X)
+    _fw_features = SPWFXX_FW_FEAT_CONS_QUERIES;
+#else
+    _fw_features = 0;
+#endif
 
-    while(true) {
-        if (_parser.recv("+WIND:0:Console active\n") && _recv_delim_lf()) {
-            debug_if(_dbg_on, "AT^ +WIND:0:Console active\r\n");
-            return true;
-        }
-        if(++trials >= SPWFXX_MAX_TRIALS) {
-            debug("\r\nSPWF> ERROR: Should never happen! (%s, %d)\r\n", __func__, __LINE__);
-            empty_rx_buffer();
-            return false;
+    /* Note: parsing both dialects' replies (i.e. "#  version = <v>" & "AT-S.Var:version=<v>") */
+    if(_send_cmd(SPWFXX_SEND_GET_VERSION)) {
+        for(int trials = 0; trials < SPWFXX_MAX_TRIALS; ) {
+            if(_recv_line(line, sizeof(line)) < 0) break;
+            if(line[0] == '\0') continue;
+
+            if(strncmp(line, SPWFXX_OOB_WIND, sizeof(SPWFXX_OOB_WIND) - 1) == 0) {
+                _wind_dispatch(line + sizeof(SPWFXX_OOB_WIND) - 1);
+                continue;
+            }
+
+            if((strncmp(line, SPWFXX_OOB_ERROR, sizeof(SPWFXX_OOB_ERROR) - 1) == 0) || _is_ok_line(line)) {
+                done = true; // reply complete (query not supported)
+                break;
+            }
+            trials++;
+
+            if(((version = strstr(line, "version")) != NULL) && ((version = strchr(version, '=')) != NULL)) {
+                for(version++; *version == ' '; version++);
+                break;
+            }
+            version = NULL;
         }
     }
+
+    if(version == NULL) {
+        debug_if(_dbg_on, "\r\nSPWF> unknown firmware version\r\n");
+        if(!done) empty_rx_buffer();
+        return true;
+    }
+
+    debug_if(_dbg_on, "AT^ version = %s\r\n", version);
+
+    if(strstr(version, SPWFXX_FW_PRODUCT) == NULL) {
+        debug("\r\nSPWF> ERROR: module (%s) does not match configured expansion board (%s)!\r\n",
+              version, SPWFXX_FW_PRODUCT);
+        empty_rx_buffer();
+        return false;
+    }
+
+    strncpy(_fw_version, version, sizeof(_fw_version) - 1);
+    _fw_version[sizeof(_fw_version) - 1] = '\0';
+
+    if(!_recv_ok()) {
+        debug_if(_dbg_on, "\r\nSPWF> error getting firmware version\r\n");
+        return true;
+    }
+
+    /* "<YYMMDD>-<commit>-<product>" */
+    if((_split_fields(version, '-', fields, 3) == 3) && _parse_uint(fields[0], &date)) {
+        _fw_date = date;
+    }
+
+#if !defined(SPWFSAXX_FW_WORKAROUNDS)
+    if(_fw_date >= SPWFXX_FW_DATE_TESTED) {
+        _fw_features |= SPWFXX_FW_FEAT_CONS_QUERIES;
+    }
+
+#if defined(SPWFSAXX_FW_DATE_WINDS_OK)
+    /* Note: no firmware release is known to indicate pending data reliably (the `SOCKQ` fallback
+     *       has been in place unconditionally for the tested versions), so the threshold has no default */
+    if(_fw_date >= SPWFSAXX_FW_DATE_WINDS_OK) {
+        _fw_features |= SPWFXX_FW_FEAT_WINDS_OK;
+    }
+#endif // defined(SPWFSAXX_FW_DATE_WINDS_OK)
+#endif // !defined(SPWFSAXX_FW_WORKAROUNDS)
+
+    debug_if(_dbg_on, "\r\nSPWF> firmware %lu, features 0x%lx\r\n", (unsigned long)_fw_date, (unsigned long)_fw_features);
+    return true;
 }
 
-bool SPWFSAxx::_wait_wifi_hw_started(void) {
-    int trials = 0;
+bool SPWFSAxx::_wait_console_active(void) {
+    if(_wait_wind(SPWFXX_WIND_CONSOLE_ACTIVE)) {
+        debug_if(_dbg_on, "AT^ +WIND:0:Console active\r\n");
+        return true;
+    }
 
-    while(true) {
-        if (_parser.recv("+WIND:32:WiFi Hardware Started\n") && _recv_delim_lf()) {
-            debug_if(_dbg_on, "AT^ +WIND:32:WiFi Hardware Started\r\n");
-            return true;
-        }
-        if(++trials >= SPWFXX_MAX_TRIALS) {
-            debug("\r\nSPWF> ERROR: Should never happen! (%s, %d)\r\n", __func__, __LINE__);
-            empty_rx_buffer();
-            return false;
-        }
+    debug("\r\nSPWF> ERROR: Should never happen! (%s, %d)\r\n", __func__, __LINE__);
+    empty_rx_buffer();
+    return false;
+}
+
+bool SPWFSAxx::_wait_wifi_hw_started(void) {
+    if(_wait_wind(SPWFXX_WIND_HW_STARTED)) {
+        debug_if(_dbg_on, "AT^ +WIND:32:WiFi Hardware Started\r\n");
+        return true;
     }
+
+    debug("\r\nSPWF> ERROR: Should never happen! (%s, %d)\r\n", __func__, __LINE__);
+    empty_rx_buffer();
+    return false;
 }
 
 bool SPWFSAxx::hw_reset(void)
 {
+    _flush_winds();
+
 #if (MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1) || !defined(IDW04A1_WIFI_HW_BUG_WA) // betzw: HW reset doesn't work as expected on unmodified X_NUCLEO_IDW04A1 expansion boards
     _reset.write(0);
     wait_ms(200);
     _reset.write(1); 
 #else // (MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1) && defined(IDW04A1_WIFI_HW_BUG_WA): substitute with SW reset
-    _parser.send(SPWFXX_SEND_SW_RESET);
+    _send_cmd(SPWFXX_SEND_SW_RESET);
 #endif // (MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1) && defined(IDW04A1_WIFI_HW_BUG_WA)
     return _wait_console_active();
 }
@@ -283,17 +377,18 @@ bool SPWFSAxx::reset(void)
     bool ret;
 
     /* save current setting in flash */
-    if(!(_parser.send(SPWFXX_SEND_SAVE_SETTINGS) && _recv_ok()))
+    if(!(_send_cmd(SPWFXX_SEND_SAVE_SETTINGS) && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error saving configuration to flash (%s, %d)\r\n", __func__, __LINE__);
         return false;
     }
 
-    if(!_parser.send(SPWFXX_SEND_SW_RESET)) return false; /* betzw - NOTE: "keep the current state and reset the device".
-                                                                     We assume that the module informs us about the
-                                                                     eventual closing of sockets via "WIND" asynchronous
-                                                                     indications! So everything regarding the clean-up
-                                                                     of these situations is handled there. */
+    _flush_winds();
+    if(!_send_cmd(SPWFXX_SEND_SW_RESET)) return false; /* betzw - NOTE: "keep the current state and reset the device".
+                                                                  We assume that the module informs us about the
+                                                                  eventual closing of sockets via "WIND" asynchronous
+                                                                  indications! So everything regarding the clean-up
+                                                                  of these situations is handled there. */
 
     /* waiting for HW to start */
     ret = _wait_wifi_hw_started();
@@ -308,34 +403,55 @@ bool SPWFSAxx::reset(void)
  */
 bool SPWFSAxx::connect(const char *ap, const char *passPhrase, int securityMode)
 {
-    int trials;
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    if(!connect_start(ap, passPhrase, securityMode)) {
+        return false;
+    }
+
+    while(true) {
+        switch(_connect_step()) {
+            case SPWFSA_CONNECT_DHCP_BOUND:
+                return true;
+            case SPWFSA_CONNECT_FAILED:
+                return false;
+            default:
+                continue;
+        }
+    }
+}
 
+bool SPWFSAxx::connect_start(const char *ap, const char *passPhrase, int securityMode)
+{
     BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
                                  Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
 
+    _connect_trials = 0;
+
     //AT+S.SCFG=wifi_wpa_psk_text,%s
-    if(!(_parser.send("AT+S.SCFG=wifi_wpa_psk_text,%s", passPhrase) && _recv_ok()))
+    if(!(_send_cmd("AT+S.SCFG=wifi_wpa_psk_text,%s", passPhrase) && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error pass set\r\n");
         return false;
     } 
 
     //AT+S.SSIDTXT=%s
-    if(!(_parser.send("AT+S.SSIDTXT=%s", ap) && _recv_ok()))
+    if(!(_send_cmd("AT+S.SSIDTXT=%s", ap) && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error ssid set\r\n");
         return false;
     }
 
     //AT+S.SCFG=wifi_priv_mode,%d
-    if(!(_parser.send("AT+S.SCFG=wifi_priv_mode,%d", securityMode) && _recv_ok()))
+    if(!(_send_cmd("AT+S.SCFG=wifi_priv_mode,%d", securityMode) && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error security mode set\r\n");
         return false;
     }
 
     /*set STA mode (0->idle, 1->STA,3->miniAP, 2->IBSS)*/
-    if(!(_parser.send("AT+S.SCFG=wifi_mode,1") && _recv_ok()))
+    if(!(_send_cmd("AT+S.SCFG=wifi_mode,1") && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error WiFi mode set 1 (STA)\r\n");
         return false;
@@ -347,39 +463,64 @@ bool SPWFSAxx::connect(const char *ap, const char *passPhrase, int securityMode)
         return false;
     }
 
-    trials = 0;
-    while(true) {
-        if(_parser.recv("%255[^\n]\n", _msg_buffer) && _recv_delim_lf())
-        {
-            if(strstr(_msg_buffer, ":24:") != NULL) { // WiFi Up
-                debug_if(_dbg_on, "AT^ %s\n", _msg_buffer);
+    return true;
+}
+
+spwf_connect_progress_t SPWFSAxx::connect_progress(void)
+{
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    /* dispatch what has been received so far, WINDs of interest get queued */
+    while((_wind_queue_cnt == 0) && readable()) {
+        _parser.process_oob();
+    }
+
+    /* Note: not having received a (queued) WIND yet does not count as a failed trial */
+    if(_wind_queue_cnt == 0) {
+        return SPWFSA_CONNECT_IN_PROGRESS;
+    }
+
+    return _connect_step();
+}
+
+/* Note: in case of failure module has already been cleaned up */
+spwf_connect_progress_t SPWFSAxx::_connect_step(void)
+{
+    int wind_id;
+
+    if(_recv_wind(&wind_id, _msg_buffer, sizeof(_msg_buffer), _timeout))
+    {
+        switch(wind_id) {
+            case SPWFXX_WIND_WIFI_UP:
+                debug_if(_dbg_on, "AT^ +WIND:%d:%s\n", wind_id, _msg_buffer);
                 if(strchr(_msg_buffer, '.') != NULL) { // IPv4 address
-                    break;
+                    return SPWFSA_CONNECT_DHCP_BOUND;
                 } else {
-                    continue;
+                    return SPWFSA_CONNECT_IN_PROGRESS;
                 }
-            }
-            if(strstr(_msg_buffer, ":40:") != NULL) { // Deauthentication
-                debug_if(_dbg_on, "AT~ %s\n", _msg_buffer);
-                if(++trials < SPWFXX_MAX_TRIALS) { // give it three trials
-                    continue;
+            case SPWFXX_WIND_WIFI_JOIN:
+                debug_if(_dbg_on, "AT^ +WIND:%d:%s\n", wind_id, _msg_buffer);
+                return SPWFSA_CONNECT_ASSOCIATED;
+            case SPWFXX_WIND_DEAUTH:
+                debug_if(_dbg_on, "AT~ +WIND:%d:%s\n", wind_id, _msg_buffer);
+                if(++_connect_trials < SPWFXX_MAX_TRIALS) { // give it three trials
+                    return SPWFSA_CONNECT_DEAUTH_RETRY;
                 }
                 disconnect();
                 empty_rx_buffer();
-                return false;
-            } else {
-                debug_if(_dbg_on, "AT] %s\n", _msg_buffer);
-            }
-            continue;
-        }
-        if(++trials >= SPWFXX_MAX_TRIALS) {
-            debug("\r\nSPWF> ERROR: Should never happen! (%s, %d)\r\n", __func__, __LINE__);
-            empty_rx_buffer();
-            return false;
+                return SPWFSA_CONNECT_FAILED;
+            default:
+                debug_if(_dbg_on, "AT] +WIND:%d:%s\n", wind_id, _msg_buffer);
+                return SPWFSA_CONNECT_IN_PROGRESS;
         }
     }
-
-    return true;
+    if(++_connect_trials >= SPWFXX_MAX_TRIALS) {
+        debug("\r\nSPWF> ERROR: Should never happen! (%s, %d)\r\n", __func__, __LINE__);
+        empty_rx_buffer();
+        return SPWFSA_CONNECT_FAILED;
+    }
+    return SPWFSA_CONNECT_IN_PROGRESS;
 }
 
 bool SPWFSAxx::disconnect(void)
@@ -387,9 +528,22 @@ bool SPWFSAxx::disconnect(void)
     BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
                                  Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
 
+    if(!_leave_network()) {
+        return false;
+    }
+
+    /* clean up state */
+    _associated_interface.inner_constructor();
+    _free_all_packets();
+
+    return true;
+}
+
+bool SPWFSAxx::_leave_network(void)
+{
 #if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
     /*disable Wi-Fi device*/
-    if(!(_parser.send("AT+S.WIFI=0") && _recv_ok()))
+    if(!(_send_cmd("AT+S.WIFI=0") && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error disabling WiFi\r\n");
         return false;
@@ -397,7 +551,7 @@ bool SPWFSAxx::disconnect(void)
 #endif // IDW04A1
 
     /*set idle mode (0->idle, 1->STA,3->miniAP, 2->IBSS)*/
-    if(!(_parser.send("AT+S.SCFG=wifi_mode,0") && _recv_ok()))
+    if(!(_send_cmd("AT+S.SCFG=wifi_mode,0") && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error WiFi mode set idle (%d)\r\n", __LINE__);
         return false;
@@ -405,7 +559,7 @@ bool SPWFSAxx::disconnect(void)
 
 #if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
     /*enable Wi-Fi device*/
-    if(!(_parser.send("AT+S.WIFI=1") && _recv_ok()))
+    if(!(_send_cmd("AT+S.WIFI=1") && _recv_ok()))
     {
         debug_if(_dbg_on, "\r\nSPWF> error enabling WiFi\r\n");
         return false;
@@ -418,10 +572,6 @@ bool SPWFSAxx::disconnect(void)
         return false;
     }
 
-    /* clean up state */
-    _associated_interface.inner_constructor();
-    _free_all_packets();
-
     return true;
 }
 
@@ -432,7 +582,7 @@ const char *SPWFSAxx::getIPAddress(void)
     BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
                                  Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
 
-    if (!(_parser.send("AT+S.STS=ip_ipaddr")
+    if (!(_send_cmd("AT+S.STS=ip_ipaddr")
             && _parser.recv(SPWFXX_RECV_IP_ADDR, &n1, &n2, &n3, &n4)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> get IP address error\r\n");
@@ -452,7 +602,7 @@ const char *SPWFSAxx::getGateway(void)
     BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
                                  Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
 
-    if (!(_parser.send("AT+S.STS=ip_gw")
+    if (!(_send_cmd("AT+S.STS=ip_gw")
             && _parser.recv(SPWFXX_RECV_GATEWAY, &n1, &n2, &n3, &n4)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> get gateway error\r\n");
@@ -472,7 +622,7 @@ const char *SPWFSAxx::getNetmask(void)
     BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
                                  Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
 
-    if (!(_parser.send("AT+S.STS=ip_netmask")
+    if (!(_send_cmd("AT+S.STS=ip_netmask")
             && _parser.recv(SPWFXX_RECV_NETMASK, &n1, &n2, &n3, &n4)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> get netmask error\r\n");
@@ -492,7 +642,7 @@ int8_t SPWFSAxx::getRssi(void)
     BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
                                  Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
 
-    if (!(_parser.send("AT+S.PEERS=0,rx_rssi")
+    if (!(_send_cmd("AT+S.PEERS=0,rx_rssi")
             && _parser.recv(SPWFXX_RECV_RX_RSSI, &ret)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> get RX rssi error\r\n");
@@ -509,7 +659,7 @@ const char *SPWFSAxx::getMACAddress(void)
     BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
                                  Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
 
-    if (!(_parser.send("AT+S.GCFG=nv_wifi_macaddr")
+    if (!(_send_cmd("AT+S.GCFG=nv_wifi_macaddr")
             && _parser.recv(SPWFXX_RECV_MAC_ADDR, &n1, &n2, &n3, &n4, &n5, &n6)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> get MAC address error\r\n");
@@ -545,10 +695,11 @@ nsapi_size_or_error_t SPWFSAxx::send(int spwf_id, const void *data, uint32_t amo
             BlockExecuter bh_handler(Callback<void()>(this, &SPWFSAxx::_execute_bottom_halves));
 
             // betzw - TODO: handle different errors more accurately!
-            if (!_associated_interface._socket_is_still_connected(internal_id)) {
+            if (!_associated_interface._socket_is_still_connected(internal_id)
+                    || (_associated_interface.get_internal_id(spwf_id) != internal_id)) { // socket might have been re-opened after module hard fault
                 debug_if(_dbg_on, "\r\nSPWF> Socket not connected anymore: sent=%u, to_send=%u! (%s, %d)\r\n", sent, to_send, __func__, __LINE__);
                 break;
-            } else if(!_parser.send("AT+S.SOCKW=%d,%d", spwf_id, (unsigned int)to_send)) {
+            } else if(!_send_cmd(SpwfCmd(SPWFXX_SEND_SOCKW).arg(spwf_id).arg(to_send))) {
                 debug_if(_dbg_on, "\r\nSPWF> Sending command failed: sent=%u, to_send=%u! (%s, %d)\r\n", sent, to_send, __func__, __LINE__);
                 break;
             } else if(_parser.write(((char*)data)+sent, (int)to_send) != (int)to_send) {
@@ -560,6 +711,8 @@ nsapi_size_or_error_t SPWFSAxx::send(int spwf_id, const void *data, uint32_t amo
             }
         }
 
+        _socket_stat_add(spwf_id, &spwf_socket_stats_t::tx_chunks, 1);
+        _socket_stat_add(spwf_id, &spwf_socket_stats_t::tx_bytes, to_send);
         sent += to_send;
     }
 
@@ -576,11 +729,109 @@ nsapi_size_or_error_t SPWFSAxx::send(int spwf_id, const void *data, uint32_t amo
     return ret;
 }
 
-int SPWFSAxx::_read_len(int spwf_id) {
-    unsigned int amount;
+bool SPWFSAxx::_send_cmd(SpwfCmd &cmd)
+{
+    size_t len = cmd.length() + 1; // incl. delimiter
+    const char *command = cmd.terminate(_cr_);
+
+#if defined(SPWFSAXX_TRACE)
+    FileHandle &fh = _trace;
+#else
+    FileHandle &fh = _serial;
+#endif
+
+#if defined(SPWFSAXX_CMD_STATS)
+    _cmd_stats_start(command);
+#endif
+    /* write whole command at once (instead of character by character like `ATCmdParser`) */
+    if(fh.write(command, len) != (ssize_t)len) return false;
+
+    debug_if(_dbg_on, "AT> %.*s\n", (int)(len - 1), command);
+    return true;
+}
+
+/* Split `line` in place into at most `max_fields` fields separated by `sep`
+ *
+ * @return number of fields found (might be greater than `max_fields`)
+ */
+int SPWFSAxx::_split_fields(char *line, char sep, char *fields[], int max_fields)
+{
+    int cnt = 0;
+
+    while(true) {
+        if(cnt < max_fields) fields[cnt] = line;
+        cnt++;
+
+        line = strchr(line, sep);
+        if(line == NULL) break;
+        *line++ = '\0';
+    }
+
+    return cnt;
+}
+
+/* Parse decimal (non empty) field */
+bool SPWFSAxx::_parse_uint(const char *str, uint32_t *value)
+{
+    uint32_t ret = 0;
+
+    if(*str == '\0') return false;
+
+    for(; *str != '\0'; str++) {
+        if((*str < '0') || (*str > '9')) return false;
+        ret = (ret * 10) + (*str - '0');
+    }
+
+    *value = ret;
+    return true;
+}
+
+/* Parse dotted quad IPv4 address */
+bool SPWFSAxx::_parse_ipv4(const char *str, unsigned int n[4])
+{
+    for(int i = 0; i < 4; i++) {
+        unsigned int value = 0;
+        const char *start = str;
+
+        for(; (*str >= '0') && (*str <= '9'); str++) {
+            value = (value * 10) + (*str - '0');
+        }
+        if((str == start) || (value > 255)) return false;
+        if(*str != ((i < 3) ? '.' : '\0')) return false;
+        if(i < 3) str++;
 
-    if (!(_parser.send("AT+S.SOCKQ=%d", spwf_id)
-            && _parser.recv(SPWFXX_RECV_DATALEN, &amount)
+        n[i] = value;
+    }
+
+    return true;
+}
+
+/* Note: returns line length (w/o "\r\n") or `-1` on timeout, overlong lines get truncated */
+int SPWFSAxx::_recv_line(char *buf, int size) {
+    int len = 0;
+    int c;
+
+    MBED_ASSERT(size > 0);
+
+    while((c = _parser.getc()) != _lf_) {
+        if(c < 0) return -1;
+        if(c == _cr_) continue;
+        if(len < (size - 1)) buf[len++] = (char)c;
+    }
+    buf[len] = '\0';
+
+    return len;
+}
+
+int SPWFSAxx::_read_len(int spwf_id) {
+    char line[SPWFXX_LINE_BUF_SIZE];
+    uint32_t amount;
+
+    /* Note: blanks following the prefix are left unread (see `SPWFXX_RECV_DATALEN`) */
+    if (!(_send_cmd(SpwfCmd(SPWFXX_SEND_SOCKQ).arg(spwf_id))
+            && _parser.recv(SPWFXX_RECV_DATALEN)
+            && (_recv_line(line, sizeof(line)) >= 0)
+            && _parse_uint(line + strspn(line, " "), &amount)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> %s failed\r\n", __func__);
         return SPWFXX_ERR_LEN;
@@ -600,13 +851,13 @@ int SPWFSAxx::_read_len(int spwf_id) {
 void SPWFSAxx::_winds_on(void) {
     MBED_ASSERT(_is_event_callback_blocked());
 
-    if(!(_parser.send(SPWFXX_SEND_WIND_OFF_HIGH SPWFXX_WINDS_HIGH_ON) && _recv_ok())) {
+    if(!(_send_cmd(SPWFXX_SEND_WIND_OFF_HIGH SPWFXX_WINDS_HIGH_ON) && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> %s failed at line #%d\r\n", __func__, __LINE__);
     }
-    if(!(_parser.send(SPWFXX_SEND_WIND_OFF_MEDIUM SPWFXX_WINDS_MEDIUM_ON) && _recv_ok())) {
+    if(!(_send_cmd(SPWFXX_SEND_WIND_OFF_MEDIUM SPWFXX_WINDS_MEDIUM_ON) && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> %s failed at line #%d\r\n", __func__, __LINE__);
     }
-    if(!(_parser.send(SPWFXX_SEND_WIND_OFF_LOW SPWFXX_WINDS_LOW_ON) && _recv_ok())) {
+    if(!(_send_cmd(SPWFXX_SEND_WIND_OFF_LOW SPWFXX_WINDS_LOW_ON) && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> %s failed at line #%d\r\n", __func__, __LINE__);
     }
 }
@@ -617,7 +868,7 @@ void SPWFSAxx::_winds_on(void) {
 bool SPWFSAxx::_winds_off(void) {
     MBED_ASSERT(_is_event_callback_blocked());
 
-    if (!(_parser.send(SPWFXX_SEND_WIND_OFF_LOW SPWFXX_WINDS_OFF)
+    if (!(_send_cmd(SPWFXX_SEND_WIND_OFF_LOW SPWFXX_WINDS_OFF)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> %s failed at line #%d\r\n", __func__, __LINE__);
 #ifdef SPWFXX_SOWF // betzw: try to continue
@@ -626,7 +877,7 @@ bool SPWFSAxx::_winds_off(void) {
 #endif
     }
 
-    if (!(_parser.send(SPWFXX_SEND_WIND_OFF_MEDIUM SPWFXX_WINDS_OFF)
+    if (!(_send_cmd(SPWFXX_SEND_WIND_OFF_MEDIUM SPWFXX_WINDS_OFF)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> %s failed at line #%d\r\n", __func__, __LINE__);
 #ifdef SPWFXX_SOWF // betzw: try to continue
@@ -635,7 +886,7 @@ bool SPWFSAxx::_winds_off(void) {
 #endif
     }
 
-    if (!(_parser.send(SPWFXX_SEND_WIND_OFF_HIGH SPWFXX_WINDS_OFF)
+    if (!(_send_cmd(SPWFXX_SEND_WIND_OFF_HIGH SPWFXX_WINDS_OFF)
             && _recv_ok())) {
         debug_if(_dbg_on, "\r\nSPWF> %s failed at line #%d\r\n", __func__, __LINE__);
 #ifdef SPWFXX_SOWF // betzw: try to continue
@@ -652,30 +903,81 @@ void SPWFSAxx::_execute_bottom_halves(void) {
     _packet_handler_bh();
 }
 
+/* RX flow control: do not read in more data than fits into socket's RX quota
+ * (unless nothing at all is buffered for the socket) */
+bool SPWFSAxx::_is_rx_throttled(int spwf_id) {
+    int internal_id = _associated_interface.get_internal_id(spwf_id);
+    uint32_t quota = (internal_id != SPWFSA_SOCKET_COUNT) ? _associated_interface._ids[internal_id].rx_quota : SPWFSA_RX_QUOTA;
+    uint32_t next = _get_pending_pkt_size(spwf_id);
+
+    if(next == 0) next = SPWFXX_SEND_RECV_PKTSIZE; // size not (yet) known
+
+    return ((_rx_buffered[spwf_id] > 0) && ((_rx_buffered[spwf_id] + next) > quota));
+}
+
+/* Pending data of datagram sockets must be read in respecting the datagram boundaries */
+bool SPWFSAxx::_is_datagram_socket(int spwf_id) {
+    int internal_id = _associated_interface.get_internal_id(spwf_id);
+
+    return ((internal_id != SPWFSA_SOCKET_COUNT) && (_associated_interface._ids[internal_id].proto == NSAPI_UDP));
+}
+
+/* Account statistics counter both for socket & interface */
+void SPWFSAxx::_socket_stat_add(int spwf_id, uint32_t spwf_socket_stats_t::*counter, uint32_t value) {
+    int internal_id = _associated_interface.get_internal_id(spwf_id);
+
+    _stats.sockets.*counter += value;
+    if(internal_id != SPWFSA_SOCKET_COUNT) {
+        _associated_interface._ids[internal_id].stats.*counter += value;
+    }
+}
+
+/* Deficit round robin over all sockets with pending data,
+ * each visit credits a socket with `rx_weight` module packets */
 void SPWFSAxx::_read_in_pending(void) {
     static int internal_id_cnt = 0;
+    int idle_cnt = 0; // sockets visited without reading in data
 
-    while(_is_data_pending()) {
-        if(_associated_interface._socket_has_connected(internal_id_cnt)) {
-            int spwf_id = _associated_interface._ids[internal_id_cnt].spwf_id;
+    while(_is_data_pending() && (idle_cnt < SPWFSA_SOCKET_COUNT)) {
+        int internal_id = internal_id_cnt;
+        bool progress = false;
 
-            if(_is_data_pending(spwf_id)) {
-                int amount;
+        internal_id_cnt++;
+        internal_id_cnt %= SPWFSA_SOCKET_COUNT;
 
-                amount = _read_in_pkt(spwf_id, false);
-                if(amount == SPWFXX_ERR_OOM) { /* consider only 'SPWFXX_ERR_OOM' as non recoverable */
-                    return;
+        if(_associated_interface._socket_has_connected(internal_id)) {
+            SpwfSAInterface::spwf_socket_t &sock = _associated_interface._ids[internal_id];
+            int spwf_id = sock.spwf_id;
+
+            if(_is_data_pending(spwf_id) && !_is_rx_throttled(spwf_id)) {
+                sock.rx_deficit += sock.rx_weight * SPWFXX_SEND_RECV_PKTSIZE;
+
+                while(_associated_interface._socket_has_connected(internal_id)
+                        && _is_data_pending(spwf_id) && !_is_rx_throttled(spwf_id)) {
+                    uint32_t next = _get_pending_pkt_size(spwf_id);
+                    int amount;
+
+                    if(next == 0) next = SPWFXX_SEND_RECV_PKTSIZE; // size not (yet) known
+                    if(next > sock.rx_deficit) break;
+
+                    amount = _read_in_pkt(spwf_id, false);
+                    if(amount == SPWFXX_ERR_OOM) { /* consider only 'SPWFXX_ERR_OOM' as non recoverable */
+                        return;
+                    }
+                    if(amount <= 0) break;
+
+                    sock.rx_deficit = (((uint32_t)amount) < sock.rx_deficit) ? (sock.rx_deficit - amount) : 0;
+                    progress = true;
                 }
             }
 
-            if(!_is_data_pending(spwf_id)) {
-                internal_id_cnt++;
-                internal_id_cnt %= SPWFSA_SOCKET_COUNT;
+            if(!_is_data_pending(spwf_id) || _is_rx_throttled(spwf_id)) {
+                sock.rx_deficit = 0;
             }
-        } else {
-            internal_id_cnt++;
-            internal_id_cnt %= SPWFSA_SOCKET_COUNT;
         }
+
+        if(progress) idle_cnt = 0;
+        else idle_cnt++;
     }
 }
 
@@ -687,13 +989,9 @@ void SPWFSAxx::_read_in_pending(void) {
 int SPWFSAxx::_read_in_packet(int spwf_id, uint32_t amount) {
     struct packet *packet = (struct packet*)malloc(sizeof(struct packet) + amount);
     if (!packet) {
-#ifndef NDEBUG
-        error("\r\nSPWF> %s(%d): Out of memory!\r\n", __func__, __LINE__);
-#else // NDEBUG
-        debug("\r\nSPWF> %s(%d): Out of memory!\r\n", __func__, __LINE__);
-#endif
-        debug_if(_dbg_on, "\r\nSPWF> %s failed (%d)\r\n", __func__, __LINE__);
-        return SPWFXX_ERR_OOM; /* out of memory: give up here! */
+        debug_if(_dbg_on, "\r\nSPWF> %s(%d): Out of memory!\r\n", __func__, __LINE__);
+        _socket_stat_add(spwf_id, &spwf_socket_stats_t::oom_events, 1);
+        return SPWFXX_ERR_OOM; /* out of memory: leave data on module */
     }
 
     /* init packet */
@@ -712,6 +1010,13 @@ int SPWFSAxx::_read_in_packet(int spwf_id, uint32_t amount) {
         /* append to packet list */
         *_packets_end = packet;
         _packets_end = &packet->next;
+        _rx_buffered[spwf_id] += amount;
+        SPWFSAXX_TRACE_EVENT(SPWF_TRACE_PKT_QUEUED, spwf_id, amount);
+
+        _socket_stat_add(spwf_id, &spwf_socket_stats_t::rx_chunks, 1);
+        _socket_stat_add(spwf_id, &spwf_socket_stats_t::rx_bytes, amount);
+
+        _rx_signal(spwf_id);
 
         /* force call of (external) callback */
         _call_callback();
@@ -734,6 +1039,16 @@ void SPWFSAxx::_free_packets(int spwf_id) {
             p = &(*p)->next;
         }
     }
+
+    _rx_buffered[spwf_id] = 0;
+}
+
+void SPWFSAxx::_rx_signal(int spwf_id) {
+    int internal_id = _associated_interface.get_internal_id(spwf_id);
+
+    if(internal_id != SPWFSA_SOCKET_COUNT) {
+        _associated_interface._rx_signal(internal_id);
+    }
 }
 
 void SPWFSAxx::_free_all_packets() {
@@ -742,49 +1057,484 @@ void SPWFSAxx::_free_all_packets() {
     }
 }
 
-bool SPWFSAxx::close(int spwf_id)
+bool SPWFSAxx::setTlsCertificate(const char *kind, const void *data, uint32_t len)
+{
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    if (!(_send_cmd(SPWFXX_SEND_TLS_CERT "%s,%u", kind, (unsigned int)len)
+            && (_parser.write((const char*)data, (int)len) == (int)len)
+            && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> error storing TLS certificate (%s)\r\n", kind);
+        empty_rx_buffer();
+        return false;
+    }
+
+    return true;
+}
+
+bool SPWFSAxx::clearTlsCertificates(void)
+{
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    if (!(_send_cmd(SPWFXX_SEND_TLS_CLEAN) && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> error removing TLS certificates\r\n");
+        return false;
+    }
+
+    return true;
+}
+
+/* Note: RTTs get parsed out of the reply lines (summary lines are ignored) & accumulated into `_stats` */
+bool SPWFSAxx::ping(const char *host, int count, int size, spwf_ping_result_t *result)
 {
+    char line[SPWFXX_HTTP_LINE_SIZE];
+    char *fields[SPWFXX_PING_REPLY_FIELDS];
+    uint32_t rtt, rtt_total = 0;
     bool ret = false;
 
     BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
                                  Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
 
-    MBED_ASSERT(((unsigned int)spwf_id) < ((unsigned int)SPWFSA_SOCKET_COUNT)); // `spwf_id` is valid
+    memset(result, 0, sizeof(*result));
 
-    for(int retry_cnt = 0; retry_cnt < SPWFXX_MAX_TRIALS; retry_cnt++) {
-        Timer timer;
-        timer.start();
+    /* block asynchronous indications (would otherwise get mixed into the replies) */
+    if(!_winds_off()) {
+        return false;
+    }
 
-        // Flush out pending data
-        while(true) {
-            int amount = _read_in_pkt(spwf_id, true);
-            if(amount < 0) { // SPWFXX error
-                /* empty RX buffer & try to close */
-                empty_rx_buffer();
+    if(_send_cmd(SPWFXX_SEND_PING, count, size, host)) {
+        while(_recv_line(line, sizeof(line)) >= 0) {
+            if(_is_ok_line(line)) {
+#if defined(SPWFSAXX_CMD_STATS)
+                _cmd_stats_stop();
+#endif
+                ret = true;
                 break;
             }
-            if(amount == 0) break; // no more data to be read
-
-            /* Try to work around module API bug:
-             * break out & try to close after 20 seconds
-             */
-            if(timer.read() > 20) {
+            if(strncmp(line, "ERROR", 5) == 0) {
+                debug_if(_dbg_on, "AT^ %s (%d)\r\n", line, __LINE__);
                 break;
             }
 
-            /* immediately free packet(s) (to avoid "out of memory") */
-            _free_packets(spwf_id);
+            if(!((strncmp(line, SPWFXX_RECV_PING_REPLY, sizeof(SPWFXX_RECV_PING_REPLY) - 1) == 0)
+                    && (_split_fields(line + sizeof(SPWFXX_RECV_PING_REPLY) - 1, SPWFXX_PING_REPLY_SEP,
+                                      fields, SPWFXX_PING_REPLY_FIELDS) >= SPWFXX_PING_REPLY_FIELDS)
+                    && _parse_uint(fields[SPWFXX_PING_REPLY_TIME], &rtt))) {
+                continue;
+            }
 
-            /* interleave bottom halves */
-            _execute_bottom_halves();
+            if((result->received == 0) || (rtt < result->rtt_min_ms)) result->rtt_min_ms = rtt;
+            if(rtt > result->rtt_max_ms) result->rtt_max_ms = rtt;
+            rtt_total += rtt;
+            result->received++;
         }
+    }
 
-        // Close socket
-        if (_parser.send("AT+S.SOCKC=%d", spwf_id)
-                && _recv_ok()) {
-            ret = true;
-            break; // finish closing
-        } else { // close failed
+    if(!ret) {
+        debug_if(_dbg_on, "\r\nSPWF> error pinging %s\r\n", host);
+        empty_rx_buffer();
+    }
+
+    /* unblock asynchronous indications */
+    _winds_on();
+
+    if(!ret) return false;
+
+    result->sent = ((uint32_t)count > result->received) ? (uint32_t)count : result->received;
+    if(result->received > 0) result->rtt_avg_ms = rtt_total / result->received;
+
+    /* link quality statistics */
+    if(result->received > 0) {
+        if((_stats.ping_received == 0) || (result->rtt_min_ms < _stats.ping_rtt_min_ms)) {
+            _stats.ping_rtt_min_ms = result->rtt_min_ms;
+        }
+        if(result->rtt_max_ms > _stats.ping_rtt_max_ms) _stats.ping_rtt_max_ms = result->rtt_max_ms;
+    }
+    _stats.ping_sent += result->sent;
+    _stats.ping_received += result->received;
+    _stats.ping_rtt_total_ms += rtt_total;
+
+    return true;
+}
+
+bool SPWFSAxx::fileCreate(const char *name, uint32_t size)
+{
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    if(!(_send_cmd(SPWFXX_SEND_FS_CREATE "%s,%u", name, (unsigned int)size) && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> error creating file %s\r\n", name);
+        return false;
+    }
+
+    return true;
+}
+
+bool SPWFSAxx::fileAppend(const char *name, const void *data, uint32_t len)
+{
+    uint32_t written = 0U, to_write;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    /* betzw - WORK AROUND module FW issues: split up big packages in smaller ones */
+    for(; written < len; written += to_write) {
+        to_write = ((len - written) > SPWFXX_SEND_RECV_PKTSIZE) ? SPWFXX_SEND_RECV_PKTSIZE : (len - written);
+
+        if(!(_send_cmd(SPWFXX_SEND_FS_APPEND "%s,%u", name, (unsigned int)to_write)
+                && (_parser.write(((const char*)data) + written, (int)to_write) == (int)to_write)
+                && _recv_ok())) {
+            debug_if(_dbg_on, "\r\nSPWF> error appending to file %s (written=%u)\r\n", name, written);
+            empty_rx_buffer();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SPWFSAxx::fileDelete(const char *name)
+{
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    if(!(_send_cmd(SPWFXX_SEND_FS_DELETE "%s", name) && _recv_ok())) {
+        debug_if(_dbg_on, "\r\nSPWF> error deleting file %s\r\n", name);
+        return false;
+    }
+
+    return true;
+}
+
+int SPWFSAxx::fileList(spwf_file_t *files, unsigned limit)
+{
+    return _file_list(files, limit, NULL, NULL);
+}
+
+/* List files (see `fileList()`), optionally looking up the size of file `find` (left untouched if not found) */
+int SPWFSAxx::_file_list(spwf_file_t *files, unsigned limit, const char *find, uint32_t *find_size)
+{
+    char line[SPWFXX_HTTP_LINE_SIZE];
+    char name[SPWFSA_FS_NAME_SIZE];
+    unsigned int size;
+    int cnt = 0;
+    int ret = SPWFXX_ERR_READ;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    /* block asynchronous indications (would otherwise get mixed into the list) */
+    if(!_winds_off()) {
+        return SPWFXX_ERR_READ;
+    }
+
+    if(_send_cmd(SPWFXX_SEND_FS_LIST)) {
+        while(_recv_line(line, sizeof(line)) >= 0) {
+            if(_is_ok_line(line)) {
+#if defined(SPWFSAXX_CMD_STATS)
+                _cmd_stats_stop();
+#endif
+                ret = cnt;
+                break;
+            }
+            if(strncmp(line, "ERROR", 5) == 0) {
+                debug_if(_dbg_on, "AT^ %s (%d)\r\n", line, __LINE__);
+                break;
+            }
+
+#if SPWFXX_FS_ENTRY_SIZE_FIRST
+            if(sscanf(line, SPWFXX_RECV_FS_ENTRY, &size, name) != 2) continue;
+#else
+            if(sscanf(line, SPWFXX_RECV_FS_ENTRY, name, &size) != 2) continue;
+#endif
+
+            if(((unsigned)cnt) < limit) {
+                strcpy(files[cnt].name, name);
+                files[cnt].size = size;
+            }
+            if((find != NULL) && (strcmp(name, find) == 0)) {
+                *find_size = size;
+            }
+            cnt++;
+        }
+    }
+
+    if(ret < 0) {
+        debug_if(_dbg_on, "\r\nSPWF> error listing files\r\n");
+        empty_rx_buffer();
+    }
+
+    /* unblock asynchronous indications */
+    _winds_on();
+
+    return ret;
+}
+
+/* Note: the amount of data printed by the module is determined beforehand (file contents might
+ *       contain the module's final "OK" line) */
+int SPWFSAxx::fileRead(const char *name, uint32_t offset, uint32_t len, spwf_data_sink_t sink)
+{
+    int ret = SPWFXX_ERR_READ;
+    uint32_t size = (uint32_t)-1;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    /* get file size (reads are limited to the end of the file) */
+    if(_file_list(NULL, 0, name, &size) < 0) {
+        return SPWFXX_ERR_READ;
+    }
+    if(size == (uint32_t)-1) {
+        debug_if(_dbg_on, "\r\nSPWF> file %s not found\r\n", name);
+        return SPWFXX_ERR_READ;
+    }
+
+    if(offset >= size) return 0;
+    if((len == 0) || (len > (size - offset))) len = size - offset;
+
+    /* block asynchronous indications (would otherwise get mixed into the file contents) */
+    if(!_winds_off()) {
+        return SPWFXX_ERR_READ;
+    }
+
+    if(_send_cmd(SPWFXX_SEND_FS_PRINT "%s,%u,%u", name, (unsigned int)offset, (unsigned int)len)) {
+        ret = _recv_data_len(sink, len);
+        if(ret < 0) empty_rx_buffer();
+    } else {
+        debug_if(_dbg_on, "\r\nSPWF> error reading file %s\r\n", name);
+    }
+
+    /* unblock asynchronous indications */
+    _winds_on();
+
+    return ret;
+}
+
+int SPWFSAxx::httpRequest(const char *host, const char *path, int port, bool tls,
+                          const char *form, spwf_data_sink_t sink, int *status)
+{
+    int ret = SPWFXX_ERR_READ;
+    bool sent;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    *status = 0;
+
+    /* block asynchronous indications (would otherwise get mixed into the response body) */
+    if(!_winds_off()) {
+        return SPWFXX_ERR_READ;
+    }
+
+    if(form == NULL) {
+        sent = _send_cmd(SPWFXX_SEND_HTTP_GET, host, path, port, tls ? 1 : 0);
+    } else {
+        sent = _send_cmd(SPWFXX_SEND_HTTP_POST, host, path, form, port, tls ? 1 : 0);
+    }
+
+    if(sent) {
+        ret = _http_recv_response(sink, status);
+        if(ret < 0) empty_rx_buffer();
+    } else {
+        debug_if(_dbg_on, "\r\nSPWF> error sending HTTP request (%d)\r\n", __LINE__);
+    }
+
+    /* unblock asynchronous indications */
+    _winds_on();
+
+    return ret;
+}
+
+int SPWFSAxx::_http_recv_response(spwf_data_sink_t &sink, int *status)
+{
+    char line[SPWFXX_HTTP_LINE_SIZE];
+
+    /* status line */
+    do {
+        if(_recv_line(line, sizeof(line)) < 0) {
+            debug_if(_dbg_on, "\r\nSPWF> no HTTP response (%d)\r\n", __LINE__);
+            return SPWFXX_ERR_READ;
+        }
+        if(strncmp(line, "ERROR", 5) == 0) {
+            debug_if(_dbg_on, "AT^ %s (%d)\r\n", line, __LINE__);
+            return SPWFXX_ERR_READ;
+        }
+    } while(sscanf(line, SPWFXX_RECV_HTTP_STATUS, status) != 1);
+
+#if SPWFXX_HTTP_RAW_HEADERS
+    uint32_t content_len;
+    bool has_len = false;
+
+    /* skip headers (except for the body length) */
+    do {
+        if(_recv_line(line, sizeof(line)) < 0) return SPWFXX_ERR_READ;
+        if(_http_content_length(line, &content_len)) has_len = true;
+    } while(line[0] != '\0');
+
+    if((*status == 204) || (*status == 304)) { // no body
+        has_len = true;
+        content_len = 0;
+    }
+
+    /* body (of known length, which might contain `SPWFXX_DATA_END`) */
+    if(has_len) {
+        return _recv_data_len(sink, content_len);
+    }
+#endif
+
+    /* body */
+    return _recv_data(sink);
+}
+
+/* Parse a "Content-Length" header line (field name is case-insensitive) */
+bool SPWFSAxx::_http_content_length(char *line, uint32_t *len)
+{
+    static const char field[] = "content-length";
+    char *value, *end;
+
+    if((value = strchr(line, ':')) == NULL) return false;
+    if((value - line) != (sizeof(field) - 1)) return false;
+
+    for(size_t i = 0; i < (sizeof(field) - 1); i++) {
+        if(tolower((unsigned char)line[i]) != field[i]) return false;
+    }
+
+    for(value++; *value == ' '; value++);
+    for(end = value + strlen(value); (end > value) && (end[-1] == ' '); end--);
+    *end = '\0';
+
+    return _parse_uint(value, len);
+}
+
+/* Stream variable length data through `_data_chunk` to `sink` up to `SPWFXX_DATA_END`
+ *
+ * Note: (partial) matches of `SPWFXX_DATA_END` are held back until they turn out not to be the end
+ *       (which requires `SPWFXX_DATA_END` to contain `\r` only in its leading & trailing `\r\n`)
+ */
+int SPWFSAxx::_recv_data(spwf_data_sink_t &sink)
+{
+    static const char data_end[] = SPWFXX_DATA_END;
+    size_t matched = 0, held, fill = 0;
+    int total = 0;
+    bool deliver = true;
+    int c;
+
+    while(true) {
+        if((c = _parser.getc()) < 0) {
+            debug_if(_dbg_on, "\r\nSPWF> data incomplete (%d)\r\n", __LINE__);
+            return SPWFXX_ERR_READ;
+        }
+
+        if(c == data_end[matched]) {
+            if(data_end[++matched] == '\0') break;
+            continue;
+        }
+
+        /* no match: release held back bytes (& current one, unless it starts a new match) */
+        held = matched;
+        matched = (c == data_end[0]) ? 1 : 0;
+
+        for(size_t i = 0; i < (held + 1 - matched); i++) {
+            _data_chunk[fill++] = (i < held) ? (uint8_t)data_end[i] : (uint8_t)c;
+
+            if(fill == sizeof(_data_chunk)) {
+                if(deliver && !(deliver = sink(_data_chunk, fill))) {
+                    debug_if(_dbg_on, "\r\nSPWF> data discarded (%d)\r\n", __LINE__);
+                }
+                total += fill;
+                fill = 0;
+            }
+        }
+    }
+
+    if((fill > 0) && deliver) {
+        deliver = sink(_data_chunk, fill);
+    }
+    total += fill;
+
+#if defined(SPWFSAXX_CMD_STATS)
+    _cmd_stats_stop();
+#endif
+
+    return deliver ? total : SPWFXX_ERR_READ;
+}
+
+/* Stream exactly `len` bytes of data through `_data_chunk` to `sink`, followed by the final "OK" */
+int SPWFSAxx::_recv_data_len(spwf_data_sink_t &sink, uint32_t len)
+{
+    uint32_t total, n;
+    bool deliver = true;
+
+    for(total = 0; total < len; total += n) {
+        n = ((len - total) > sizeof(_data_chunk)) ? sizeof(_data_chunk) : (len - total);
+
+        if(_parser.read((char*)_data_chunk, (int)n) != (int)n) {
+            debug_if(_dbg_on, "\r\nSPWF> data incomplete (%d)\r\n", __LINE__);
+            return SPWFXX_ERR_READ;
+        }
+
+        if(deliver && !(deliver = sink(_data_chunk, n))) {
+            debug_if(_dbg_on, "\r\nSPWF> data discarded (%d)\r\n", __LINE__);
+        }
+    }
+
+    if(!_recv_ok()) {
+        debug_if(_dbg_on, "\r\nSPWF> data not terminated (%d)\r\n", __LINE__);
+        return SPWFXX_ERR_READ;
+    }
+
+    return deliver ? (int)total : SPWFXX_ERR_READ;
+}
+
+bool SPWFSAxx::close(int spwf_id)
+{
+    bool ret = false;
+
+    BlockExecuter netsock_wa_obj(Callback<void()>(this, &SPWFSAxx::_unblock_event_callback),
+                                 Callback<void()>(this, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+
+    MBED_ASSERT(((unsigned int)spwf_id) < ((unsigned int)SPWFSA_SOCKET_COUNT)); // `spwf_id` is valid
+
+    for(int retry_cnt = 0; retry_cnt < SPWFXX_MAX_TRIALS; retry_cnt++) {
+        Timer timer;
+        timer.start();
+
+        if(retry_cnt > 0) {
+            _socket_stat_add(spwf_id, &spwf_socket_stats_t::close_retries, 1);
+        }
+
+        // Flush out pending data
+        while(true) {
+            int amount = _read_in_pkt(spwf_id, true);
+            if(amount < 0) { // SPWFXX error
+                /* empty RX buffer & try to close */
+                empty_rx_buffer();
+                break;
+            }
+            if(amount == 0) break; // no more data to be read
+
+            /* Try to work around module API bug:
+             * break out & try to close after 20 seconds
+             */
+            if(timer.read() > 20) {
+                break;
+            }
+
+            /* immediately free packet(s) (to avoid "out of memory") */
+            _free_packets(spwf_id);
+
+            /* interleave bottom halves */
+            _execute_bottom_halves();
+        }
+
+        // Close socket
+        if (_send_cmd("AT+S.SOCKC=%d", spwf_id)
+                && _recv_ok()) {
+            ret = true;
+            break; // finish closing
+        } else { // close failed
             debug_if(_dbg_on, "\r\nSPWF> %s failed (%d)\r\n", __func__, __LINE__);
             /* interleave bottom halves */
             _execute_bottom_halves();
@@ -827,6 +1577,12 @@ bool SPWFSAxx::close(int spwf_id)
     return ret;
 }
 
+/* Note: static dispatch to the module specific backend (there is exactly one `SPWFSAxx` object, which is of type `SpwfSABackend`) */
+int SPWFSAxx::_read_in(char *buffer, int spwf_id, uint32_t amount)
+{
+    return static_cast<SpwfSABackend*>(this)->SpwfSABackend::_read_in(buffer, spwf_id, amount);
+}
+
 /*
  * Buffered serial event handler
  *
@@ -835,6 +1591,9 @@ bool SPWFSAxx::close(int spwf_id)
  */
 void SPWFSAxx::_event_handler(void)
 {
+    /* wake up (at most) one blocked receiver to process received data */
+    _associated_interface._rx_signal_uart();
+
     if(!_is_event_callback_blocked()) {
         _call_callback();
     }
@@ -845,7 +1604,14 @@ void SPWFSAxx::_event_handler(void)
  */
 void SPWFSAxx::_error_handler(void)
 {
-    if(_parser.recv("%255[^\n]\n", _msg_buffer) && _recv_delim_lf()) {
+    _stats.errors++;
+    SPWFSAXX_TRACE_EVENT(SPWF_TRACE_ERROR, 0);
+
+#if defined(SPWFSAXX_CMD_STATS)
+    _cmd_stats_stop(); // command completed with error
+#endif
+
+    if(_recv_line(_msg_buffer, sizeof(_msg_buffer)) > 0) {
         debug_if(_dbg_on, "AT^ ERROR:%s (%d)\r\n", _msg_buffer, __LINE__);
     } else {
         debug_if(_dbg_on, "\r\nSPWF> Unknown ERROR string in SPWFSAxx::_error_handler (%d)\r\n", __LINE__);
@@ -858,16 +1624,16 @@ void SPWFSAxx::_error_handler(void)
 /*
  * Handling oob ("+WIND:33:WiFi Network Lost")
  */
-void SPWFSAxx::_network_lost_handler_th(void)
+void SPWFSAxx::_network_lost_handler_th(char *args)
 {
 #ifndef NDEBUG
     static unsigned int net_loss_cnt = 0;
     net_loss_cnt++;
 #endif
 
-    _recv_delim_cr_lf();
+    _stats.wind_network_lost++;
 
-    debug_if(_dbg_on, "AT^ +WIND:33:WiFi Network Lost\r\n");
+    debug_if(_dbg_on, "AT^ +WIND:33:%s\r\n", args);
 
 #ifndef NDEBUG
     debug_if(_dbg_on, "\r\nSPWF> Getting out of SPWFSAxx::_network_lost_handler_th: %d\r\n", net_loss_cnt);
@@ -877,6 +1643,7 @@ void SPWFSAxx::_network_lost_handler_th(void)
 
     /* set flag to signal network loss */
     _network_lost_flag = true;
+    _associated_interface._rx_signal_all();
 
     /* force call of (external) callback */
     _call_callback();
@@ -884,22 +1651,16 @@ void SPWFSAxx::_network_lost_handler_th(void)
     return;
 }
 
-/* betzw - WORK AROUND module FW issues: split up big packages in smaller ones */
+/* Note: splitting up of big packages in smaller ones is performed by `SpwfRealPendingPackets` */
 void SPWFSAxx::_add_pending_packet_sz(int spwf_id, uint32_t size) {
-    uint32_t to_add;
-    uint32_t added = _get_cumulative_size(spwf_id);
-
-    if(size <= added) { // might happen due to delayed WIND delivery
+    if(size <= _get_cumulative_size(spwf_id)) { // might happen due to delayed WIND delivery
         debug_if(_dbg_on, "\r\nSPWF> WARNING: %s failed at line #%d\r\n", __func__, __LINE__);
         return;
     }
 
-    for(to_add = ((size - added) > SPWFXX_SEND_RECV_PKTSIZE) ? SPWFXX_SEND_RECV_PKTSIZE : (size - added);
-            added < size;
-            to_add = ((size - added) > SPWFXX_SEND_RECV_PKTSIZE) ? SPWFXX_SEND_RECV_PKTSIZE : (size - added)) {
-        _add_pending_pkt_size(spwf_id, added + to_add);
-        added += to_add;
-    }
+    _add_pending_pkt_size(spwf_id, size);
+
+    _rx_signal(spwf_id);
 
     /* force call of (external) callback */
     _call_callback();
@@ -911,19 +1672,29 @@ void SPWFSAxx::_add_pending_packet_sz(int spwf_id, uint32_t size) {
 /*
  * Handling oob ("+WIND:55:Pending Data")
  */
-void SPWFSAxx::_packet_handler_th(void)
+void SPWFSAxx::_packet_handler_th(char *args)
 {
     int internal_id, spwf_id;
     int amount;
+    char *fields[SPWFXX_PENDING_DATA_FIELDS];
+    uint32_t value_id, value_amount;
+
+    _stats.wind_pending_data++;
 
-    /* parse out the socket id & amount */
-    if (!(_parser.recv(SPWFXX_RECV_PENDING_DATA, &spwf_id, &amount) && _recv_delim_lf())) {
+    /* parse out the socket id & amount (following the description) */
+    if (!(((args = strchr(args, ':')) != NULL)
+            && (_split_fields(args, ':', fields, SPWFXX_PENDING_DATA_FIELDS) == SPWFXX_PENDING_DATA_FIELDS)
+            && _parse_uint(fields[SPWFXX_PENDING_DATA_ID], &value_id)
+            && _parse_uint(fields[SPWFXX_PENDING_DATA_AMOUNT], &value_amount))) {
 #ifndef NDEBUG
         error("\r\nSPWF> SPWFSAxx::%s failed!\r\n", __func__);
 #endif
         return;
     }
 
+    spwf_id = (int)value_id;
+    amount = (int)value_amount;
+
     debug_if(_dbg_on, "AT^ +WIND:55:Pending Data:%d:%d\r\n", spwf_id, amount);
 
     /* check for the module to report a valid id */
@@ -962,7 +1733,11 @@ void SPWFSAxx::_network_lost_handler_bh(void)
         _associated_interface._connected_to_network = false;
 
         if(were_connected) {
-            unsigned int n1, n2, n3, n4;
+            unsigned int n[4];
+            int wind_id;
+            char *ip;
+
+            _associated_interface._set_connection_status(NSAPI_STATUS_CONNECTING);
 
             while(true) {
                 if (timer.read_ms() > SPWF_CONNECT_TIMEOUT) {
@@ -972,10 +1747,15 @@ void SPWFSAxx::_network_lost_handler_bh(void)
                     goto nlh_get_out;
                 }
 
-                if((_parser.recv(SPWFXX_RECV_WIFI_UP, &n1, &n2, &n3, &n4)) && _recv_delim_lf()) {
-                    debug_if(_dbg_on, "\r\nSPWF> Re-connected (%u.%u.%u.%u)!\r\n", n1, n2, n3, n4);
+                if(_recv_wind(&wind_id, _msg_buffer, sizeof(_msg_buffer), SPWF_NETLOST_TIMEOUT)
+                        && (wind_id == SPWFXX_WIND_WIFI_UP)
+                        && ((ip = strrchr(_msg_buffer, ':')) != NULL)
+                        && _parse_ipv4(ip + 1, n)) {
+                    debug_if(_dbg_on, "\r\nSPWF> Re-connected (%u.%u.%u.%u)!\r\n", n[0], n[1], n[2], n[3]);
 
                     _associated_interface._connected_to_network = true;
+                    _associated_interface._set_connection_status(NSAPI_STATUS_GLOBAL_UP);
+                    _stats.reconnections++;
                     goto nlh_get_out;
                 }
             }
@@ -996,9 +1776,13 @@ void SPWFSAxx::_network_lost_handler_bh(void)
 }
 
 void SPWFSAxx::_recover_from_hard_faults(void) {
-    disconnect();
+    if(!_associated_interface._recover_sessions()) {
+        disconnect();
+    }
     empty_rx_buffer();
 
+    _associated_interface._rx_signal_all();
+
     /* force call of (external) callback */
     _call_callback();
 }
@@ -1006,22 +1790,15 @@ void SPWFSAxx::_recover_from_hard_faults(void) {
 /*
  * Handling oob ("+WIND:8:Hard Fault")
  */
-void SPWFSAxx::_hard_fault_handler(void)
+void SPWFSAxx::_hard_fault_handler(char *args)
 {
-    _parser.set_timeout(SPWF_RECV_TIMEOUT);
-    if(_parser.recv("%255[^\n]\n", _msg_buffer) && _recv_delim_lf()) {
-#ifndef NDEBUG
-        error("\r\nSPWF> hard fault error:\r\n%s\r\n", _msg_buffer);
-#else // NDEBUG
-        debug("\r\nSPWF> hard fault error:\r\n%s\r\n", _msg_buffer);
-#endif // NDEBUG
-    } else {
+    _stats.wind_hard_fault++;
+
 #ifndef NDEBUG
-        error("\r\nSPWF> unknown hard fault error\r\n");
+    error("\r\nSPWF> hard fault error:\r\n%s\r\n", args);
 #else // NDEBUG
-        debug("\r\nSPWF> unknown hard fault error\r\n");
+    debug("\r\nSPWF> hard fault error:\r\n%s\r\n", args);
 #endif // NDEBUG
-    }
 
     // This is most likely the best we can do to recover from this module hard fault
     _parser.set_timeout(SPWF_HF_TIMEOUT);
@@ -1035,18 +1812,21 @@ void SPWFSAxx::_hard_fault_handler(void)
 /*
  * Handling oob ("+WIND:5:WiFi Hardware Failure")
  */
-void SPWFSAxx::_wifi_hwfault_handler(void)
+void SPWFSAxx::_wifi_hwfault_handler(char *args)
 {
-    unsigned int failure_nr;
+    uint32_t failure_nr = 0;
 
-    /* parse out the socket id & amount */
-    _parser.recv(":%u\n", &failure_nr);
-    _recv_delim_lf();
+    _stats.wind_hw_failure++;
+
+    /* parse out the failure number (following the description) */
+    if(((args = strchr(args, ':')) != NULL)) {
+        _parse_uint(args + 1, &failure_nr);
+    }
 
 #ifndef NDEBUG
-    error("\r\nSPWF> WiFi HW fault error: %u\r\n", failure_nr);
+    error("\r\nSPWF> WiFi HW fault error: %lu\r\n", (unsigned long)failure_nr);
 #else // NDEBUG
-    debug("\r\nSPWF> WiFi HW fault error: %u\r\n", failure_nr);
+    debug("\r\nSPWF> WiFi HW fault error: %lu\r\n", (unsigned long)failure_nr);
 
     // This is most likely the best we can do to recover from this module hard fault
     _parser.set_timeout(SPWF_HF_TIMEOUT);
@@ -1065,17 +1845,26 @@ void SPWFSAxx::_wifi_hwfault_handler(void)
  * NOTE: When a socket client receives an indication about socket server gone (only for TCP sockets, WIND:58),
  *       the socket connection is NOT automatically closed!
  */
-void SPWFSAxx::_server_gone_handler(void)
+void SPWFSAxx::_server_gone_handler(char *args)
 {
     int spwf_id, internal_id;
+    char *fields[SPWFXX_SOCKET_CLOSED_FIELDS];
+    uint32_t value_id;
+
+    _stats.wind_socket_closed++;
 
-    if(!(_parser.recv(SPWFXX_RECV_SOCKET_CLOSED, &spwf_id) && _recv_delim_lf())) {
+    /* parse out the socket id (following the description) */
+    if(!(((args = strchr(args, ':')) != NULL)
+            && (_split_fields(args, ':', fields, SPWFXX_SOCKET_CLOSED_FIELDS) == SPWFXX_SOCKET_CLOSED_FIELDS)
+            && _parse_uint(fields[SPWFXX_SOCKET_CLOSED_ID], &value_id))) {
 #ifndef NDEBUG
         error("\r\nSPWF> SPWFSAxx::%s failed!\r\n", __func__);
 #endif
         goto _get_out;
     }
 
+    spwf_id = (int)value_id;
+
     debug_if(_dbg_on, "AT^ +WIND:58:Socket Closed:%d\r\n", spwf_id);
 
     /* check for the module to report a valid id */
@@ -1087,6 +1876,7 @@ void SPWFSAxx::_server_gone_handler(void)
     internal_id = _associated_interface.get_internal_id(spwf_id);
     if(internal_id != SPWFSA_SOCKET_COUNT) {
         _associated_interface._ids[internal_id].server_gone = true;
+        _associated_interface._rx_signal(internal_id);
     }
 
 _get_out:
@@ -1094,19 +1884,246 @@ _get_out:
     _call_callback();
 }
 
-#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
 /*
- * Handling oob (currently only for "+WIND:24:WiFi Up::")
+ * Handling oob ("+WIND:<id>:<description>[:<arguments>]")
+ *
+ * Note: dispatches on the numeric WIND id, i.e. independently of the number of handled WINDs
+ *       (the `switch` on a dense range of ids gets compiled into a jump table)
+ * Note: WINDs without dedicated handler are queued for synchronous waiters (see `_recv_wind()`)
  */
-void SPWFSAxx::_skip_oob(void)
+void SPWFSAxx::_wind_handler(void)
 {
-    if(_parser.recv("%255[^\n]\n", _msg_buffer) && _recv_delim_lf()) {
-        debug_if(_dbg_on, "AT^ +WIND:24:WiFi Up::%s\r\n", _msg_buffer);
-    } else {
-        debug_if(_dbg_on, "\r\nSPWF> Invalid string in SPWFSAxx::_skip_oob (%d)\r\n", __LINE__);
+    char line[SPWFXX_WIND_LINE_SIZE];
+    bool waiting = _wind_waiting; // called from within the receive of `_recv_wind()`
+
+    if(_recv_line(line, sizeof(line)) < 0) {
+        debug_if(_dbg_on, "\r\nSPWF> Invalid string in SPWFSAxx::%s (%d)\r\n", __func__, __LINE__);
+        return;
+    }
+
+    _wind_waiting = false; // receives of WIND handlers must not get aborted
+    _wind_dispatch(line);
+    _wind_waiting = waiting;
+
+    /* wake up `_recv_wind()` */
+    if(waiting && (_wind_queue_cnt > 0)) {
+        _parser.abort();
     }
 }
+
+/* Dispatch a WIND line (following `SPWFXX_OOB_WIND`) to its handler */
+void SPWFSAxx::_wind_dispatch(char *line)
+{
+    char *args;
+    uint32_t wind_id;
+
+    _stats.winds++;
+
+    if((args = strchr(line, ':')) == NULL) {
+        debug_if(_dbg_on, "\r\nSPWF> Invalid string in SPWFSAxx::%s (%d)\r\n", __func__, __LINE__);
+        return;
+    }
+    *args++ = '\0';
+
+    if(!_parse_uint(line, &wind_id)) {
+        debug_if(_dbg_on, "\r\nSPWF> Invalid WIND id in SPWFSAxx::%s (%d)\r\n", __func__, __LINE__);
+        return;
+    }
+
+    SPWFSAXX_TRACE_EVENT(SPWF_TRACE_WIND, wind_id);
+
+    switch(wind_id) {
+        case SPWFXX_WIND_PENDING_DATA:
+            _packet_handler_th(args);
+            break;
+        case SPWFXX_WIND_SOCKET_CLOSED:
+            _server_gone_handler(args);
+            break;
+        case SPWFXX_WIND_NETWORK_LOST:
+            _network_lost_handler_th(args);
+            break;
+        case SPWFXX_WIND_HARD_FAULT:
+            _hard_fault_handler(args);
+            break;
+        case SPWFXX_WIND_HW_FAILURE:
+            _wifi_hwfault_handler(args);
+            break;
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+        case SPWFXX_WIND_SOCKD_CLIENT:
+            static_cast<SpwfSABackend*>(this)->_sockd_client_handler(args);
+            break;
+        case SPWFXX_WIND_SOCKD_GONE:
+            static_cast<SpwfSABackend*>(this)->_sockd_gone_handler(args);
+            break;
+        case SPWFXX_WIND_SOCKD_DATA:
+            static_cast<SpwfSABackend*>(this)->_sockd_data_handler(args);
+            break;
+        case SPWFXX_WIND_WSOCK_CLOSED:
+            static_cast<SpwfSABackend*>(this)->_wsock_closed_handler(args);
+            break;
+        case SPWFXX_WIND_WSOCK_DATA:
+            static_cast<SpwfSABackend*>(this)->_wsock_data_handler(args);
+            break;
+        case SPWFXX_WIND_MQTT_PUBLISHED:
+            static_cast<SpwfSABackend*>(this)->_mqtt_published_handler(args);
+            break;
+        case SPWFXX_WIND_MQTT_CLOSED:
+            static_cast<SpwfSABackend*>(this)->_mqtt_closed_handler(args);
+            break;
+        case SPWFXX_WIND_WIFI_UP:
+            if(strncmp(args, "WiFi Up::", sizeof("WiFi Up::") - 1) == 0) { // skip IPv6 address
+                debug_if(_dbg_on, "AT^ +WIND:24:%s\r\n", args);
+                break;
+            }
+            /* fall through */
 #endif
+        default:
+            _stats.wind_other++;
+            _wind_enqueue(wind_id, args);
+            break;
+    }
+}
+
+/* Note: when the queue is full the oldest WIND gets discarded */
+void SPWFSAxx::_wind_enqueue(int wind_id, const char *args)
+{
+    unsigned int last;
+
+    if(_wind_queue_cnt == SPWFXX_WIND_QUEUE_LEN) {
+        _wind_queue_first = (_wind_queue_first + 1) % SPWFXX_WIND_QUEUE_LEN;
+        _wind_queue_cnt--;
+    }
+
+    last = (_wind_queue_first + _wind_queue_cnt) % SPWFXX_WIND_QUEUE_LEN;
+    _wind_queue[last].id = wind_id;
+    strncpy(_wind_queue[last].args, args, SPWFXX_WIND_ARGS_SIZE - 1);
+    _wind_queue[last].args[SPWFXX_WIND_ARGS_SIZE - 1] = '\0';
+    _wind_queue_cnt++;
+}
+
+/* Get the oldest queued WIND, waiting (max. `timeout_ms`) for one to arrive if none is queued
+ *
+ * Note: blocks on the parser (whose timeout is expected to be `timeout_ms`) until `_wind_handler()` aborts
+ *       the receive, any other received line is handled as OOB or discarded (like `ATCmdParser::recv()` would do)
+ */
+bool SPWFSAxx::_recv_wind(int *wind_id, char *args, int size, int timeout_ms)
+{
+    bool waiting = _wind_waiting;
+#if MBED_CONF_RTOS_PRESENT
+    uint64_t start = Kernel::get_ms_count(); // Note: unlike a running `Timer` does not lock deep sleep
+#else // !MBED_CONF_RTOS_PRESENT
+    uint32_t start = us_ticker_read();
+#endif // !MBED_CONF_RTOS_PRESENT
+
+    _wind_waiting = true;
+    while(_wind_queue_cnt == 0) {
+        if(!_parser.recv("%*[^\n]\n") && (_wind_queue_cnt == 0)) {
+            break; // timeout
+        }
+#if MBED_CONF_RTOS_PRESENT
+        if((int)(Kernel::get_ms_count() - start) >= timeout_ms) break;
+#else // !MBED_CONF_RTOS_PRESENT
+        if((int)(((uint32_t)us_ticker_read() - start) / 1000) >= timeout_ms) break;
+#endif // !MBED_CONF_RTOS_PRESENT
+    }
+    _wind_waiting = waiting;
+
+    if(_wind_queue_cnt == 0) {
+        return false;
+    }
+
+    *wind_id = _wind_queue[_wind_queue_first].id;
+    if(size > 0) {
+        strncpy(args, _wind_queue[_wind_queue_first].args, size - 1);
+        args[size - 1] = '\0';
+    }
+    _wind_queue_first = (_wind_queue_first + 1) % SPWFXX_WIND_QUEUE_LEN;
+    _wind_queue_cnt--;
+
+    return true;
+}
+
+/* Wait for a specific WIND, discarding all other queued ones */
+bool SPWFSAxx::_wait_wind(int wind_id)
+{
+    int trials = 0;
+    int id;
+
+    while(true) {
+        if(_recv_wind(&id, NULL, 0, _timeout)) {
+            if(id == wind_id) return true;
+            continue;
+        }
+        if(++trials >= SPWFXX_MAX_TRIALS) {
+            return false;
+        }
+    }
+}
+
+#if defined(SPWFSAXX_CMD_STATS)
+static const struct {
+    const char *prefix;
+    size_t len;
+    spwf_cmd_class_t cmd_class;
+} cmd_classes[] = {
+    { SPWFXX_SEND_SOCKW, sizeof(SPWFXX_SEND_SOCKW) - 1, SPWFXX_CMD_SOCKW  },
+    { SPWFXX_SEND_SOCKR, sizeof(SPWFXX_SEND_SOCKR) - 1, SPWFXX_CMD_SOCKR  },
+    { SPWFXX_SEND_SOCKQ, sizeof(SPWFXX_SEND_SOCKQ) - 1, SPWFXX_CMD_SOCKQ  },
+    { "AT+S.SCFG",   sizeof("AT+S.SCFG") - 1,   SPWFXX_CMD_SCFG   },
+    { "AT+S.STS",    sizeof("AT+S.STS") - 1,    SPWFXX_CMD_STS    },
+    { "AT+S.SOCKON", sizeof("AT+S.SOCKON") - 1, SPWFXX_CMD_SOCKON },
+    { "AT+S.SOCKC",  sizeof("AT+S.SOCKC") - 1,  SPWFXX_CMD_SOCKC  },
+};
+
+/* Note: a command not (yet) completed by `_recv_ok()` is discarded */
+void SPWFSAxx::_cmd_stats_start(const char *command)
+{
+    _cmd_class = SPWFXX_CMD_OTHER;
+    for(unsigned int i = 0; i < (sizeof(cmd_classes) / sizeof(cmd_classes[0])); i++) {
+        if(strncmp(command, cmd_classes[i].prefix, cmd_classes[i].len) == 0) {
+            _cmd_class = cmd_classes[i].cmd_class;
+            break;
+        }
+    }
+
+    _cmd_timing = true;
+    _cmd_start_us = us_ticker_read();
+}
+
+void SPWFSAxx::_cmd_stats_stop(void)
+{
+    uint32_t elapsed;
+    int bucket;
+
+    if(!_cmd_timing) return;
+    _cmd_timing = false;
+
+    elapsed = (uint32_t)us_ticker_read() - _cmd_start_us;
+
+    /* log2 bucket */
+    for(bucket = 0; (bucket < (SPWFXX_CMD_HIST_BUCKETS - 1)) && ((elapsed >> (bucket + 1)) != 0); bucket++);
+
+    spwf_cmd_stats_t &stats = _cmd_stats[_cmd_class];
+    stats.count++;
+    stats.total_us += elapsed;
+    if(elapsed > stats.max_us) stats.max_us = elapsed;
+    stats.hist[bucket]++;
+}
+
+void SPWFSAxx::get_cmd_stats(spwf_cmd_class_t cmd_class, spwf_cmd_stats_t *stats)
+{
+    MBED_ASSERT(((unsigned int)cmd_class) < ((unsigned int)SPWFXX_CMD_CLASSES));
+    *stats = _cmd_stats[cmd_class];
+}
+
+void SPWFSAxx::reset_cmd_stats(void)
+{
+    memset(_cmd_stats, 0, sizeof(_cmd_stats));
+    _cmd_class = SPWFXX_CMD_OTHER;
+    _cmd_start_us = 0;
+    _cmd_timing = false;
+}
+#endif // SPWFSAXX_CMD_STATS
 
 void SPWFSAxx::setTimeout(uint32_t timeout_ms)
 {
@@ -1148,6 +2165,7 @@ int32_t SPWFSAxx::recv(int spwf_id, void *data, uint32_t amount, bool datagram)
                         _packets_end = p;
                     }
                     *p = (*p)->next;
+                    _rx_consumed(spwf_id, q->len);
                     free(q);
 
                     return ret;
@@ -1160,6 +2178,7 @@ int32_t SPWFSAxx::recv(int spwf_id, void *data, uint32_t amount, bool datagram)
                         }
                         *p = (*p)->next;
                         uint32_t len = q->len;
+                        _rx_consumed(spwf_id, len);
                         free(q);
 
                         return len;
@@ -1168,6 +2187,7 @@ int32_t SPWFSAxx::recv(int spwf_id, void *data, uint32_t amount, bool datagram)
                             memcpy(data, q+1, amount);
                             q->len -= amount;
                             memmove(q+1, (uint8_t*)(q+1) + amount, q->len);
+                            _rx_consumed(spwf_id, amount);
                         }
 
                         return amount;
@@ -1200,7 +2220,8 @@ void SPWFSAxx::_process_winds(void) {
 }
 
 /* Note: returns
- * '>=0'             in case of success, amount of read in data (in bytes)
+ * '>=0'             in case of success, amount of read in data (in bytes),
+ *                   '0' also in case socket's RX quota is exhausted (data is left on module)
  * 'SPWFXX_ERR_OOM'  in case of "out of memory"
  * 'SPWFXX_ERR_READ' in case of other `_read_in_packet()` error
  * 'SPWFXX_ERR_LEN'  in case of `_read_len()` error
@@ -1213,6 +2234,12 @@ int SPWFSAxx::_read_in_pkt(int spwf_id, bool close) {
 
     _process_winds(); // perform async indication handling
 
+    if(!close && _is_rx_throttled(spwf_id)) { // RX quota exhausted: leave data on module
+        _socket_stat_add(spwf_id, &spwf_socket_stats_t::rx_throttled, 1);
+        debug_if(_dbg_on, "%s():\t\tRX throttled (%d:%u)!\r\n", __func__, spwf_id, _rx_buffered[spwf_id]);
+        return 0;
+    }
+
     if(close) { // read in all data
         wind_pending = pending = _read_len(spwf_id); // triggers also async indication handling!
 
@@ -1221,16 +2248,14 @@ int SPWFSAxx::_read_in_pkt(int spwf_id, bool close) {
             _reset_pending_pkt_sizes(spwf_id);
             /* create new entry for pending size */
             _add_pending_pkt_size(spwf_id, (uint32_t)pending);
-#ifndef NDEBUG
             wind_pending = _get_pending_pkt_size(spwf_id);
-            MBED_ASSERT(pending == (int)wind_pending);
-#endif
+            MBED_ASSERT(((uint32_t)pending) == _get_cumulative_size(spwf_id));
         } else if(pending < 0) {
             debug_if(_dbg_on, "\r\nSPWF> %s(), #%d:`_read_len()` failed (%d)!\r\n", __func__, __LINE__, pending);
         }
     } else { // only read in already notified data
         pending = wind_pending = _get_pending_pkt_size(spwf_id);
-        if(pending == 0) { // special handling for no packets pending (to WORK AROUND missing WINDs)!
+        if((pending == 0) && !_fw_has(SPWFXX_FW_FEAT_WINDS_OK)) { // special handling for no packets pending (to WORK AROUND missing WINDs)!
             pending = _read_len(spwf_id); // triggers also async indication handling!
 
             if(pending > 0) {
@@ -1240,6 +2265,7 @@ int SPWFSAxx::_read_in_pkt(int spwf_id, bool close) {
                 if(wind_pending == 0) {
                     /* betzw - WORK AROUND module FW issues: create new entry for pending size */
                     debug_if(_dbg_on, "%s():\t\tAdd packet w/o WIND (%d)!\r\n", __func__, pending);
+                    _socket_stat_add(spwf_id, &spwf_socket_stats_t::sockq_fallbacks, 1);
                     _add_pending_packet_sz(spwf_id, (uint32_t)pending);
 
                     pending = wind_pending = _get_pending_pkt_size(spwf_id);
@@ -1253,7 +2279,12 @@ int SPWFSAxx::_read_in_pkt(int spwf_id, bool close) {
 
     if((pending > 0) && (wind_pending > 0)) {
         int ret = _read_in_packet(spwf_id, wind_pending);
-        if(ret < 0) { /* "out of memory" or `_read_in_packet()` error */
+        if(ret == SPWFXX_ERR_OOM) {
+            /* data has not been read in & is still buffered on the module:
+               keep pending data bookkeeping & retry after application has consumed data */
+            return ret;
+        }
+        if(ret < 0) { /* `_read_in_packet()` error */
             /* we do not know if data is still pending at this point
                but leaving the pending data bit set might lead to an endless loop */
             _clear_pending_data(spwf_id);
@@ -20,12 +20,19 @@
 #include "mbed.h"
 #include "ATCmdParser.h"
 #include "BlockExecuter.h"
+#include "SpwfTrace.h"
 
 /* Common SPWFSAxx macros */
 #define SPWFXX_WINDS_LOW_ON         "0x00000000"
 #define SPWFXX_DEFAULT_BAUD_RATE    115200
 #define SPWFXX_MAX_TRIALS           3
 
+#if defined(SPWFSAXX_TRACE)
+#define SPWFSAXX_TRACE_EVENT(...)   _trace.event(__VA_ARGS__)
+#else // !defined(SPWFSAXX_TRACE)
+#define SPWFSAXX_TRACE_EVENT(...)
+#endif // !defined(SPWFSAXX_TRACE)
+
 #if !defined(SPWFSAXX_RTS_PIN)
 #define SPWFSAXX_RTS_PIN    NC
 #endif // !defined(SPWFSAXX_RTS_PIN)
@@ -33,26 +40,115 @@
 #define SPWFSAXX_CTS_PIN    NC
 #endif // !defined(SPWFSAXX_CTS_PIN)
 
+#define SPWFXX_LINE_BUF_SIZE        (32)    // for lines parsed by `_recv_line()` & `_split_fields()`
+
+/* Module firmware version & features (see `SPWFSAxx::_probe_firmware()`) */
+#define SPWFXX_SEND_GET_VERSION     "AT+S.STS=version"
+#define SPWFXX_FW_VERSION_SIZE      (32)    // e.g. "170111-665d284-SPWF01S"
+
+#define SPWFXX_FW_FEAT_CONS_QUERIES (1 << 0)    // console delimiter & error settings can be queried
+#define SPWFXX_FW_FEAT_WINDS_OK     (1 << 1)    // pending data WINDs are reliable (no `SOCKQ` fallback needed)
+
+/* "+WIND" indications */
+#define SPWFXX_OOB_WIND             "+WIND:"
+#define SPWFXX_WIND_LINE_SIZE       (96)    // remainder of line following `SPWFXX_OOB_WIND`
+#define SPWFXX_WIND_QUEUE_LEN       (4)     // WINDs queued for synchronous waiters
+#define SPWFXX_WIND_ARGS_SIZE       (48)
+
+#define SPWFXX_WIND_CONSOLE_ACTIVE  (0)
+#define SPWFXX_WIND_HW_FAILURE      (5)
+#define SPWFXX_WIND_HARD_FAULT      (8)
+#define SPWFXX_WIND_WIFI_JOIN       (19)
+#define SPWFXX_WIND_WIFI_UP         (24)
+#define SPWFXX_WIND_HW_STARTED      (32)
+#define SPWFXX_WIND_NETWORK_LOST    (33)
+#define SPWFXX_WIND_DEAUTH          (40)
+#define SPWFXX_WIND_PENDING_DATA    (55)
+#define SPWFXX_WIND_SOCKET_CLOSED   (58)
+#define SPWFXX_WIND_SOCKD_CLIENT    (61)    // socket server: client connected (SPWFSA04 only)
+#define SPWFXX_WIND_SOCKD_GONE      (62)    // socket server: client gone (SPWFSA04 only)
+#define SPWFXX_WIND_SOCKD_DATA      (64)    // socket server: pending data (SPWFSA04 only)
+#define SPWFXX_WIND_WSOCK_CLOSED    (89)    // WebSocket client: connection closed (SPWFSA04 only)
+#define SPWFXX_WIND_WSOCK_DATA      (90)    // WebSocket client: pending data (SPWFSA04 only)
+#define SPWFXX_WIND_MQTT_PUBLISHED  (93)    // MQTT client: message received (SPWFSA04 only)
+#define SPWFXX_WIND_MQTT_CLOSED     (94)    // MQTT client: connection closed (SPWFSA04 only)
+
 #define SPWFXX_ERR_OK               (+1)
 #define SPWFXX_ERR_OOM              (-1)
 #define SPWFXX_ERR_READ             (-2)
 #define SPWFXX_ERR_LEN              (-3)
 
+/* Variable length data (HTTP response bodies, file contents) gets delivered in chunks
+ * (see `SPWFSAxx::_recv_data()` & `SPWFSAxx::_recv_data_len()`) */
+#if !defined(SPWFSA_DATA_CHUNK_SIZE)
+#define SPWFSA_DATA_CHUNK_SIZE      (128)   // size of the buffer data gets delivered in
+#endif // !defined(SPWFSA_DATA_CHUNK_SIZE)
+#define SPWFXX_HTTP_LINE_SIZE       (64)    // for HTTP status & header lines and file list entries (longer ones get truncated)
+
+/* Consumer of a chunk of data, returns `false` to discard the rest of the data */
+typedef Callback<bool(const void *data, size_t len)> spwf_data_sink_t;
+
+/* Module file system */
+#define SPWFSA_FS_NAME_SIZE         (32)    // see `SPWFXX_RECV_FS_ENTRY`
+
+/* File in the module's file system (see `SPWFSAxx::fileList()`) */
+typedef struct {
+    char name[SPWFSA_FS_NAME_SIZE];
+    uint32_t size;
+} spwf_file_t;
+
 
 /* Max number of sockets & packets */
 #define SPWFSA_SOCKET_COUNT         (8)
 #define SPWFSA_MAX_PACKETS          (4)
 
-#define PENDING_DATA_SLOTS          (13)
-
-/* Pending data packets size buffer */
+/* Max number of connected but not yet accepted socket server clients */
+#define SPWFSA_SOCKD_BACKLOG        (4)
+
+/* Max number of WebSocket client connections & of complete messages tracked per connection */
+#define SPWFSA_WSOCK_COUNT          (4)
+#if !defined(SPWFSA_WSOCK_MSG_QUEUE)
+#define SPWFSA_WSOCK_MSG_QUEUE      (8)
+#endif // !defined(SPWFSA_WSOCK_MSG_QUEUE)
+
+/* Max number of MQTT client connections & size of the buffer incoming messages get delivered in */
+#define SPWFSA_MQTT_COUNT           (2)
+#if !defined(SPWFSA_MQTT_PAYLOAD_SIZE)
+#define SPWFSA_MQTT_PAYLOAD_SIZE    (256)
+#endif // !defined(SPWFSA_MQTT_PAYLOAD_SIZE)
+
+/* Consumer of an incoming MQTT message (`len` bytes delivered of a `total_len` bytes payload, see `SPWFSA_MQTT_PAYLOAD_SIZE`) */
+typedef Callback<void(int mqtt_id, const char *topic, const void *payload, size_t len, size_t total_len)> spwf_mqtt_cb_t;
+
+/* Default max amount of received data (in bytes) to be buffered on host per socket,
+ * further data is left on the module until the application consumes buffered data */
+#if !defined(SPWFSA_RX_QUOTA)
+#define SPWFSA_RX_QUOTA             (SPWFSA_MAX_PACKETS * SPWFXX_SEND_RECV_PKTSIZE)
+#endif // !defined(SPWFSA_RX_QUOTA)
+
+/* RX scheduling weights (quantum is one module packet per weight unit) */
+#define SPWFSA_RX_WEIGHT_DEFAULT    (1)
+#define SPWFSA_RX_WEIGHT_MAX        (16)
+
+/* Max number of datagram boundaries recorded per socket */
+#if !defined(SPWFSA_PENDING_DATAGRAMS)
+#define SPWFSA_PENDING_DATAGRAMS    (13)
+#endif // !defined(SPWFSA_PENDING_DATAGRAMS)
+
+/* Pending data packets size tracking
+ * For datagram sockets the sizes of up to `SPWFSA_PENDING_DATAGRAMS` pending datagrams are recorded
+ * in a ring, so that datagram boundaries are preserved. Data of stream sockets (and of datagrams
+ * arriving while the ring is full) is only recorded cumulatively as untracked data.
+ * Sizes returned by `get()` are split into chunks of at most `SPWFXX_SEND_RECV_PKTSIZE` bytes
+ * on demand (betzw - WORK AROUND module FW issues).
+ */
 class SpwfRealPendingPackets {
 public:
     SpwfRealPendingPackets() {
         reset();
     }
 
-    void add(uint32_t new_cum_size) {
+    void add(uint32_t new_cum_size, bool datagram) {
         MBED_ASSERT(new_cum_size >= cumulative_size);
 
         if(new_cum_size == cumulative_size) {
@@ -61,18 +157,22 @@ public:
         }
 
         /* => `new_cum_size > cumulative_size` */
-        real_pkt_sizes[last_pkt_ptr] = (uint16_t)(new_cum_size - cumulative_size);
+        uint32_t size = new_cum_size - cumulative_size;
         cumulative_size = new_cum_size;
 
-        last_pkt_ptr = (last_pkt_ptr + 1) % PENDING_DATA_SLOTS;
-
-        MBED_ASSERT(first_pkt_ptr != last_pkt_ptr);
+        if(datagram && (untracked_size == 0) && (pkt_cnt < SPWFSA_PENDING_DATAGRAMS)) {
+            real_pkt_sizes[(first_pkt_ptr + pkt_cnt) % SPWFSA_PENDING_DATAGRAMS] = size;
+            pkt_cnt++;
+        } else {
+            untracked_size += size;
+        }
     }
 
     uint32_t get(void) {
-        if(empty()) return 0;
-
-        return real_pkt_sizes[first_pkt_ptr];
+        if(pkt_cnt > 0) {
+            return chunk(real_pkt_sizes[first_pkt_ptr]);
+        }
+        return chunk(untracked_size);
     }
 
     uint32_t cumulative(void) {
@@ -82,13 +182,22 @@ public:
     uint32_t remove(uint32_t size) {
         MBED_ASSERT(!empty());
 
-        uint32_t ret = real_pkt_sizes[first_pkt_ptr];
-        first_pkt_ptr = (first_pkt_ptr + 1) % PENDING_DATA_SLOTS;
+        uint32_t ret = get();
 
         MBED_ASSERT(ret == size);
         MBED_ASSERT(ret <= cumulative_size);
         cumulative_size -= ret;
 
+        if(pkt_cnt > 0) {
+            real_pkt_sizes[first_pkt_ptr] -= ret;
+            if(real_pkt_sizes[first_pkt_ptr] == 0) {
+                first_pkt_ptr = (first_pkt_ptr + 1) % SPWFSA_PENDING_DATAGRAMS;
+                pkt_cnt--;
+            }
+        } else {
+            untracked_size -= ret;
+        }
+
         return ret;
     }
 
@@ -97,20 +206,157 @@ public:
     }
 
 private:
+    static uint32_t chunk(uint32_t size) {
+        return (size > SPWFXX_SEND_RECV_PKTSIZE) ? SPWFXX_SEND_RECV_PKTSIZE : size;
+    }
+
     bool empty(void) {
-        if(first_pkt_ptr == last_pkt_ptr) {
-            MBED_ASSERT(cumulative_size == 0);
+        if(cumulative_size == 0) {
+            MBED_ASSERT((pkt_cnt == 0) && (untracked_size == 0));
             return true;
         }
         return false;
     }
 
-    uint16_t real_pkt_sizes[PENDING_DATA_SLOTS];
+    uint32_t real_pkt_sizes[SPWFSA_PENDING_DATAGRAMS];
     uint8_t  first_pkt_ptr;
-    uint8_t  last_pkt_ptr;
+    uint8_t  pkt_cnt;
+    uint32_t untracked_size;
     uint32_t cumulative_size;
 };
 
+/* Hot path AT command prefixes (same for all modules) */
+static const char SPWFXX_SEND_SOCKW[] = "AT+S.SOCKW=";
+static const char SPWFXX_SEND_SOCKR[] = "AT+S.SOCKR=";
+static const char SPWFXX_SEND_SOCKQ[] = "AT+S.SOCKQ=";
+
+#define SPWFXX_CMD_BUF_SIZE         (40)
+
+/* AT command builder for hot paths
+ *
+ * The length of the (constant) command prefix is known at compile time,
+ * decimal arguments get appended without `vsprintf()` & the command is finally sent with a single UART `write()`.
+ */
+class SpwfCmd {
+public:
+    template <size_t N>
+    explicit SpwfCmd(const char (&prefix)[N]) : _len(N - 1), _args(0) {
+        static_assert(N <= (SPWFXX_CMD_BUF_SIZE - (2 * 11) - 1), "AT command prefix too long");
+        memcpy(_buf, prefix, N - 1);
+    }
+
+    /* append decimal argument (comma separated) */
+    SpwfCmd &arg(uint32_t value) {
+        char digits[10];
+        int n = 0;
+
+        MBED_ASSERT(_args < 2); // see `SPWFXX_CMD_BUF_SIZE`
+        if(_args++ > 0) _buf[_len++] = ',';
+
+        do {
+            digits[n++] = '0' + (value % 10);
+            value /= 10;
+        } while(value != 0);
+        while(n > 0) _buf[_len++] = digits[--n];
+
+        return *this;
+    }
+
+    /* terminate command with `delim` (not included in `length()`) */
+    const char *terminate(char delim) {
+        _buf[_len] = delim;
+        _buf[_len + 1] = '\0';
+        return _buf;
+    }
+
+    size_t length(void) const {
+        return _len;
+    }
+
+private:
+    char _buf[SPWFXX_CMD_BUF_SIZE];
+    size_t _len;
+    int _args;
+};
+
+#if defined(SPWFSAXX_CMD_STATS)
+/* AT command classes for latency statistics */
+typedef enum {
+    SPWFXX_CMD_SOCKW = 0,
+    SPWFXX_CMD_SOCKR,
+    SPWFXX_CMD_SOCKQ,
+    SPWFXX_CMD_SCFG,
+    SPWFXX_CMD_STS,
+    SPWFXX_CMD_SOCKON,
+    SPWFXX_CMD_SOCKC,
+    SPWFXX_CMD_OTHER,
+    SPWFXX_CMD_CLASSES
+} spwf_cmd_class_t;
+
+/* Bucket `i` counts latencies in [2^i, 2^(i+1)) us, last bucket also all longer ones */
+#define SPWFXX_CMD_HIST_BUCKETS     (20)
+
+/* Latency statistics of an AT command class */
+typedef struct {
+    uint32_t count;
+    uint32_t total_us;
+    uint32_t max_us;
+    uint32_t hist[SPWFXX_CMD_HIST_BUCKETS];
+} spwf_cmd_stats_t;
+#endif // SPWFSAXX_CMD_STATS
+
+/* Progress of a connection attempt (as derived from the WIND stream) */
+typedef enum {
+    SPWFSA_CONNECT_IN_PROGRESS = 0, // no news (yet)
+    SPWFSA_CONNECT_ASSOCIATED,      // "+WIND:19:WiFi Join"
+    SPWFSA_CONNECT_DEAUTH_RETRY,    // "+WIND:40:Deauthentication", module retries
+    SPWFSA_CONNECT_DHCP_BOUND,      // "+WIND:24:WiFi Up" with IPv4 address
+    SPWFSA_CONNECT_FAILED
+} spwf_connect_progress_t;
+
+/* Per socket statistics */
+typedef struct {
+    uint32_t tx_bytes;
+    uint32_t tx_chunks;             // `SOCKW` commands
+    uint32_t rx_bytes;
+    uint32_t rx_chunks;             // `SOCKR` commands
+    uint32_t sockq_fallbacks;       // data read in without preceding "+WIND:55" (`SOCKQ` work around)
+    uint32_t rx_throttled;          // reads deferred due to exhausted RX quota
+    uint32_t oom_events;            // failed allocations of RX packets
+    uint32_t close_retries;
+    uint64_t blocked_us;            // time spent blocked within socket API calls (excl. waiting for data)
+} spwf_socket_stats_t;
+
+/* Interface statistics */
+typedef struct {
+    spwf_socket_stats_t sockets;    // accumulated over all (also already closed) sockets
+    uint32_t wind_pending_data;     // "+WIND:55"
+    uint32_t wind_socket_closed;    // "+WIND:58"
+    uint32_t wind_network_lost;     // "+WIND:33"
+    uint32_t wind_hard_fault;       // "+WIND:8"
+    uint32_t wind_hw_failure;       // "+WIND:5"
+    uint32_t errors;                // "ERROR" indications
+    uint32_t reconnections;         // successful re-connections after network loss
+    uint32_t winds;                 // all "+WIND" indications
+    uint32_t wind_other;            // "+WIND" indications without dedicated handler
+    uint32_t dns_cache_hits;        // host names resolved from the DNS cache
+    uint32_t dns_cache_misses;      // host names resolved by a DNS query
+    uint32_t ping_sent;             // ICMP echo requests sent by the module (see `SPWFSAxx::ping()`)
+    uint32_t ping_received;         // ICMP echo replies received
+    uint32_t ping_rtt_min_ms;       // over all replies received
+    uint32_t ping_rtt_max_ms;
+    uint32_t ping_rtt_total_ms;     // average: `ping_rtt_total_ms / ping_received`
+} spwf_stats_t;
+
+/* Result of a ping (see `SPWFSAxx::ping()`) */
+typedef struct {
+    uint32_t sent;
+    uint32_t received;              // loss: `sent - received`
+    uint32_t rtt_min_ms;            // RTT values are only valid if `received > 0`
+    uint32_t rtt_avg_ms;
+    uint32_t rtt_max_ms;
+} spwf_ping_result_t;
+
 class SpwfSAInterface;
 
 /** SPWFSAxx Interface class.
@@ -119,7 +365,7 @@ class SpwfSAInterface;
 class SPWFSAxx
 {
 private:
-    /* abstract class*/
+    /* base class of the (build time selected) module specific backend `SpwfSABackend` */
     SPWFSAxx(PinName tx, PinName rx, PinName rts, PinName cts,
              SpwfSAInterface &ifce, bool debug,
              PinName wakeup, PinName reset);
@@ -133,6 +379,101 @@ public:
      */
     bool startup(int mode);
 
+    /**
+     * Store a TLS certificate or key into the module
+     *
+     * @param kind the kind of certificate (`SPWFXX_TLS_CERT_*`)
+     * @param data PEM encoded certificate or key
+     * @param len length of `data` (in bytes)
+     * @return true only if the certificate has been stored successfully
+     */
+    bool setTlsCertificate(const char *kind, const void *data, uint32_t len);
+
+    /**
+     * Remove all TLS certificates & keys from the module
+     *
+     * @return true only if successful
+     */
+    bool clearTlsCertificates(void);
+
+    /**
+     * Perform an HTTP GET or POST request using the module's HTTP client
+     *
+     * @param host host name (or IP address) of the server
+     * @param path path (& query) of the resource
+     * @param port server port
+     * @param tls true to use HTTPS
+     * @param form URL encoded form content to POST (`NULL` for GET)
+     * @param sink called for each chunk (of at most `SPWFSA_DATA_CHUNK_SIZE` bytes) of the response body
+     * @param status set to the HTTP status code (`0` if unknown)
+     * @return number of body bytes delivered to `sink`, negative on failure (incl. `sink` having returned `false`)
+     */
+    int httpRequest(const char *host, const char *path, int port, bool tls,
+                    const char *form, spwf_data_sink_t sink, int *status);
+
+    /**
+     * Ping a host using the module's ping command
+     *
+     * @param host host name (or IP address) to ping
+     * @param count number of echo requests to send
+     * @param size payload size of the echo requests
+     * @param result set to the round trip times & number of replies
+     * @return true only if the ping command has completed (even without any reply)
+     */
+    bool ping(const char *host, int count, int size, spwf_ping_result_t *result);
+
+    /**
+     * Create a file in the module's file system
+     *
+     * @param name file name
+     * @param size (max) size of the file
+     * @return true only if successful
+     */
+    bool fileCreate(const char *name, uint32_t size);
+
+    /**
+     * Append data to a file in the module's file system
+     *
+     * @return true only if all data has been appended
+     */
+    bool fileAppend(const char *name, const void *data, uint32_t len);
+
+    /**
+     * Delete a file from the module's file system
+     *
+     * @return true only if successful
+     */
+    bool fileDelete(const char *name);
+
+    /**
+     * List the files of the module's file system
+     *
+     * @param files array to store the files in
+     * @param limit size of `files`, or 0 to only count files
+     * @return number of files (might be greater than `limit`), negative on failure
+     */
+    int fileList(spwf_file_t *files, unsigned limit);
+
+    /**
+     * Read (part of) a file from the module's file system
+     *
+     * @param name file name
+     * @param offset offset of first byte to read
+     * @param len number of bytes to read (`0`: up to the end of the file)
+     * @param sink called for each chunk (of at most `SPWFSA_DATA_CHUNK_SIZE` bytes) read
+     * @return number of bytes delivered to `sink`, negative on failure (incl. `sink` having returned `false`)
+     */
+    int fileRead(const char *name, uint32_t offset, uint32_t len, spwf_data_sink_t sink);
+
+    /**
+     * Get the firmware version of the module (as detected during `startup()`)
+     *
+     * @return null-terminated version string, empty if unknown
+     */
+    const char *getFirmwareVersion(void) {
+        return _fw_version;
+    }
+
     /**
      * Connect SPWFSAxx to AP
      *
@@ -143,6 +484,25 @@ public:
      */
     bool connect(const char *ap, const char *passPhrase, int securityMode);
 
+    /**
+     * Start connecting SPWFSAxx to AP without waiting for the result
+     *
+     * @param ap the name of the AP
+     * @param passPhrase the password of AP
+     * @param securityMode the security mode of AP (WPA/WPA2, WEP, Open)
+     * @return true only if the connection attempt has been started successfully
+     * @note progress must then be polled using `connect_progress()`
+     */
+    bool connect_start(const char *ap, const char *passPhrase, int securityMode);
+
+    /**
+     * Process (at most) one already received indication of an ongoing connection attempt
+     *
+     * @return progress of the connection attempt, `SPWFSA_CONNECT_IN_PROGRESS` if there was nothing to process
+     * @note does not block in case no data has been received from the module
+     */
+    spwf_connect_progress_t connect_progress(void);
+
     /**
      * Disconnect SPWFSAxx from AP
      *
@@ -239,11 +599,29 @@ public:
         attach(Callback<void()>(obj, method));
     }
 
+#if defined(SPWFSAXX_CMD_STATS)
+    /**
+     * Get latency statistics of an AT command class
+     *
+     * @param cmd_class AT command class
+     * @param stats destination for the statistics
+     */
+    void get_cmd_stats(spwf_cmd_class_t cmd_class, spwf_cmd_stats_t *stats);
+
+    /**
+     * Reset latency statistics of all AT command classes
+     */
+    void reset_cmd_stats(void);
+#endif // SPWFSAXX_CMD_STATS
+
     static const char _cr_ = '\x0d'; // '\r' carriage return
     static const char _lf_ = '\x0a'; // '\n' line feed
 
 private:
     UARTSerial _serial;
+#if defined(SPWFSAXX_TRACE)
+    SpwfTrace _trace;
+#endif
     ATCmdParser _parser;
 
     DigitalOut _wakeup;
@@ -256,10 +634,13 @@ private:
 
     int _pending_sockets_bitmap;
     SpwfRealPendingPackets _pending_pkt_sizes[SPWFSA_SOCKET_COUNT];
+    uint32_t _rx_buffered[SPWFSA_SOCKET_COUNT];
 
     bool _network_lost_flag;
     SpwfSAInterface &_associated_interface;
 
+    int _connect_trials;
+
     /**
      * Reset SPWFSAxx
      *
@@ -268,6 +649,13 @@ private:
     bool hw_reset(void);
     bool reset(void);
 
+    /**
+     * Put module into idle mode & reset it (without cleaning up driver state)
+     *
+     * @return true only if SPWFSAxx has been reset successfully
+     */
+    bool _leave_network(void);
+
     /**
      * Check if SPWFSAxx is connected
      *
@@ -309,18 +697,36 @@ private:
         // data follows
     } *_packets, **_packets_end;
 
-    void _packet_handler_th(void);
+    /* WINDs without dedicated handler (oldest first) */
+    struct {
+        int id;
+        char args[SPWFXX_WIND_ARGS_SIZE];
+    } _wind_queue[SPWFXX_WIND_QUEUE_LEN];
+    unsigned int _wind_queue_first;
+    unsigned int _wind_queue_cnt;
+    bool _wind_waiting;                 // `_recv_wind()` blocked on the parser
+
+    void _wind_handler(void);
+    void _wind_dispatch(char *line);
+    void _wind_enqueue(int wind_id, const char *args);
+    bool _recv_wind(int *wind_id, char *args, int size, int timeout_ms);
+    bool _wait_wind(int wind_id);
+
+    void _flush_winds(void) {
+        _wind_queue_cnt = 0;
+    }
+
+    void _packet_handler_th(char *args);
     void _execute_bottom_halves(void);
-    void _network_lost_handler_th(void);
+    void _network_lost_handler_th(char *args);
     void _network_lost_handler_bh(void);
-    void _hard_fault_handler(void);
-    void _wifi_hwfault_handler(void);
-    void _server_gone_handler(void);
-#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
-    void _skip_oob(void);
-#endif
+    void _hard_fault_handler(char *args);
+    void _wifi_hwfault_handler(char *args);
+    void _server_gone_handler(char *args);
     bool _wait_wifi_hw_started(void);
     bool _wait_console_active(void);
+    bool _probe_firmware(void);
+    spwf_connect_progress_t _connect_step(void);
     int _read_len(int);
     int _flush_in(char*, int);
     bool _winds_off(void);
@@ -333,7 +739,8 @@ private:
     void _free_all_packets(void);
     void _process_winds();
 
-    virtual int _read_in(char*, int, uint32_t) = 0;
+    /* implemented by the (build time selected) module specific backend `SpwfSABackend` */
+    int _read_in(char*, int, uint32_t);
 
     bool _recv_delim_lf(void) {
         return (_parser.getc() == _lf_);
@@ -347,13 +754,58 @@ private:
         return _recv_delim_cr() && _recv_delim_lf();
     }
 
+    /* read (remainder of) a line without `ATCmdParser::recv()` (no OOB processing!) */
+    int _recv_line(char *buf, int size);
+
+    /* scanf-free line tokenizing */
+    static int _split_fields(char *line, char sep, char *fields[], int max_fields);
+    static bool _parse_uint(const char *str, uint32_t *value);
+    static bool _parse_ipv4(const char *str, unsigned int n[4]);
+
+    /* check for a (complete) line read by `_recv_line()` to be `SPWFXX_RECV_OK` */
+    static bool _is_ok_line(const char *line) {
+        return (strncmp(line, SPWFXX_RECV_OK, sizeof(SPWFXX_RECV_OK) - 2) == 0)
+                && (line[sizeof(SPWFXX_RECV_OK) - 2] == '\0');
+    }
+
     bool _recv_ok(void) {
-        return _parser.recv(SPWFXX_RECV_OK) && _recv_delim_lf();
+        bool ret = _parser.recv(SPWFXX_RECV_OK) && _recv_delim_lf();
+#if defined(SPWFSAXX_CMD_STATS)
+        _cmd_stats_stop();
+#endif
+        return ret;
+    }
+
+    /* send AT command (all commands are sent through here) */
+    bool _send_cmd(SpwfCmd &cmd);
+    bool _send_cmd(const char *command, ...) {
+        va_list args;
+        bool ret;
+
+#if defined(SPWFSAXX_CMD_STATS)
+        _cmd_stats_start(command);
+#endif
+        va_start(args, command);
+        ret = _parser.vsend(command, args);
+        va_end(args);
+
+        return ret;
     }
 
+#if defined(SPWFSAXX_CMD_STATS)
+    spwf_cmd_stats_t _cmd_stats[SPWFXX_CMD_CLASSES];
+    spwf_cmd_class_t _cmd_class;
+    uint32_t _cmd_start_us;
+    bool _cmd_timing;
+
+    void _cmd_stats_start(const char *command);
+    void _cmd_stats_stop(void);
+#endif // SPWFSAXX_CMD_STATS
+
     void _add_pending_packet_sz(int spwf_id, uint32_t size);
+    bool _is_datagram_socket(int spwf_id);
     void _add_pending_pkt_size(int spwf_id, uint32_t size) {
-        _pending_pkt_sizes[spwf_id].add(size);
+        _pending_pkt_sizes[spwf_id].add(size, _is_datagram_socket(spwf_id));
     }
 
     uint32_t _get_cumulative_size(int spwf_id) {
@@ -389,6 +841,30 @@ private:
         else return false;
     }
 
+    bool _is_rx_throttled(int spwf_id);
+
+    /* module firmware (as detected by `_probe_firmware()`) */
+    char _fw_version[SPWFXX_FW_VERSION_SIZE];  // empty if unknown
+    uint32_t _fw_date;                          // YYMMDD, `0` if unknown
+    uint32_t _fw_features;                      // `SPWFXX_FW_FEAT_*`
+
+    bool _fw_has(uint32_t feature) {
+        return (_fw_features & feature) ? true : false;
+    }
+
+    /* driver statistics */
+    spwf_stats_t _stats;
+
+    void _socket_stat_add(int spwf_id, uint32_t spwf_socket_stats_t::*counter, uint32_t value);
+
+    /* wake up receivers blocked on socket `spwf_id` */
+    void _rx_signal(int spwf_id);
+
+    void _rx_consumed(int spwf_id, uint32_t len) {
+        MBED_ASSERT(_rx_buffered[spwf_id] >= len);
+        _rx_buffered[spwf_id] -= len;
+    }
+
     void _packet_handler_bh(void) {
         /* read in other eventually pending packages */
         _read_in_pending();
@@ -401,6 +877,7 @@ private:
 
     void _call_callback(void) {
         if((bool)_callback_func) {
+            SPWFSAXX_TRACE_EVENT(SPWF_TRACE_CALLBACK, 0);
             _callback_func();
         }
     }
@@ -436,11 +913,19 @@ private:
     char _mac_buffer[18];
 
     char _msg_buffer[256];
+    uint8_t _data_chunk[SPWFSA_DATA_CHUNK_SIZE];
+
+    int _http_recv_response(spwf_data_sink_t &sink, int *status);
+    static bool _http_content_length(char *line, uint32_t *len);
+    int _recv_data(spwf_data_sink_t &sink);
+    int _recv_data_len(spwf_data_sink_t &sink, uint32_t len);
+    int _file_list(spwf_file_t *files, unsigned limit, const char *find, uint32_t *find_size);
 
 private:
     friend class SPWFSA01;
     friend class SPWFSA04;
     friend class SpwfSAInterface;
+    friend class SpwfParserBench; // host benchmark of the WIND parsing (see `tools/host/spwf_bench.cpp`)
 };
 
 #endif // SPWFSAXX_H
@@ -43,15 +43,43 @@
 #define SYNC_HANDLER
 #endif
 
+/* Helper class to account time spent blocked within socket API calls */
+class SpwfBlockedTime {
+public:
+    SpwfBlockedTime(uint64_t &socket_us, uint64_t &ifce_us) :
+        _socket_us(socket_us), _ifce_us(ifce_us), _start_us(us_ticker_read()) {
+    }
+
+    ~SpwfBlockedTime(void) {
+        uint32_t elapsed = (uint32_t)us_ticker_read() - _start_us;
+        _socket_us += elapsed;
+        _ifce_us += elapsed;
+    }
+
+private:
+    uint64_t &_socket_us;
+    uint64_t &_ifce_us;
+    uint32_t _start_us;
+};
+
+#define BLOCKED_TIME_HANDLER(sock) SpwfBlockedTime blocked_time((sock)->stats.blocked_us, _spwf._stats.sockets.blocked_us)
+
 
 SpwfSAInterface::SpwfSAInterface(PinName tx, PinName rx,
                                  PinName rts, PinName cts, bool debug,
                                  PinName wakeup, PinName reset)
 : _spwf(tx, rx, rts, cts, *this, debug, wakeup, reset),
-  _dbg_on(debug)
+  _dbg_on(debug),
+  _blocking(true),
+  _connecting(false),
+  _conn_status(NSAPI_STATUS_DISCONNECTED),
+  _hf_recovery(false)
 {
+    memset(&_recovery_stats, 0, sizeof(_recovery_stats));
     inner_constructor();
     reset_credentials();
+
+    _dns_cache_flush();
 }
 
 nsapi_error_t SpwfSAInterface::init(void)
@@ -64,10 +92,34 @@ nsapi_error_t SpwfSAInterface::init(void)
     else return NSAPI_ERROR_DEVICE_ERROR;
 }
 
+/* Security Mode
+   None          = 0,
+   WEP           = 1,
+   WPA_Personal  = 2,
+ */
+int SpwfSAInterface::_get_security_mode(const char **pass_phrase)
+{
+    *pass_phrase = ap_pass;
+
+    switch(ap_sec)
+    {
+        case NSAPI_SECURITY_NONE:
+            *pass_phrase = NULL;
+            return 0;
+        case NSAPI_SECURITY_WEP:
+            return 1;
+        case NSAPI_SECURITY_WPA:
+        case NSAPI_SECURITY_WPA2:
+            return 2;
+        default:
+            return 2;
+    }
+}
+
 nsapi_error_t SpwfSAInterface::connect(void)
 {
     int mode;
-    char *pass_phrase = ap_pass;
+    const char *pass_phrase;
     SYNC_HANDLER;
 
     // check for valid SSID
@@ -75,24 +127,13 @@ nsapi_error_t SpwfSAInterface::connect(void)
         return NSAPI_ERROR_PARAMETER;
     }
 
-    switch(ap_sec)
-    {
-        case NSAPI_SECURITY_NONE:
-            mode = 0;
-            pass_phrase = NULL;
-            break;
-        case NSAPI_SECURITY_WEP:
-            mode = 1;
-            break;
-        case NSAPI_SECURITY_WPA:
-        case NSAPI_SECURITY_WPA2:
-            mode = 2;
-            break;
-        default:
-            mode = 2;
-            break;
+    // check for ongoing (non-blocking) connection attempt
+    if(_connecting) {
+        return NSAPI_ERROR_ALREADY;
     }
 
+    mode = _get_security_mode(&pass_phrase);
+
     // First: disconnect
     if(_connected_to_network) {
         if(!disconnect()) {
@@ -109,19 +150,114 @@ nsapi_error_t SpwfSAInterface::connect(void)
 
     // Then: (re-)connect
     _spwf.setTimeout(SPWF_CONNECT_TIMEOUT);
+    _set_connection_status(NSAPI_STATUS_CONNECTING);
+
+    if(!_blocking) {
+        if(!_spwf.connect_start(ap_ssid, pass_phrase, mode)) {
+            _set_connection_status(NSAPI_STATUS_DISCONNECTED);
+            return NSAPI_ERROR_DEVICE_ERROR;
+        }
+
+        _connect_timer.reset();
+        _connect_timer.start();
+        _connecting = true;
+
+        return NSAPI_ERROR_OK;
+    }
 
     if (!_spwf.connect(ap_ssid, pass_phrase, mode)) {
+        _set_connection_status(NSAPI_STATUS_DISCONNECTED);
         return NSAPI_ERROR_AUTH_FAILURE;
     }
 
     if (!_spwf.getIPAddress()) {
+        _set_connection_status(NSAPI_STATUS_DISCONNECTED);
         return NSAPI_ERROR_DHCP_FAILURE;
     }
 
     _connected_to_network = true;
+    _set_connection_status(NSAPI_STATUS_GLOBAL_UP);
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_connection_status_t SpwfSAInterface::process_connection(void)
+{
+    SYNC_HANDLER;
+
+    if(!_connecting) return _conn_status;
+
+    _spwf.setTimeout(SPWF_MISC_TIMEOUT);
+
+    while(_connecting) {
+        spwf_connect_progress_t progress = _spwf.connect_progress();
+
+        switch(progress) {
+            case SPWFSA_CONNECT_IN_PROGRESS:
+                if(_connect_timer.read_ms() > SPWF_CONNECT_TIMEOUT) {
+                    debug_if(_dbg_on, "\r\nSPWF> connection attempt timed out (%s, %d)\r\n", __func__, __LINE__);
+                    _spwf.setTimeout(SPWF_DISCONNECT_TIMEOUT);
+                    _spwf.disconnect();
+                    _connecting = false;
+                    _report_connect_progress(SPWFSA_CONNECT_FAILED);
+                    _set_connection_status(NSAPI_STATUS_DISCONNECTED);
+                } else if(!_spwf.readable()) {
+                    return _conn_status; // nothing more to process for now
+                }
+                break;
+            case SPWFSA_CONNECT_ASSOCIATED:
+            case SPWFSA_CONNECT_DEAUTH_RETRY:
+                _report_connect_progress(progress);
+                break;
+            case SPWFSA_CONNECT_DHCP_BOUND:
+                _connecting = false;
+                if(!_spwf.getIPAddress()) {
+                    _report_connect_progress(SPWFSA_CONNECT_FAILED);
+                    _set_connection_status(NSAPI_STATUS_DISCONNECTED);
+                } else {
+                    _connected_to_network = true;
+                    _report_connect_progress(progress);
+                    _set_connection_status(NSAPI_STATUS_GLOBAL_UP);
+                }
+                break;
+            case SPWFSA_CONNECT_FAILED:
+            default:
+                _connecting = false;
+                _report_connect_progress(SPWFSA_CONNECT_FAILED);
+                _set_connection_status(NSAPI_STATUS_DISCONNECTED);
+                break;
+        }
+    }
+
+    return _conn_status;
+}
+
+nsapi_error_t SpwfSAInterface::set_blocking(bool blocking)
+{
+    SYNC_HANDLER;
+
+    _blocking = blocking;
     return NSAPI_ERROR_OK;
 }
 
+void SpwfSAInterface::attach(mbed::Callback<void(nsapi_event_t, intptr_t)> status_cb)
+{
+    SYNC_HANDLER;
+
+    _status_cb = status_cb;
+}
+
+void SpwfSAInterface::attach_connect_progress(mbed::Callback<void(spwf_connect_progress_t)> progress_cb)
+{
+    SYNC_HANDLER;
+
+    _progress_cb = progress_cb;
+}
+
+nsapi_connection_status_t SpwfSAInterface::get_connection_status() const
+{
+    return _conn_status;
+}
+
 nsapi_error_t SpwfSAInterface::connect(const char *ssid, const char *pass, nsapi_security_t security,
                                        uint8_t channel)
 {
@@ -148,9 +284,103 @@ nsapi_error_t SpwfSAInterface::disconnect(void)
         return NSAPI_ERROR_DEVICE_ERROR;
     }
 
+    _dns_cache_flush(); // next network might resolve differently
+
     return NSAPI_ERROR_OK;
 }
 
+/* Note: the actual resolution (cache miss) is performed by the generic nsapi DNS client
+ *       (i.e. over the module's UDP sockets), without holding the driver lock */
+nsapi_error_t SpwfSAInterface::gethostbyname(const char *name, SocketAddress *address, nsapi_version_t version)
+{
+    nsapi_error_t ret;
+
+    if((name == NULL) || (address == NULL)) return NSAPI_ERROR_PARAMETER;
+
+    /* IP address literal */
+    if(address->set_ip_address(name)) {
+        if((version != NSAPI_UNSPEC) && (address->get_ip_version() != version)) {
+            return NSAPI_ERROR_DNS_FAILURE;
+        }
+        return NSAPI_ERROR_OK;
+    }
+
+#if SPWFSA_DNS_CACHE_SIZE > 0
+    if(version != NSAPI_IPv6) {
+        SYNC_HANDLER;
+
+        if(_dns_cache_lookup(name, address)) {
+            _spwf._stats.dns_cache_hits++;
+            return NSAPI_ERROR_OK;
+        }
+        _spwf._stats.dns_cache_misses++;
+    }
+#endif // SPWFSA_DNS_CACHE_SIZE > 0
+
+    ret = NetworkStack::gethostbyname(name, address, version);
+
+#if SPWFSA_DNS_CACHE_SIZE > 0
+    if((ret == NSAPI_ERROR_OK) && (address->get_ip_version() == NSAPI_IPv4)) {
+        SYNC_HANDLER;
+
+        _dns_cache_add(name, *address);
+    }
+#endif // SPWFSA_DNS_CACHE_SIZE > 0
+
+    return ret;
+}
+
+#if SPWFSA_DNS_CACHE_SIZE > 0
+bool SpwfSAInterface::_dns_cache_lookup(const char *name, SocketAddress *address)
+{
+    uint32_t now = _dns_now();
+
+    for(int i = 0; i < SPWFSA_DNS_CACHE_SIZE; i++) {
+        if((_dns_cache[i].name[0] != '\0') && (strcmp(_dns_cache[i].name, name) == 0)) {
+            if((int32_t)(_dns_cache[i].expires - now) <= 0) { // expired
+                _dns_cache[i].name[0] = '\0';
+                return false;
+            }
+            return address->set_ip_address(_dns_cache[i].addr);
+        }
+    }
+
+    return false;
+}
+
+/* Note: replaces an entry for the same name, an unused entry, or the one expiring first (in this order) */
+void SpwfSAInterface::_dns_cache_add(const char *name, const SocketAddress &address)
+{
+    uint32_t now = _dns_now();
+    int victim = 0;
+
+    if(strlen(name) >= SPWFSA_DNS_NAME_SIZE) return;
+
+    for(int i = 0; i < SPWFSA_DNS_CACHE_SIZE; i++) {
+        if(strcmp(_dns_cache[i].name, name) == 0) {
+            victim = i;
+            break;
+        }
+        if(_dns_cache[victim].name[0] == '\0') continue;
+        if((_dns_cache[i].name[0] == '\0')
+                || ((int32_t)(_dns_cache[i].expires - _dns_cache[victim].expires) < 0)) {
+            victim = i;
+        }
+    }
+
+    strcpy(_dns_cache[victim].name, name);
+    strcpy(_dns_cache[victim].addr, address.get_ip_address()); // IPv4 only (see `gethostbyname()`)
+    _dns_cache[victim].expires = now + SPWFSA_DNS_CACHE_TTL;
+}
+#endif // SPWFSA_DNS_CACHE_SIZE > 0
+
+void SpwfSAInterface::_dns_cache_flush(void)
+{
+#if SPWFSA_DNS_CACHE_SIZE > 0
+    memset(_dns_cache, 0, sizeof(_dns_cache));
+#endif
+}
+
 const char *SpwfSAInterface::get_ip_address(void)
 {
     SYNC_HANDLER;
@@ -167,6 +397,11 @@ const char *SpwfSAInterface::get_mac_address(void)
     return _spwf.getMACAddress();
 }
 
+const char *SpwfSAInterface::get_firmware_version(void)
+{
+    return _spwf.getFirmwareVersion();
+}
+
 const char *SpwfSAInterface::get_gateway(void)
 {
     SYNC_HANDLER;
@@ -206,8 +441,20 @@ nsapi_error_t SpwfSAInterface::socket_open(void **handle, nsapi_protocol_t proto
     socket->spwf_id = SPWFSA_SOCKET_COUNT;
     socket->server_gone = false;
     socket->no_more_data = false;
+    socket->connection_reset = false;
     socket->proto = proto;
     socket->addr = SocketAddress();
+    socket->rx_quota = SPWFSA_RX_QUOTA;
+    socket->rx_weight = SPWFSA_RX_WEIGHT_DEFAULT;
+    socket->rx_deficit = 0;
+    memset(&socket->stats, 0, sizeof(socket->stats));
+    socket->tls = false;
+    socket->tls_domain[0] = '\0';
+    socket->local_port = 0;
+    socket->listening = false;
+    socket->sockd_client = false;
+    socket->sockd_pending = false;
+    socket->rcv_timeout = 0;
 
     *handle = socket;
     return NSAPI_ERROR_OK;
@@ -220,18 +467,28 @@ nsapi_error_t SpwfSAInterface::socket_connect(void *handle, const SocketAddress
 
     MBED_ASSERT(((unsigned int)socket->internal_id) < ((unsigned int)SPWFSA_SOCKET_COUNT));
 
+    BLOCKED_TIME_HANDLER(socket);
+
     if(_socket_has_connected(socket->internal_id)) {
         return NSAPI_ERROR_IS_CONNECTED;
     }
 
-    _spwf.setTimeout(SPWF_OPEN_TIMEOUT);
-
-    const char *proto = (socket->proto == NSAPI_UDP) ? "u" : "t"; //"s" for secure socket?
+    _spwf.setTimeout(socket->tls ? SPWF_TLS_OPEN_TIMEOUT : SPWF_OPEN_TIMEOUT);
 
     if(addr.get_ip_version() != NSAPI_IPv4) { // IPv6 not supported (yet)
         return NSAPI_ERROR_UNSUPPORTED;
     }
 
+    MBED_ASSERT(_spwf._call_event_callback_blocked == 0);
+
+    return _socket_connect_module(socket, addr);
+}
+
+nsapi_error_t SpwfSAInterface::_socket_connect_module(spwf_socket_t *socket, const SocketAddress &addr)
+{
+    const char *proto = (socket->proto == NSAPI_UDP) ? "u" : (socket->tls ? "s" : "t");
+    const char *tls_domain = (socket->tls_domain[0] != '\0') ? socket->tls_domain : NULL;
+
     {
         BlockExecuter netsock_wa_obj(Callback<void()>(&_spwf, &SPWFSAxx::_unblock_event_callback),
                                      Callback<void()>(&_spwf, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
@@ -246,9 +503,7 @@ nsapi_error_t SpwfSAInterface::socket_connect(void *handle, const SocketAddress
             {
                 BlockExecuter winds_enabler(Callback<void()>(&_spwf, &SPWFSAxx::_winds_on));
 
-                if(!_spwf.open(proto, &socket->spwf_id, addr.get_ip_address(), addr.get_port())) {
-                    MBED_ASSERT(_spwf._call_event_callback_blocked == 1);
-
+                if(!_spwf.open(proto, &socket->spwf_id, addr.get_ip_address(), addr.get_port(), tls_domain)) {
                     return NSAPI_ERROR_DEVICE_ERROR;
                 }
 
@@ -258,14 +513,88 @@ nsapi_error_t SpwfSAInterface::socket_connect(void *handle, const SocketAddress
                 _internal_ids[socket->spwf_id] = socket->internal_id;
                 socket->addr = addr;
 
-                MBED_ASSERT(_spwf._call_event_callback_blocked == 1);
-
                 return NSAPI_ERROR_OK;
             }
         }
     }
 }
 
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+nsapi_error_t SpwfSAInterface::socket_bind(void *handle, const SocketAddress &address)
+{
+    spwf_socket_t *socket = (spwf_socket_t*)handle;
+    SYNC_HANDLER;
+
+    if(!_socket_is_open(socket)) return NSAPI_ERROR_NO_SOCKET;
+    if(socket->proto != NSAPI_TCP) return NSAPI_ERROR_UNSUPPORTED;
+    if(_socket_has_connected(socket) || socket->listening || socket->sockd_client) return NSAPI_ERROR_IS_CONNECTED;
+    if(address.get_port() == 0) return NSAPI_ERROR_PARAMETER;
+
+    socket->local_port = address.get_port();
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t SpwfSAInterface::socket_listen(void *handle, int backlog)
+{
+    spwf_socket_t *socket = (spwf_socket_t*)handle;
+    int sid;
+    SYNC_HANDLER;
+
+    CHECK_NOT_CONNECTED_ERR();
+
+    if(!_socket_is_open(socket)) return NSAPI_ERROR_NO_SOCKET;
+    if(socket->proto != NSAPI_TCP) return NSAPI_ERROR_UNSUPPORTED;
+    if(socket->listening) return NSAPI_ERROR_OK;
+    if(_socket_has_connected(socket) || socket->sockd_client) return NSAPI_ERROR_IS_CONNECTED;
+    if(socket->local_port == 0) return NSAPI_ERROR_PARAMETER;
+
+    BLOCKED_TIME_HANDLER(socket);
+
+    _spwf.setTimeout(SPWF_OPEN_TIMEOUT);
+    if(!_spwf.sockd_open("t", socket->local_port, &sid)) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    socket->sockd_sid = (int8_t)sid;
+    socket->listening = true;
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t SpwfSAInterface::socket_accept(nsapi_socket_t server, nsapi_socket_t *handle, SocketAddress *address)
+{
+    spwf_socket_t *server_socket = (spwf_socket_t*)server;
+    spwf_socket_t *socket;
+    char addr[16];
+    int cid;
+    nsapi_error_t err;
+    SYNC_HANDLER;
+
+    CHECK_NOT_CONNECTED_ERR();
+
+    if(!_socket_is_open(server_socket)) return NSAPI_ERROR_NO_SOCKET;
+    if(!server_socket->listening) return NSAPI_ERROR_PARAMETER;
+
+    /* get a socket handle first (leaving the client pending on failure) */
+    err = socket_open((void**)&socket, NSAPI_TCP);
+    if(err != NSAPI_ERROR_OK) return err;
+
+    _spwf.setTimeout(SPWF_MISC_TIMEOUT);
+    if(!_spwf.sockd_accept(server_socket->sockd_sid, &cid, addr)) {
+        _ids[socket->internal_id].internal_id = SPWFSA_SOCKET_COUNT;
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    socket->sockd_client = true;
+    socket->sockd_sid = server_socket->sockd_sid;
+    socket->sockd_cid = (int8_t)cid;
+    socket->sockd_pending = true; // data might have arrived before accepting
+    socket->addr = SocketAddress(addr, 0);
+
+    if(address != NULL) *address = socket->addr;
+    *handle = socket;
+    return NSAPI_ERROR_OK;
+}
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
 nsapi_error_t SpwfSAInterface::socket_bind(void *handle, const SocketAddress &address)
 {
     return NSAPI_ERROR_UNSUPPORTED;
@@ -280,6 +609,7 @@ nsapi_error_t SpwfSAInterface::socket_accept(nsapi_socket_t server, nsapi_socket
 {
     return NSAPI_ERROR_UNSUPPORTED;
 }
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
 
 nsapi_error_t SpwfSAInterface::socket_close(void *handle)
 {
@@ -289,6 +619,34 @@ nsapi_error_t SpwfSAInterface::socket_close(void *handle)
 
     if(!_socket_is_open(internal_id)) return NSAPI_ERROR_NO_SOCKET;
 
+    BLOCKED_TIME_HANDLER(socket);
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    if(socket->listening) {
+        _spwf.setTimeout(SPWF_CLOSE_TIMEOUT);
+        if(!_spwf.sockd_close(socket->sockd_sid)) {
+            return NSAPI_ERROR_DEVICE_ERROR;
+        }
+        socket->listening = false;
+
+        /* stopping the server disconnects all of its (accepted) clients */
+        for(int id = 0; id < SPWFSA_SOCKET_COUNT; id++) {
+            if(_socket_is_open(id) && _ids[id].sockd_client && (_ids[id].sockd_sid == socket->sockd_sid)) {
+                _ids[id].server_gone = true;
+            }
+        }
+    }
+    if(socket->sockd_client) {
+        if(!socket->server_gone) {
+            _spwf.setTimeout(SPWF_CLOSE_TIMEOUT);
+            if(!_spwf.sockd_disconnect(socket->sockd_sid, socket->sockd_cid)) {
+                return NSAPI_ERROR_DEVICE_ERROR;
+            }
+        }
+        socket->sockd_client = false;
+    }
+#endif
+
     if(_socket_has_connected(socket)) {
         _spwf.setTimeout(SPWF_CLOSE_TIMEOUT);
         if (!_spwf.close(socket->spwf_id)) {
@@ -300,6 +658,8 @@ nsapi_error_t SpwfSAInterface::socket_close(void *handle)
     _ids[internal_id].internal_id = SPWFSA_SOCKET_COUNT;
     _ids[internal_id].spwf_id = SPWFSA_SOCKET_COUNT;
 
+    _rx_signal(internal_id); // wake up receivers blocked on this socket
+
     return NSAPI_ERROR_OK;
 }
 
@@ -309,16 +669,77 @@ nsapi_size_or_error_t SpwfSAInterface::socket_send(void *handle, const void *dat
     SYNC_HANDLER;
 
     CHECK_NOT_CONNECTED_ERR();
+    CHECK_CONNECTION_RESET_ERR(socket);
+
+    BLOCKED_TIME_HANDLER(socket);
 
     _spwf.setTimeout(SPWF_SEND_TIMEOUT);
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    if(socket->sockd_client) {
+        if(socket->server_gone) return NSAPI_ERROR_CONNECTION_LOST;
+        nsapi_size_or_error_t sent = _spwf.sockd_send(socket->sockd_sid, socket->sockd_cid, data, size);
+        if(sent > 0) {
+            socket->stats.tx_bytes += sent;
+            _spwf._stats.sockets.tx_bytes += sent;
+        }
+        return sent;
+    }
+#endif
     return _spwf.send(socket->spwf_id, data, size, socket->internal_id);
 }
 
 nsapi_size_or_error_t SpwfSAInterface::socket_recv(void *handle, void *data, unsigned size)
 {
-    SYNC_HANDLER;
+    return _socket_recv_wait((spwf_socket_t*)handle, data, size, false);
+}
+
+/* Receive, waiting (max. `rcv_timeout` ms) for data if none is available
+ *
+ * Note: the driver lock is released while waiting. Blocked receivers get woken up only
+ *       by a pending data indication for (or data queued for, or a state change of) their socket,
+ *       or - one of them at a time - by UART activity, which is then processed by that receiver.
+ */
+nsapi_size_or_error_t SpwfSAInterface::_socket_recv_wait(spwf_socket_t *socket, void *data, unsigned size, bool datagram)
+{
+#if MBED_CONF_RTOS_PRESENT
+    nsapi_size_or_error_t ret;
+    int timeout, remaining;
+    uint32_t flag;
+    uint64_t start = Kernel::get_ms_count(); // Note: unlike a running `Timer` does not lock deep sleep
+
+    while(true) {
+        {
+            SYNC_HANDLER;
+
+            if(!_socket_is_open(socket)) return NSAPI_ERROR_NO_SOCKET;
+
+            BLOCKED_TIME_HANDLER(socket);
+
+            flag = 1UL << socket->internal_id;
+            _rx_flags.clear(flag);
+
+            ret = _socket_recv(socket, data, size, datagram);
+            timeout = socket->rcv_timeout;
+        }
+
+        if((ret != NSAPI_ERROR_WOULD_BLOCK) || (timeout == 0)) {
+            return ret;
+        }
+
+        if(timeout > 0) {
+            remaining = timeout - (int)(Kernel::get_ms_count() - start);
+            if(remaining <= 0) return ret;
+        } else {
+            remaining = osWaitForever;
+        }
+
+        _rx_flags.wait_any(flag | SPWFSA_RX_FLAG_UART, (uint32_t)remaining);
+    }
+#else // !MBED_CONF_RTOS_PRESENT
+    BLOCKED_TIME_HANDLER(socket);
 
-    return _socket_recv(handle, data, size, false);
+    return _socket_recv(socket, data, size, datagram);
+#endif // !MBED_CONF_RTOS_PRESENT
 }
 
 nsapi_size_or_error_t SpwfSAInterface::_socket_recv(void *handle, void *data, unsigned size, bool datagram)
@@ -326,6 +747,13 @@ nsapi_size_or_error_t SpwfSAInterface::_socket_recv(void *handle, void *data, un
     spwf_socket_t *socket = (spwf_socket_t*)handle;
 
     CHECK_NOT_CONNECTED_ERR();
+    CHECK_CONNECTION_RESET_ERR(socket);
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    if(socket->sockd_client) {
+        return _sockd_recv(socket, data, size);
+    }
+#endif
 
     if(!_socket_has_connected(socket)) {
         return NSAPI_ERROR_WOULD_BLOCK;
@@ -352,63 +780,286 @@ nsapi_size_or_error_t SpwfSAInterface::_socket_recv(void *handle, void *data, un
     return recv;
 }
 
-nsapi_size_or_error_t SpwfSAInterface::socket_sendto(void *handle, const SocketAddress &addr, const void *data, unsigned size)
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+nsapi_size_or_error_t SpwfSAInterface::_sockd_recv(spwf_socket_t *socket, void *data, unsigned size)
 {
-    spwf_socket_t *socket = (spwf_socket_t*)handle;
-    SYNC_HANDLER;
-
-    CHECK_NOT_CONNECTED_ERR();
+    nsapi_size_or_error_t recv;
 
-    if ((_socket_has_connected(socket)) && (socket->addr != addr)) {
-        _spwf.setTimeout(SPWF_CLOSE_TIMEOUT);
-        if (!_spwf.close(socket->spwf_id)) {
-            return NSAPI_ERROR_DEVICE_ERROR;
-        }
-        _internal_ids[socket->spwf_id] = SPWFSA_SOCKET_COUNT;
-        socket->spwf_id = SPWFSA_SOCKET_COUNT;
+    if(socket->no_more_data) {
+        return 0;
     }
 
-    _spwf.setTimeout(SPWF_CONN_SND_TIMEOUT);
-    if (!_socket_has_connected(socket)) {
-        nsapi_error_t err = socket_connect(socket, addr);
-        if (err < 0) {
-            return err;
-        }
+    /* without a pending data indication only query the module if WINDs might have been missed */
+    if(!socket->sockd_pending && !socket->server_gone && _spwf._fw_has(SPWFXX_FW_FEAT_WINDS_OK)) {
+        return NSAPI_ERROR_WOULD_BLOCK;
     }
 
-    return socket_send(socket, data, size);
-}
+    _spwf.setTimeout(SPWF_RECV_TIMEOUT);
+    recv = _spwf.sockd_recv(socket->sockd_sid, socket->sockd_cid, data, size);
 
-nsapi_size_or_error_t SpwfSAInterface::socket_recvfrom(void *handle, SocketAddress *addr, void *data, unsigned size)
-{
-    spwf_socket_t *socket = (spwf_socket_t*)handle;
-    nsapi_error_t ret;
-    SYNC_HANDLER;
+    if(recv > 0) {
+        socket->stats.rx_bytes += recv;
+        _spwf._stats.sockets.rx_bytes += recv;
+        return recv;
+    }
 
-    ret = _socket_recv(socket, data, size, true);
-    if (ret >= 0 && addr) {
-        *addr = socket->addr;
+    socket->sockd_pending = false;
+    if(socket->server_gone) {
+        socket->no_more_data = true;
+        return 0;
     }
 
-    return ret;
+    return (recv < 0) ? recv : NSAPI_ERROR_WOULD_BLOCK;
 }
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
 
-void SpwfSAInterface::socket_attach(void *handle, void (*callback)(void *), void *data)
+short SpwfSAInterface::_socket_poll(spwf_socket_t *socket, short events)
 {
-    spwf_socket_t *socket = (spwf_socket_t*)handle;
-    SYNC_HANDLER;
+    short revents = 0;
+    bool readable = false;
+    bool connected;
 
-    if(!_socket_is_open(socket)) return; // might happen e.g. after module hard fault or voluntary disconnection
+    if(!_socket_is_open(socket)) return SPWFSA_POLL_HUP;
 
-    _cbs[socket->internal_id].callback = callback;
-    _cbs[socket->internal_id].data = data;
-}
+    connected = _socket_has_connected(socket);
 
-void SpwfSAInterface::event(void) {
-    for (int internal_id = 0; internal_id < SPWFSA_SOCKET_COUNT; internal_id++) {
-        if (_cbs[internal_id].callback && (_ids[internal_id].internal_id != SPWFSA_SOCKET_COUNT)) {
-            _cbs[internal_id].callback(_cbs[internal_id].data);
-        }
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    if(socket->listening) {
+        readable = _spwf._sockd_has_client(socket->sockd_sid);
+    } else if(socket->sockd_client) {
+        connected = true;
+        readable = socket->sockd_pending;
+    }
+#endif
+
+    if(connected && !socket->sockd_client) {
+        readable = (_spwf._rx_buffered[socket->spwf_id] > 0) || _spwf._is_data_pending(socket->spwf_id);
+    }
+
+    if(connected && (!_connected_to_network || socket->server_gone || socket->no_more_data)) {
+        revents |= (SPWFSA_POLL_HUP | SPWFSA_POLL_IN); // receiving does not block (returns remaining data or `0`)
+    } else if(socket->connection_reset) {
+        revents |= (SPWFSA_POLL_HUP | SPWFSA_POLL_IN); // receiving reports `NSAPI_ERROR_CONNECTION_LOST`
+    } else {
+        if(readable) revents |= SPWFSA_POLL_IN;
+        if(connected && !socket->listening) revents |= SPWFSA_POLL_OUT;
+    }
+
+    return revents & (events | SPWFSA_POLL_HUP);
+}
+
+nsapi_size_or_error_t SpwfSAInterface::poll(spwf_pollfd_t *fds, unsigned nfds, int timeout)
+{
+    nsapi_size_or_error_t ready;
+#if MBED_CONF_RTOS_PRESENT
+    uint32_t flags;
+    int remaining;
+    uint64_t start = (timeout > 0) ? Kernel::get_ms_count() : 0;
+#endif
+
+    if((fds == NULL) && (nfds > 0)) return NSAPI_ERROR_PARAMETER;
+
+    while(true) {
+        {
+            SYNC_HANDLER;
+
+            ready = 0;
+#if MBED_CONF_RTOS_PRESENT
+            flags = SPWFSA_RX_FLAG_UART;
+#endif
+            if(_spwf.readable()) {
+                BlockExecuter netsock_wa_obj(Callback<void()>(&_spwf, &SPWFSAxx::_unblock_event_callback),
+                                             Callback<void()>(&_spwf, &SPWFSAxx::_block_event_callback)); /* disable calling (external) callback in IRQ context */
+                BlockExecuter bh_handler(Callback<void()>(&_spwf, &SPWFSAxx::_execute_bottom_halves));
+
+                _spwf._process_winds(); // perform async indication handling
+            }
+
+            for(unsigned i = 0; i < nfds; i++) {
+                spwf_socket_t *socket = (spwf_socket_t*)fds[i].handle;
+
+                fds[i].revents = _socket_poll(socket, fds[i].events);
+                if(fds[i].revents != 0) ready++;
+#if MBED_CONF_RTOS_PRESENT
+                if(_socket_is_open(socket)) flags |= (1UL << socket->internal_id);
+#endif
+            }
+        }
+
+        if((ready > 0) || (timeout == 0)) {
+            return ready;
+        }
+
+#if MBED_CONF_RTOS_PRESENT
+        if(timeout > 0) {
+            remaining = timeout - (int)(Kernel::get_ms_count() - start);
+            if(remaining <= 0) return ready;
+        } else {
+            remaining = osWaitForever;
+        }
+
+        _rx_flags.wait_any(flags, (uint32_t)remaining);
+#else // !MBED_CONF_RTOS_PRESENT
+        return ready; // cannot wait
+#endif // !MBED_CONF_RTOS_PRESENT
+    }
+}
+
+nsapi_size_or_error_t SpwfSAInterface::socket_sendto(void *handle, const SocketAddress &addr, const void *data, unsigned size)
+{
+    spwf_socket_t *socket = (spwf_socket_t*)handle;
+    SYNC_HANDLER;
+
+    CHECK_NOT_CONNECTED_ERR();
+
+    if ((_socket_has_connected(socket)) && (socket->addr != addr)) {
+        _spwf.setTimeout(SPWF_CLOSE_TIMEOUT);
+        if (!_spwf.close(socket->spwf_id)) {
+            return NSAPI_ERROR_DEVICE_ERROR;
+        }
+        _internal_ids[socket->spwf_id] = SPWFSA_SOCKET_COUNT;
+        socket->spwf_id = SPWFSA_SOCKET_COUNT;
+    }
+
+    _spwf.setTimeout(SPWF_CONN_SND_TIMEOUT);
+    if (!_socket_has_connected(socket)) {
+        nsapi_error_t err = socket_connect(socket, addr);
+        if (err < 0) {
+            return err;
+        }
+    }
+
+    return socket_send(socket, data, size);
+}
+
+nsapi_size_or_error_t SpwfSAInterface::socket_recvfrom(void *handle, SocketAddress *addr, void *data, unsigned size)
+{
+    spwf_socket_t *socket = (spwf_socket_t*)handle;
+    nsapi_error_t ret;
+
+    ret = _socket_recv_wait(socket, data, size, true);
+    if (ret >= 0 && addr) {
+        SYNC_HANDLER;
+        *addr = socket->addr;
+    }
+
+    return ret;
+}
+
+nsapi_error_t SpwfSAInterface::setsockopt(nsapi_socket_t handle, int level,
+                                          int optname, const void *optval, unsigned optlen)
+{
+    spwf_socket_t *socket = (spwf_socket_t*)handle;
+    int value;
+    SYNC_HANDLER;
+
+    if(!_socket_is_open(socket)) return NSAPI_ERROR_NO_SOCKET;
+
+    if((level == SPWFSA_SOCKOPT_LEVEL) && (optname == SPWFSA_SOCKOPT_TLS_DOMAIN)) {
+        if((optval == NULL) || (optlen >= sizeof(socket->tls_domain))) return NSAPI_ERROR_PARAMETER;
+        if(_socket_has_connected(socket)) return NSAPI_ERROR_IS_CONNECTED;
+
+        /* becomes part of the comma separated `AT+S.SOCKON` arguments */
+        for(unsigned i = 0; i < optlen; i++) {
+            uint8_t c = ((const uint8_t*)optval)[i];
+            if((c == ',') || (c < ' ') || (c == 0x7F)) return NSAPI_ERROR_PARAMETER;
+        }
+
+        memcpy(socket->tls_domain, optval, optlen);
+        socket->tls_domain[optlen] = '\0';
+        return NSAPI_ERROR_OK;
+    }
+
+    if((optval == NULL) || (optlen != sizeof(int))) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+    value = *(const int*)optval;
+
+    if((level == NSAPI_SOCKET) && (optname == NSAPI_RCVBUF)) {
+        if(value <= 0) return NSAPI_ERROR_PARAMETER;
+        socket->rx_quota = (uint32_t)value;
+    } else if((level == SPWFSA_SOCKOPT_LEVEL) && (optname == SPWFSA_SOCKOPT_RX_WEIGHT)) {
+        if((value < 1) || (value > SPWFSA_RX_WEIGHT_MAX)) return NSAPI_ERROR_PARAMETER;
+        socket->rx_weight = (uint32_t)value;
+    } else if((level == SPWFSA_SOCKOPT_LEVEL) && (optname == SPWFSA_SOCKOPT_STATS_RESET)) {
+        memset(&socket->stats, 0, sizeof(socket->stats));
+    } else if((level == SPWFSA_SOCKOPT_LEVEL) && (optname == SPWFSA_SOCKOPT_RCVTIMEO)) {
+#if MBED_CONF_RTOS_PRESENT
+        if(value < -1) return NSAPI_ERROR_PARAMETER;
+        socket->rcv_timeout = value;
+#else
+        if(value != 0) return NSAPI_ERROR_UNSUPPORTED;
+#endif
+    } else if((level == SPWFSA_SOCKOPT_LEVEL) && (optname == SPWFSA_SOCKOPT_TLS)) {
+        if(socket->proto != NSAPI_TCP) return NSAPI_ERROR_UNSUPPORTED;
+        if(_socket_has_connected(socket)) return NSAPI_ERROR_IS_CONNECTED;
+        socket->tls = (value != 0);
+    } else {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t SpwfSAInterface::getsockopt(nsapi_socket_t handle, int level,
+                                          int optname, void *optval, unsigned *optlen)
+{
+    spwf_socket_t *socket = (spwf_socket_t*)handle;
+    SYNC_HANDLER;
+
+    if(!_socket_is_open(socket)) return NSAPI_ERROR_NO_SOCKET;
+
+    if((optval == NULL) || (optlen == NULL)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    if((level == SPWFSA_SOCKOPT_LEVEL) && (optname == SPWFSA_SOCKOPT_STATS)) {
+        if(*optlen < sizeof(spwf_socket_stats_t)) return NSAPI_ERROR_PARAMETER;
+
+        memcpy(optval, &socket->stats, sizeof(spwf_socket_stats_t));
+        *optlen = sizeof(spwf_socket_stats_t);
+        return NSAPI_ERROR_OK;
+    }
+
+    if(*optlen < sizeof(int)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    if((level == NSAPI_SOCKET) && (optname == NSAPI_RCVBUF)) {
+        *(int*)optval = (int)socket->rx_quota;
+    } else if((level == SPWFSA_SOCKOPT_LEVEL) && (optname == SPWFSA_SOCKOPT_RX_WEIGHT)) {
+        *(int*)optval = (int)socket->rx_weight;
+    } else if((level == SPWFSA_SOCKOPT_LEVEL) && (optname == SPWFSA_SOCKOPT_TLS)) {
+        *(int*)optval = socket->tls ? 1 : 0;
+    } else if((level == SPWFSA_SOCKOPT_LEVEL) && (optname == SPWFSA_SOCKOPT_RCVTIMEO)) {
+        *(int*)optval = socket->rcv_timeout;
+    } else {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    *optlen = sizeof(int);
+    return NSAPI_ERROR_OK;
+}
+
+void SpwfSAInterface::socket_attach(void *handle, void (*callback)(void *), void *data)
+{
+    spwf_socket_t *socket = (spwf_socket_t*)handle;
+    SYNC_HANDLER;
+
+    if(!_socket_is_open(socket)) return; // might happen e.g. after module hard fault or voluntary disconnection
+
+    _cbs[socket->internal_id].callback = callback;
+    _cbs[socket->internal_id].data = data;
+}
+
+void SpwfSAInterface::event(void) {
+    for (int internal_id = 0; internal_id < SPWFSA_SOCKET_COUNT; internal_id++) {
+        if (_cbs[internal_id].callback && (_ids[internal_id].internal_id != SPWFSA_SOCKET_COUNT)) {
+            _cbs[internal_id].callback(_cbs[internal_id].data);
+        }
+    }
+    if (_ws_callback) {
+        _ws_callback();
     }
 }
 
@@ -499,6 +1150,674 @@ nsapi_size_or_error_t SpwfSAInterface::scan(WiFiAccessPoint *res, unsigned count
     return ret;
 }
 
+void SpwfSAInterface::set_hard_fault_recovery(bool enable)
+{
+    SYNC_HANDLER;
+
+    _hf_recovery = enable;
+}
+
+void SpwfSAInterface::get_recovery_stats(spwf_recovery_stats_t *stats)
+{
+    SYNC_HANDLER;
+
+    *stats = _recovery_stats;
+}
+
+void SpwfSAInterface::get_stats(spwf_stats_t *stats)
+{
+    SYNC_HANDLER;
+
+    *stats = _spwf._stats;
+}
+
+void SpwfSAInterface::reset_stats(void)
+{
+    SYNC_HANDLER;
+
+    memset(&_spwf._stats, 0, sizeof(_spwf._stats));
+}
+
+nsapi_error_t SpwfSAInterface::ping(const char *host, int count, spwf_ping_result_t *result, int size)
+{
+    spwf_ping_result_t res;
+
+    SYNC_HANDLER;
+
+    if((host == NULL) || (count <= 0) || (size < 0)) return NSAPI_ERROR_PARAMETER;
+    if(!_connected_to_network) return NSAPI_ERROR_NO_CONNECTION;
+
+    _spwf.setTimeout(SPWF_PING_TIMEOUT);
+    if(!_spwf.ping(host, count, size, &res)) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    if(result != NULL) *result = res;
+
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t SpwfSAInterface::set_tls_certificate(spwf_tls_cert_t kind, const char *pem, size_t len)
+{
+    static const char *const kinds[] = { SPWFXX_TLS_CERT_CA, SPWFXX_TLS_CERT_CLIENT, SPWFXX_TLS_CERT_KEY };
+    SYNC_HANDLER;
+
+    if((((unsigned int)kind) >= (sizeof(kinds) / sizeof(kinds[0]))) || (pem == NULL) || (len == 0)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    //initialize the device before storing certificates
+    if(!_isInitialized)
+    {
+        if(init() != NSAPI_ERROR_OK) return NSAPI_ERROR_DEVICE_ERROR;
+        _isInitialized=true; // avoid factory reset by next `connect()`
+    }
+
+    _spwf.setTimeout(SPWF_TLS_CERT_TIMEOUT);
+    if(!_spwf.setTlsCertificate(kinds[kind], pem, len)) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t SpwfSAInterface::clear_tls_certificates(void)
+{
+    SYNC_HANDLER;
+
+    //initialize the device before removing certificates
+    if(!_isInitialized)
+    {
+        if(init() != NSAPI_ERROR_OK) return NSAPI_ERROR_DEVICE_ERROR;
+        _isInitialized=true; // avoid factory reset by next `connect()`
+    }
+
+    _spwf.setTimeout(SPWF_TLS_CERT_TIMEOUT);
+    if(!_spwf.clearTlsCertificates()) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_size_or_error_t SpwfSAInterface::http_get(const char *host, const char *path, spwf_data_sink_t sink,
+                                                int *status, int port, bool tls)
+{
+    return _http_request(host, path, NULL, sink, status, port, tls);
+}
+
+nsapi_size_or_error_t SpwfSAInterface::http_get(const char *host, const char *path, FileHandle *file,
+                                                int *status, int port, bool tls)
+{
+    if(file == NULL) return NSAPI_ERROR_PARAMETER;
+    return _http_request(host, path, NULL, spwf_data_sink_t(file, &SpwfSAInterface::_http_file_sink), status, port, tls);
+}
+
+nsapi_size_or_error_t SpwfSAInterface::http_post(const char *host, const char *path, const char *form, spwf_data_sink_t sink,
+                                                 int *status, int port, bool tls)
+{
+    if(form == NULL) return NSAPI_ERROR_PARAMETER;
+    return _http_request(host, path, form, sink, status, port, tls);
+}
+
+nsapi_size_or_error_t SpwfSAInterface::http_post(const char *host, const char *path, const char *form, FileHandle *file,
+                                                 int *status, int port, bool tls)
+{
+    if((form == NULL) || (file == NULL)) return NSAPI_ERROR_PARAMETER;
+    return _http_request(host, path, form, spwf_data_sink_t(file, &SpwfSAInterface::_http_file_sink), status, port, tls);
+}
+
+bool SpwfSAInterface::_http_file_sink(FileHandle *file, const void *data, size_t len)
+{
+    return (file->write(data, len) == (ssize_t)len);
+}
+
+nsapi_size_or_error_t SpwfSAInterface::_http_request(const char *host, const char *path, const char *form,
+                                                     spwf_data_sink_t sink, int *status, int port, bool tls)
+{
+    int http_status;
+    int ret;
+
+    SYNC_HANDLER;
+
+    if((host == NULL) || (path == NULL) || !sink) return NSAPI_ERROR_PARAMETER;
+    if(!_connected_to_network) return NSAPI_ERROR_NO_CONNECTION;
+
+    if(port == 0) port = tls ? 443 : 80;
+
+    _spwf.setTimeout(SPWF_HTTP_TIMEOUT);
+    ret = _spwf.httpRequest(host, path, port, tls, form, sink, &http_status);
+
+    if(status != NULL) *status = http_status;
+
+    return (ret < 0) ? NSAPI_ERROR_DEVICE_ERROR : ret;
+}
+
+nsapi_error_t SpwfSAInterface::http_get_to_fs(const char *host, const char *path, const char *file,
+                                              int *status, int port, bool tls)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    int http_status;
+    bool ret;
+
+    SYNC_HANDLER;
+
+    if((host == NULL) || (path == NULL) || (file == NULL)) return NSAPI_ERROR_PARAMETER;
+    if(!_connected_to_network) return NSAPI_ERROR_NO_CONNECTION;
+
+    if(port == 0) port = tls ? 443 : 80;
+
+    _spwf.setTimeout(SPWF_HTTP_TIMEOUT);
+    ret = _spwf.httpGetToFile(host, path, port, tls, file, &http_status);
+
+    if(status != NULL) *status = http_status;
+
+    return ret ? NSAPI_ERROR_OK : NSAPI_ERROR_DEVICE_ERROR;
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+}
+
+/* Note: must be called with the driver locked */
+bool SpwfSAInterface::_fs_prepare(void)
+{
+    //initialize the device before accessing its file system
+    if(!_isInitialized)
+    {
+        if(init() != NSAPI_ERROR_OK) return false;
+        _isInitialized=true; // avoid factory reset by next `connect()`
+    }
+
+    _spwf.setTimeout(SPWF_FS_TIMEOUT);
+    return true;
+}
+
+nsapi_error_t SpwfSAInterface::fs_create(const char *name, unsigned size)
+{
+    SYNC_HANDLER;
+
+    if(name == NULL) return NSAPI_ERROR_PARAMETER;
+    if(!_fs_prepare()) return NSAPI_ERROR_DEVICE_ERROR;
+
+    return _spwf.fileCreate(name, size) ? NSAPI_ERROR_OK : NSAPI_ERROR_DEVICE_ERROR;
+}
+
+nsapi_error_t SpwfSAInterface::fs_append(const char *name, const void *data, unsigned len)
+{
+    SYNC_HANDLER;
+
+    if((name == NULL) || ((data == NULL) && (len > 0))) return NSAPI_ERROR_PARAMETER;
+    if(!_fs_prepare()) return NSAPI_ERROR_DEVICE_ERROR;
+
+    return _spwf.fileAppend(name, data, len) ? NSAPI_ERROR_OK : NSAPI_ERROR_DEVICE_ERROR;
+}
+
+nsapi_error_t SpwfSAInterface::fs_delete(const char *name)
+{
+    SYNC_HANDLER;
+
+    if(name == NULL) return NSAPI_ERROR_PARAMETER;
+    if(!_fs_prepare()) return NSAPI_ERROR_DEVICE_ERROR;
+
+    return _spwf.fileDelete(name) ? NSAPI_ERROR_OK : NSAPI_ERROR_DEVICE_ERROR;
+}
+
+nsapi_size_or_error_t SpwfSAInterface::fs_list(spwf_file_t *files, unsigned limit)
+{
+    int ret;
+
+    SYNC_HANDLER;
+
+    if((files == NULL) && (limit > 0)) return NSAPI_ERROR_PARAMETER;
+    if(!_fs_prepare()) return NSAPI_ERROR_DEVICE_ERROR;
+
+    ret = _spwf.fileList(files, limit);
+    return (ret < 0) ? NSAPI_ERROR_DEVICE_ERROR : ret;
+}
+
+nsapi_size_or_error_t SpwfSAInterface::fs_read(const char *name, spwf_data_sink_t sink, unsigned offset, unsigned len)
+{
+    int ret;
+
+    SYNC_HANDLER;
+
+    if((name == NULL) || !sink) return NSAPI_ERROR_PARAMETER;
+    if(!_fs_prepare()) return NSAPI_ERROR_DEVICE_ERROR;
+
+    ret = _spwf.fileRead(name, offset, len, sink);
+    return (ret < 0) ? NSAPI_ERROR_DEVICE_ERROR : ret;
+}
+
+/* Destination of `SpwfSAInterface::fs_read()` into a buffer */
+typedef struct {
+    uint8_t *buf;
+    size_t left;
+} spwf_buf_sink_t;
+
+static bool spwf_buf_sink(spwf_buf_sink_t *dst, const void *data, size_t len)
+{
+    if(len > dst->left) return false;
+
+    memcpy(dst->buf, data, len);
+    dst->buf += len;
+    dst->left -= len;
+    return true;
+}
+
+nsapi_size_or_error_t SpwfSAInterface::fs_read(const char *name, void *buf, unsigned size, unsigned offset)
+{
+    spwf_buf_sink_t dst = { (uint8_t*)buf, size };
+
+    if((buf == NULL) || (size == 0)) return NSAPI_ERROR_PARAMETER;
+
+    return fs_read(name, spwf_data_sink_t(&dst, spwf_buf_sink), offset, size);
+}
+
+nsapi_error_t SpwfSAInterface::ws_open(const char *host, const char *path, int *ws_id, int port, bool tls)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    SYNC_HANDLER;
+
+    if((host == NULL) || (path == NULL) || (ws_id == NULL)) return NSAPI_ERROR_PARAMETER;
+    if(!_connected_to_network) return NSAPI_ERROR_NO_CONNECTION;
+
+    if(port == 0) port = tls ? 443 : 80;
+
+    _spwf.setTimeout(tls ? SPWF_TLS_OPEN_TIMEOUT : SPWF_OPEN_TIMEOUT);
+    if(!_spwf.wsock_open(host, port, path, tls, ws_id)) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    return NSAPI_ERROR_OK;
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+}
+
+nsapi_error_t SpwfSAInterface::ws_close(int ws_id)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    SYNC_HANDLER;
+
+    if(((unsigned int)ws_id) >= ((unsigned int)SPWFSA_WSOCK_COUNT)) return NSAPI_ERROR_PARAMETER;
+
+    _spwf.setTimeout(SPWF_CLOSE_TIMEOUT);
+    if(!_spwf.wsock_close(ws_id)) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    return NSAPI_ERROR_OK;
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+}
+
+nsapi_size_or_error_t SpwfSAInterface::ws_send(int ws_id, const void *data, unsigned size)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    SYNC_HANDLER;
+
+    if(((unsigned int)ws_id) >= ((unsigned int)SPWFSA_WSOCK_COUNT)) return NSAPI_ERROR_PARAMETER;
+    if((data == NULL) && (size > 0)) return NSAPI_ERROR_PARAMETER;
+
+    _spwf.setTimeout(SPWF_SEND_TIMEOUT);
+    return _spwf.wsock_send(ws_id, data, size);
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+}
+
+nsapi_size_or_error_t SpwfSAInterface::ws_recv(int ws_id, void *data, unsigned size)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    SYNC_HANDLER;
+
+    if(((unsigned int)ws_id) >= ((unsigned int)SPWFSA_WSOCK_COUNT)) return NSAPI_ERROR_PARAMETER;
+    if((data == NULL) && (size > 0)) return NSAPI_ERROR_PARAMETER;
+
+    _spwf.setTimeout(SPWF_RECV_TIMEOUT);
+    return _spwf.wsock_recv(ws_id, data, size);
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+}
+
+void SpwfSAInterface::ws_attach(Callback<void()> func)
+{
+    SYNC_HANDLER;
+
+    _ws_callback = func;
+}
+
+nsapi_error_t SpwfSAInterface::mqtt_connect(const char *host, const char *client_id, int *mqtt_id, int port, bool tls,
+                                            const char *user, const char *pass, int keepalive)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    SYNC_HANDLER;
+
+    if((host == NULL) || (client_id == NULL) || (mqtt_id == NULL)) return NSAPI_ERROR_PARAMETER;
+    if(!_connected_to_network) return NSAPI_ERROR_NO_CONNECTION;
+
+    if(port == 0) port = tls ? 8883 : 1883;
+
+    _spwf.setTimeout(tls ? SPWF_TLS_OPEN_TIMEOUT : SPWF_OPEN_TIMEOUT);
+    if(!_spwf.mqtt_connect(host, port, tls, user, pass, client_id, keepalive, mqtt_id)) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    return NSAPI_ERROR_OK;
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+}
+
+nsapi_error_t SpwfSAInterface::mqtt_disconnect(int mqtt_id)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    SYNC_HANDLER;
+
+    if(((unsigned int)mqtt_id) >= ((unsigned int)SPWFSA_MQTT_COUNT)) return NSAPI_ERROR_PARAMETER;
+
+    _spwf.setTimeout(SPWF_CLOSE_TIMEOUT);
+    if(!_spwf.mqtt_disconnect(mqtt_id)) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    return NSAPI_ERROR_OK;
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+}
+
+nsapi_error_t SpwfSAInterface::mqtt_publish(int mqtt_id, const char *topic, const void *payload, unsigned len,
+                                            int qos, bool retain)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    SYNC_HANDLER;
+
+    if(((unsigned int)mqtt_id) >= ((unsigned int)SPWFSA_MQTT_COUNT)) return NSAPI_ERROR_PARAMETER;
+    if((topic == NULL) || ((payload == NULL) && (len > 0))) return NSAPI_ERROR_PARAMETER;
+    if((len > SPWFXX_SEND_RECV_PKTSIZE) || (((unsigned int)qos) > 2)) return NSAPI_ERROR_PARAMETER;
+    if(!_spwf.mqtt_is_connected(mqtt_id)) return NSAPI_ERROR_CONNECTION_LOST;
+
+    _spwf.setTimeout(SPWF_SEND_TIMEOUT);
+    if(!_spwf.mqtt_publish(mqtt_id, topic, payload, len, qos, retain)) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    return NSAPI_ERROR_OK;
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+}
+
+nsapi_error_t SpwfSAInterface::mqtt_subscribe(int mqtt_id, const char *topic, int qos)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    SYNC_HANDLER;
+
+    if(((unsigned int)mqtt_id) >= ((unsigned int)SPWFSA_MQTT_COUNT)) return NSAPI_ERROR_PARAMETER;
+    if((topic == NULL) || (((unsigned int)qos) > 2)) return NSAPI_ERROR_PARAMETER;
+    if(!_spwf.mqtt_is_connected(mqtt_id)) return NSAPI_ERROR_CONNECTION_LOST;
+
+    _spwf.setTimeout(SPWF_SEND_TIMEOUT);
+    if(!_spwf.mqtt_subscribe(mqtt_id, topic, qos, true)) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    return NSAPI_ERROR_OK;
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+}
+
+nsapi_error_t SpwfSAInterface::mqtt_unsubscribe(int mqtt_id, const char *topic)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    SYNC_HANDLER;
+
+    if(((unsigned int)mqtt_id) >= ((unsigned int)SPWFSA_MQTT_COUNT)) return NSAPI_ERROR_PARAMETER;
+    if(topic == NULL) return NSAPI_ERROR_PARAMETER;
+    if(!_spwf.mqtt_is_connected(mqtt_id)) return NSAPI_ERROR_CONNECTION_LOST;
+
+    _spwf.setTimeout(SPWF_SEND_TIMEOUT);
+    if(!_spwf.mqtt_subscribe(mqtt_id, topic, 0, false)) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    return NSAPI_ERROR_OK;
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+}
+
+nsapi_error_t SpwfSAInterface::mqtt_ping(int mqtt_id)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    SYNC_HANDLER;
+
+    if(((unsigned int)mqtt_id) >= ((unsigned int)SPWFSA_MQTT_COUNT)) return NSAPI_ERROR_PARAMETER;
+    if(!_spwf.mqtt_is_connected(mqtt_id)) return NSAPI_ERROR_CONNECTION_LOST;
+
+    _spwf.setTimeout(SPWF_SEND_TIMEOUT);
+    if(!_spwf.mqtt_ping(mqtt_id)) {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    return NSAPI_ERROR_OK;
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD != IDW04A1
+}
+
+void SpwfSAInterface::mqtt_attach(spwf_mqtt_cb_t func)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    SYNC_HANDLER;
+
+    _spwf.mqtt_attach(func);
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+}
+
+/*
+ * Called after module hard fault (from within OOB handling)
+ *
+ * Note: returns `false` if session-preserving recovery is disabled or has failed,
+ *       in which case caller is responsible for cleaning up state (i.e. `SPWFSAxx::disconnect()`)
+ */
+bool SpwfSAInterface::_recover_sessions(void)
+{
+    bool had_connected[SPWFSA_SOCKET_COUNT];
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    bool had_listening[SPWFSA_SOCKET_COUNT];
+#endif
+    bool was_connected = _connected_to_network;
+    Timer timer;
+
+    _recovery_stats.hard_faults++;
+
+    if(!_hf_recovery) return false;
+
+    timer.start();
+
+    /* data buffered on host & pending data sizes refer to the old module sockets */
+    _spwf._free_all_packets();
+    for (int spwf_id = 0; spwf_id < SPWFSA_SOCKET_COUNT; spwf_id++) {
+        _spwf._clear_pending_data(spwf_id);
+        _spwf._reset_pending_pkt_sizes(spwf_id);
+        _internal_ids[spwf_id] = SPWFSA_SOCKET_COUNT;
+    }
+
+    /* record which sockets need to be re-opened (protocol & peer address are kept in `_ids`) */
+    for (int internal_id = 0; internal_id < SPWFSA_SOCKET_COUNT; internal_id++) {
+        had_connected[internal_id] = _socket_has_connected(internal_id);
+        _ids[internal_id].spwf_id = SPWFSA_SOCKET_COUNT;
+    }
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    /* the module has stopped all socket servers & dropped their (accepted or not) clients */
+    _spwf._sockd_reset();
+    for (int internal_id = 0; internal_id < SPWFSA_SOCKET_COUNT; internal_id++) {
+        if(!_socket_is_open(internal_id)) {
+            had_listening[internal_id] = false;
+            continue;
+        }
+
+        had_listening[internal_id] = _ids[internal_id].listening;
+        _ids[internal_id].listening = false;
+        if(_ids[internal_id].sockd_client) {
+            _ids[internal_id].server_gone = true;
+        }
+    }
+
+    /* the module has dropped all WebSocket connections (including messages not yet read) */
+    _spwf._wsock_lost();
+
+    /* the module has dropped all MQTT connections (further operations report a lost connection) */
+    _spwf._mqtt_reset();
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+
+    _connected_to_network = false;
+
+    if(!_spwf._leave_network()) {
+        goto recovery_failed;
+    }
+
+    if(was_connected) {
+        const char *pass_phrase;
+        int mode = _get_security_mode(&pass_phrase);
+
+        _set_connection_status(NSAPI_STATUS_CONNECTING);
+
+        _spwf.setTimeout(SPWF_CONNECT_TIMEOUT);
+        if(!(_spwf.connect(ap_ssid, pass_phrase, mode) && _spwf.getIPAddress())) {
+            goto recovery_failed;
+        }
+
+        _connected_to_network = true;
+        _set_connection_status(NSAPI_STATUS_GLOBAL_UP);
+
+        _spwf.setTimeout(SPWF_OPEN_TIMEOUT);
+        for (int internal_id = 0; internal_id < SPWFSA_SOCKET_COUNT; internal_id++) {
+            if(!had_connected[internal_id]) continue;
+
+            spwf_socket_t &sock = _ids[internal_id];
+            SocketAddress addr = sock.addr;
+
+            if(_socket_connect_module(&sock, addr) != NSAPI_ERROR_OK) {
+                debug_if(_dbg_on, "\r\nSPWF> re-opening socket %d failed (%s, %d)\r\n", internal_id, __func__, __LINE__);
+                sock.spwf_id = SPWFSA_SOCKET_COUNT;
+                sock.no_more_data = true;
+                continue;
+            }
+
+            sock.server_gone = false;
+            sock.no_more_data = false;
+            sock.connection_reset = (sock.proto == NSAPI_TCP);
+        }
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+        /* restart socket servers (on possibly different module server ids) */
+        for (int internal_id = 0; internal_id < SPWFSA_SOCKET_COUNT; internal_id++) {
+            if(!had_listening[internal_id]) continue;
+
+            spwf_socket_t &sock = _ids[internal_id];
+            int sid;
+
+            if(!_spwf.sockd_open("t", sock.local_port, &sid)) {
+                debug_if(_dbg_on, "\r\nSPWF> restarting socket server %d failed (%s, %d)\r\n", internal_id, __func__, __LINE__);
+                continue;
+            }
+
+            sock.sockd_sid = (int8_t)sid;
+            sock.listening = true;
+            had_listening[internal_id] = false;
+        }
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    }
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    /* socket servers which could not be restarted */
+    for (int internal_id = 0; internal_id < SPWFSA_SOCKET_COUNT; internal_id++) {
+        if(had_listening[internal_id]) {
+            _ids[internal_id].connection_reset = true;
+        }
+    }
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+
+    timer.stop();
+    _recovery_stats.recoveries++;
+    _recovery_stats.last_recovery_ms = timer.read_ms();
+    _recovery_stats.total_recovery_ms += _recovery_stats.last_recovery_ms;
+    if(_recovery_stats.last_recovery_ms > _recovery_stats.max_recovery_ms) {
+        _recovery_stats.max_recovery_ms = _recovery_stats.last_recovery_ms;
+    }
+
+    debug_if(_dbg_on, "\r\nSPWF> recovered from hard fault in %u ms\r\n", _recovery_stats.last_recovery_ms);
+
+    return true;
+
+recovery_failed:
+    debug_if(_dbg_on, "\r\nSPWF> session-preserving recovery failed (%s, %d)\r\n", __func__, __LINE__);
+    _recovery_stats.failed_recoveries++;
+    return false;
+}
+
+#if defined(SPWFSAXX_CMD_STATS)
+void SpwfSAInterface::get_cmd_stats(spwf_cmd_class_t cmd_class, spwf_cmd_stats_t *stats)
+{
+    SYNC_HANDLER;
+
+    _spwf.get_cmd_stats(cmd_class, stats);
+}
+
+void SpwfSAInterface::reset_cmd_stats(void)
+{
+    SYNC_HANDLER;
+
+    _spwf.reset_cmd_stats();
+}
+
+void SpwfSAInterface::dump_cmd_stats(void)
+{
+    static const char * const cmd_class_names[SPWFXX_CMD_CLASSES] = {
+        "SOCKW", "SOCKR", "SOCKQ", "SCFG", "STS", "SOCKON", "SOCKC", "other"
+    };
+    SYNC_HANDLER;
+
+    for(int cmd_class = 0; cmd_class < SPWFXX_CMD_CLASSES; cmd_class++) {
+        spwf_cmd_stats_t stats;
+
+        _spwf.get_cmd_stats((spwf_cmd_class_t)cmd_class, &stats);
+        if(stats.count == 0) continue;
+
+        printf("SPWF> %-6s: count=%lu, avg=%lu us, max=%lu us\r\n", cmd_class_names[cmd_class],
+               (unsigned long)stats.count, (unsigned long)(stats.total_us / stats.count), (unsigned long)stats.max_us);
+        for(int bucket = 0; bucket < SPWFXX_CMD_HIST_BUCKETS; bucket++) {
+            if(stats.hist[bucket] == 0) continue;
+            printf("SPWF>         >= %7lu us: %lu\r\n", (unsigned long)(1UL << bucket), (unsigned long)stats.hist[bucket]);
+        }
+    }
+}
+#endif // SPWFSAXX_CMD_STATS
+
+#if defined(SPWFSAXX_TRACE)
+void SpwfSAInterface::dump_trace(void)
+{
+    _spwf._trace.dump();
+}
+
+size_t SpwfSAInterface::get_trace(void *buffer, size_t size)
+{
+    return _spwf._trace.get(buffer, size);
+}
+
+void SpwfSAInterface::clear_trace(void)
+{
+    _spwf._trace.clear();
+}
+#endif // SPWFSAXX_TRACE
+
 #if MBED_CONF_IDW0XX1_PROVIDE_DEFAULT
 
 WiFiInterface *WiFiInterface::get_default_instance() {
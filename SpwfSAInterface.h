@@ -45,8 +45,10 @@
 
 #if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW01M1
 #include "SPWFSA01/SPWFSA01.h"
+typedef SPWFSA01 SpwfSABackend;
 #elif MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
 #include "SPWFSA04/SPWFSA04.h"
+typedef SPWFSA04 SpwfSABackend;
 #else
 #error No (valid) Wi-Fi exapnsion board defined (MBED_CONF_IDW0XX1_EXPANSION_BOARD: options are IDW01M1 and IDW04A1)
 #endif
@@ -61,11 +63,68 @@
 #define SPWF_SEND_TIMEOUT       10000
 #define SPWF_INIT_TIMEOUT       8000
 #define SPWF_OPEN_TIMEOUT       5002
+#define SPWF_TLS_OPEN_TIMEOUT   20003
+#define SPWF_TLS_CERT_TIMEOUT   10003
+#define SPWF_HTTP_TIMEOUT       20004
+#define SPWF_FS_TIMEOUT         10004
+#define SPWF_PING_TIMEOUT       5003
 #define SPWF_CONN_SND_TIMEOUT   5001
 #define SPWF_SCAN_TIMEOUT       5000
 #define SPWF_MISC_TIMEOUT       301
 #define SPWF_RECV_TIMEOUT       300
 
+/* Driver specific socket option level & options (see `setsockopt()`) */
+#define SPWFSA_SOCKOPT_LEVEL        (0x5350)
+#define SPWFSA_SOCKOPT_RX_WEIGHT    (1)         /* int: RX scheduling weight (1..SPWFSA_RX_WEIGHT_MAX) */
+#define SPWFSA_SOCKOPT_STATS        (2)         /* spwf_socket_stats_t: socket statistics (get only) */
+#define SPWFSA_SOCKOPT_STATS_RESET  (3)         /* int (ignored): reset socket statistics (set only) */
+#define SPWFSA_SOCKOPT_TLS          (4)         /* int: use module TLS for this TCP socket (0/1, set before connecting) */
+#define SPWFSA_SOCKOPT_TLS_DOMAIN   (5)         /* char[]: server name checked against the server certificate (set only, before connecting) */
+#define SPWFSA_SOCKOPT_RCVTIMEO     (6)         /* int: receive timeout in ms (-1: wait forever, 0: non-blocking (default), requires RTOS) */
+
+/* Max length of a TLS domain name (see `SPWFSA_SOCKOPT_TLS_DOMAIN`) */
+#if !defined(SPWFSA_TLS_DOMAIN_SIZE)
+#define SPWFSA_TLS_DOMAIN_SIZE      (64)
+#endif // !defined(SPWFSA_TLS_DOMAIN_SIZE)
+
+/* Host-side DNS cache (see `SpwfSAInterface::gethostbyname()`) */
+#if !defined(SPWFSA_DNS_CACHE_SIZE)
+#define SPWFSA_DNS_CACHE_SIZE       (4)         /* number of cached host names (0: no caching) */
+#endif // !defined(SPWFSA_DNS_CACHE_SIZE)
+#if !defined(SPWFSA_DNS_CACHE_TTL)
+#define SPWFSA_DNS_CACHE_TTL        (300)       /* time to live of cached entries (in seconds) */
+#endif // !defined(SPWFSA_DNS_CACHE_TTL)
+#define SPWFSA_DNS_NAME_SIZE        (64)        /* longer host names do not get cached */
+
+/* Socket readiness events (see `SpwfSAInterface::poll()`) */
+#define SPWFSA_POLL_IN              (0x01)      /* data can be received (or a connection accepted) without blocking */
+#define SPWFSA_POLL_OUT             (0x02)      /* data can be sent */
+#define SPWFSA_POLL_HUP             (0x04)      /* peer/network gone or socket closed (`revents` only) */
+
+/** Socket to be polled (see `SpwfSAInterface::poll()`) */
+typedef struct {
+    nsapi_socket_t handle;          // socket handle
+    short events;                   // requested events (`SPWFSA_POLL_IN`/`SPWFSA_POLL_OUT`)
+    short revents;                  // returned events
+} spwf_pollfd_t;
+
+/** Kinds of TLS certificates stored in the module (see `SpwfSAInterface::set_tls_certificate()`) */
+typedef enum {
+    SPWFSA_TLS_CA_CERT = 0,         // root CA certificate used to verify servers
+    SPWFSA_TLS_CLIENT_CERT,         // client certificate (for client authentication)
+    SPWFSA_TLS_CLIENT_KEY,          // client private key (for client authentication)
+} spwf_tls_cert_t;
+
+/** Module hard fault recovery statistics */
+typedef struct {
+    uint32_t hard_faults;           // module hard faults (`+WIND:8` / `+WIND:5`) seen
+    uint32_t recoveries;            // successful session-preserving recoveries
+    uint32_t failed_recoveries;     // recoveries which had to fall back to a full disconnect
+    uint32_t last_recovery_ms;      // time-to-recovery of the last successful recovery
+    uint32_t max_recovery_ms;       // maximum time-to-recovery
+    uint32_t total_recovery_ms;     // cumulative time-to-recovery
+} spwf_recovery_stats_t;
+
 /** SpwfSAInterface class
  *  Implementation of the NetworkStack for the SPWF Device
  */
@@ -128,10 +187,367 @@ public:
     virtual nsapi_error_t set_channel(uint8_t channel);
 
     /** Stop the interface
+     *
+     *  Also cancels an ongoing non-blocking connection attempt.
+     *
      *  @return             `NSAPI_ERROR_OK` on success, negative on failure
      */
     virtual nsapi_error_t disconnect();
 
+    /** Set blocking status of `connect()`
+     *
+     *  In non-blocking mode `connect()` returns as soon as the module has been
+     *  configured & the association has been started. Progress then needs to be
+     *  driven by calling `process_connection()` & is reported through the
+     *  attached status & connection progress callbacks.
+     *
+     *  @param blocking  true for blocking mode (default), false for non-blocking mode
+     *  @return          `NSAPI_ERROR_OK`
+     */
+    virtual nsapi_error_t set_blocking(bool blocking);
+
+    /** Register callback for status reporting
+     *
+     *  @param status_cb The callback for status changes
+     */
+    virtual void attach(mbed::Callback<void(nsapi_event_t, intptr_t)> status_cb);
+
+    /** Register callback for reporting progress of a connection attempt
+     *
+     *  @param progress_cb The callback for connection progress (associated, deauthentication retry,
+     *                     DHCP bound, failure)
+     */
+    void attach_connect_progress(mbed::Callback<void(spwf_connect_progress_t)> progress_cb);
+
+    /** Get the connection status
+     *
+     *  @return         The connection status according to `nsapi_connection_status_t`
+     */
+    virtual nsapi_connection_status_t get_connection_status() const;
+
+    /** Drive an ongoing non-blocking connection attempt
+     *
+     *  Processes all indications already received from the module, fires the respective
+     *  callbacks & returns without waiting for further data from the module.
+     *
+     *  @return         The connection status according to `nsapi_connection_status_t`
+     *  @note While the connection attempt is ongoing no other module operation should be
+     *        performed (as it might consume the connection progress indications)
+     */
+    nsapi_connection_status_t process_connection(void);
+
+    /** Enable or disable session-preserving recovery after module hard faults
+     *
+     *  When enabled, after a module hard fault the driver re-associates with the
+     *  last used network & transparently re-opens all connected sockets towards
+     *  their former peers. Each TCP socket reports `NSAPI_ERROR_CONNECTION_LOST`
+     *  exactly once on its next send/receive, as its stream state has been lost.
+     *  Listening sockets get their socket server restarted (or report a lost
+     *  connection if that fails), accepted clients behave as if the server had
+     *  been stopped. WebSocket & MQTT connections are reported as closed.
+     *  When disabled (default) or if recovery fails, all sockets become invalid.
+     *
+     *  @param enable   true to enable session-preserving recovery
+     */
+    void set_hard_fault_recovery(bool enable);
+
+    /** Get module hard fault recovery statistics
+     *
+     *  @param stats    Destination for the statistics
+     */
+    void get_recovery_stats(spwf_recovery_stats_t *stats);
+
+    /** Get driver statistics
+     *
+     *  Per socket statistics can be retrieved using socket option `SPWFSA_SOCKOPT_STATS`
+     *  (level `SPWFSA_SOCKOPT_LEVEL`).
+     *
+     *  @param stats    Destination for the statistics
+     */
+    void get_stats(spwf_stats_t *stats);
+
+    /** Reset driver statistics
+     */
+    void reset_stats(void);
+
+    /** Ping a host using the module's ping command
+     *
+     *  The results are also accumulated into the link quality part of the driver statistics
+     *  (see `get_stats()`).
+     *
+     *  @param host     Host name (or IP address) to ping
+     *  @param count    Number of echo requests to send
+     *  @param result   If not `NULL`, set to the round trip times & number of replies
+     *  @param size     Payload size of the echo requests (in bytes)
+     *  @return         `NSAPI_ERROR_OK` if the ping has completed (even without any reply), negative on failure
+     */
+    nsapi_error_t ping(const char *host, int count = 4, spwf_ping_result_t *result = NULL, int size = 56);
+
+    /** Get the readiness of several sockets at once
+     *
+     *  Readiness is determined from already received data & indications only,
+     *  i.e. without querying the module for each socket.
+     *
+     *  @param fds          Sockets to poll, `revents` get set on return
+     *  @param nfds         Number of entries in `fds`
+     *  @param timeout      Time (in ms) to wait for any socket to become ready
+     *                      (-1: forever, 0: don't wait, waiting requires RTOS)
+     *  @return             Number of sockets with non-zero `revents`, negative on failure
+     */
+    nsapi_size_or_error_t poll(spwf_pollfd_t *fds, unsigned nfds, int timeout);
+
+    /** Store a TLS certificate or key into the module
+     *
+     *  Certificates are used by sockets for which option `SPWFSA_SOCKOPT_TLS` (level `SPWFSA_SOCKOPT_LEVEL`)
+     *  has been set, i.e. which let the module perform TLS instead of the host.
+     *
+     *  @param kind     Kind of certificate
+     *  @param pem      PEM encoded certificate or key
+     *  @param len      Length of `pem` (in bytes)
+     *  @return         `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t set_tls_certificate(spwf_tls_cert_t kind, const char *pem, size_t len);
+
+    /** Remove all TLS certificates & keys from the module
+     *
+     *  @return         `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t clear_tls_certificates(void);
+
+    /** Perform an HTTP GET request using the module's HTTP client
+     *
+     *  The response body is delivered in chunks of at most `SPWFSA_DATA_CHUNK_SIZE` bytes,
+     *  without any heap allocation.
+     *
+     *  @note Where the module does not pass on the response's "Content-Length" (`IDW04A1`, or
+     *        responses without that header), the end of the body is recognized by the module's
+     *        final "OK" line, i.e. bodies containing such a line get truncated.
+     *
+     *  @param host     Host name (or IP address) of the server
+     *  @param path     Path (& query) of the resource
+     *  @param sink     Called for each chunk of the response body, returning `false` aborts delivery
+     *  @param status   If not `NULL`, set to the HTTP status code (`0` if unknown)
+     *  @param port     Server port (`0`: default port for `tls`)
+     *  @param tls      True to use HTTPS (see `set_tls_certificate()`)
+     *  @return         Number of body bytes delivered, negative on failure
+     */
+    nsapi_size_or_error_t http_get(const char *host, const char *path, spwf_data_sink_t sink,
+                                   int *status = NULL, int port = 0, bool tls = false);
+
+    /** Perform an HTTP GET request writing the response body to `file`
+     *
+     *  @see http_get()
+     */
+    nsapi_size_or_error_t http_get(const char *host, const char *path, FileHandle *file,
+                                   int *status = NULL, int port = 0, bool tls = false);
+
+    /** Perform an HTTP POST request using the module's HTTP client
+     *
+     *  @param form     URL encoded form content (e.g. "name=value&name2=value2")
+     *  @see http_get()
+     */
+    nsapi_size_or_error_t http_post(const char *host, const char *path, const char *form, spwf_data_sink_t sink,
+                                    int *status = NULL, int port = 0, bool tls = false);
+
+    /** Perform an HTTP POST request writing the response body to `file`
+     *
+     *  @see http_post()
+     */
+    nsapi_size_or_error_t http_post(const char *host, const char *path, const char *form, FileHandle *file,
+                                    int *status = NULL, int port = 0, bool tls = false);
+
+    /** Perform an HTTP GET request storing the response body into a file of the module's file system
+     *
+     *  The body does not cross the UART, the file survives module resets.
+     *  Only supported on `IDW04A1`, otherwise returns NSAPI_ERROR_UNSUPPORTED.
+     *
+     *  @param file     Name of the file to store the body into
+     *  @see http_get()
+     *  @return         `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t http_get_to_fs(const char *host, const char *path, const char *file,
+                                 int *status = NULL, int port = 0, bool tls = false);
+
+    /** Create a file in the module's file system
+     *
+     *  @param name     File name
+     *  @param size     (Max) size of the file
+     *  @return         `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t fs_create(const char *name, unsigned size);
+
+    /** Append data to a file in the module's file system
+     *
+     *  @param name     File name
+     *  @param data     Data to append
+     *  @param len      Length of `data`
+     *  @return         `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t fs_append(const char *name, const void *data, unsigned len);
+
+    /** Delete a file from the module's file system
+     *
+     *  @param name     File name
+     *  @return         `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t fs_delete(const char *name);
+
+    /** List the files of the module's file system
+     *
+     *  @param files    Array to store the files in
+     *  @param limit    Size of `files`, or 0 to only count files
+     *  @return         Number of files (might be greater than `limit`), negative on failure
+     */
+    nsapi_size_or_error_t fs_list(spwf_file_t *files, unsigned limit);
+
+    /** Read a file from the module's file system
+     *
+     *  @param name     File name
+     *  @param sink     Called for each chunk (of at most `SPWFSA_DATA_CHUNK_SIZE` bytes) read,
+     *                  returning `false` aborts delivery
+     *  @param offset   Offset of first byte to read
+     *  @param len      Number of bytes to read (`0`: up to the end of the file)
+     *  @return         Number of bytes delivered, negative on failure
+     */
+    nsapi_size_or_error_t fs_read(const char *name, spwf_data_sink_t sink, unsigned offset = 0, unsigned len = 0);
+
+    /** Read a file from the module's file system into a buffer
+     *
+     *  @param name     File name
+     *  @param buf      Destination buffer
+     *  @param size     Number of bytes to read
+     *  @param offset   Offset of first byte to read
+     *  @return         Number of bytes read, negative on failure
+     */
+    nsapi_size_or_error_t fs_read(const char *name, void *buf, unsigned size, unsigned offset = 0);
+
+    /** Open a WebSocket client connection using the module's WebSocket client
+     *
+     *  Framing & masking are performed by the module, messages are received as a whole.
+     *  Only supported on `IDW04A1`, otherwise returns NSAPI_ERROR_UNSUPPORTED.
+     *
+     *  @param host     Host name (or IP address) of the server
+     *  @param path     Resource path (e.g. "/")
+     *  @param ws_id    Destination for the id of the new connection
+     *  @param port     Server port (`0`: default port for `tls`)
+     *  @param tls      True to use a secure WebSocket (see `set_tls_certificate()`)
+     *  @return         `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t ws_open(const char *host, const char *path, int *ws_id, int port = 0, bool tls = false);
+
+    /** Close a WebSocket client connection
+     *
+     *  @param ws_id    Connection id
+     *  @return         `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t ws_close(int ws_id);
+
+    /** Send a message
+     *
+     *  @param ws_id    Connection id
+     *  @param data     Message
+     *  @param size     Length of the message, at most `SPWFXX_SEND_RECV_PKTSIZE` bytes
+     *  @return         Number of bytes sent on success, negative on failure
+     */
+    nsapi_size_or_error_t ws_send(int ws_id, const void *data, unsigned size);
+
+    /** Receive the oldest complete message (non-blocking)
+     *
+     *  @param ws_id    Connection id
+     *  @param data     Destination buffer
+     *  @param size     Size of the destination buffer
+     *  @return         Length of the message on success, `NSAPI_ERROR_WOULD_BLOCK` if no complete message
+     *                  is pending, `NSAPI_ERROR_NO_MEMORY` if the message does not fit into `data` (it is kept),
+     *                  `NSAPI_ERROR_CONNECTION_LOST` once the connection has been closed & all messages
+     *                  have been received, `NSAPI_ERROR_DEVICE_ERROR` once more than `SPWFSA_WSOCK_MSG_QUEUE`
+     *                  messages had been pending & all messages queued before have been received (the
+     *                  connection must then be closed), other negative error codes on failure
+     */
+    nsapi_size_or_error_t ws_recv(int ws_id, void *data, unsigned size);
+
+    /** Register a callback on state change of any WebSocket connection (e.g. a message having been completed)
+     *
+     *  @param func     Function to call on state change (might be called in IRQ context)
+     */
+    void ws_attach(Callback<void()> func);
+
+    /** Connect the module's MQTT client to a broker
+     *
+     *  Keep-alive is handled by the module.
+     *  Only supported on `IDW04A1`, otherwise returns NSAPI_ERROR_UNSUPPORTED.
+     *
+     *  @param host         Host name (or IP address) of the broker
+     *  @param client_id    MQTT client identifier
+     *  @param mqtt_id      Destination for the id of the new connection
+     *  @param port         Broker port (`0`: default port for `tls`)
+     *  @param tls          True to use MQTT over TLS (see `set_tls_certificate()`)
+     *  @param user         User name (`NULL` for none)
+     *  @param pass         Password (`NULL` for none)
+     *  @param keepalive    Keep-alive interval (in seconds)
+     *  @return             `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t mqtt_connect(const char *host, const char *client_id, int *mqtt_id, int port = 0, bool tls = false,
+                               const char *user = NULL, const char *pass = NULL, int keepalive = 60);
+
+    /** Disconnect from a broker
+     *
+     *  @param mqtt_id      Connection id
+     *  @return             `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t mqtt_disconnect(int mqtt_id);
+
+    /** Publish a message
+     *
+     *  @param mqtt_id      Connection id
+     *  @param topic        Topic
+     *  @param payload      Message payload
+     *  @param len          Length of the payload, at most `SPWFXX_SEND_RECV_PKTSIZE` bytes
+     *  @param qos          Quality of service (0 to 2)
+     *  @param retain       True to let the broker retain the message
+     *  @return             `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t mqtt_publish(int mqtt_id, const char *topic, const void *payload, unsigned len,
+                               int qos = 0, bool retain = false);
+
+    /** Subscribe to a topic (filter)
+     *
+     *  Incoming messages are delivered to the function attached with `mqtt_attach()`.
+     *
+     *  @param mqtt_id      Connection id
+     *  @param topic        Topic filter
+     *  @param qos          Maximum quality of service (0 to 2)
+     *  @return             `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t mqtt_subscribe(int mqtt_id, const char *topic, int qos = 0);
+
+    /** Unsubscribe from a topic (filter)
+     *
+     *  @param mqtt_id      Connection id
+     *  @param topic        Topic filter
+     *  @return             `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    nsapi_error_t mqtt_unsubscribe(int mqtt_id, const char *topic);
+
+    /** Send a ping request to the broker
+     *
+     *  @param mqtt_id      Connection id
+     *  @return             `NSAPI_ERROR_OK` on success, `NSAPI_ERROR_CONNECTION_LOST` if the connection
+     *                      has been closed, negative on failure
+     */
+    nsapi_error_t mqtt_ping(int mqtt_id);
+
+    /** Register a function to be called for each incoming message
+     *
+     *  The function is called from within the driver's asynchronous indication handling
+     *  (i.e. with the driver locked) & must not call back into the driver.
+     *  Payloads longer than `SPWFSA_MQTT_PAYLOAD_SIZE` bytes get truncated, i.e. `func` is passed the
+     *  number of payload bytes delivered (`len`) as well as the length of the message's payload
+     *  (`total_len`, greater than `len` for truncated payloads).
+     *
+     *  @param func         Function to call for incoming messages
+     */
+    void mqtt_attach(spwf_mqtt_cb_t func);
+
     /** Get the internally stored IP address
      *  @return             IP address of the interface or null if not yet connected
      */
@@ -142,6 +558,12 @@ public:
      */
     virtual const char *get_mac_address();
 
+    /** Get the firmware version of the module as detected during initialization
+     *  @return             Null-terminated version string (e.g. "170111-665d284-SPWF01S"),
+     *                      empty if unknown
+     */
+    const char *get_firmware_version();
+
     /** Get the local gateway
      *
      *  @return         Null-terminated representation of the local gateway
@@ -183,13 +605,17 @@ public:
      *  If no stack-specific DNS resolution is provided, the hostname
      *  will be resolve using a UDP socket on the stack.
      *
+     *  Successfully resolved IPv4 addresses are cached for `SPWFSA_DNS_CACHE_TTL` seconds,
+     *  i.e. repeated lookups do not cause any module traffic.
+     *  The cache is flushed by `disconnect()`.
+     *
+     *  @param name     Hostname to resolve
      *  @param address  Destination for the host SocketAddress
-     *  @param host     Hostname to resolve
      *  @param version  IP version of address to resolve, NSAPI_UNSPEC indicates
      *                  version is chosen by the stack (defaults to NSAPI_UNSPEC)
      *  @return         0 on success, negative error code on failure
      */
-    using NetworkInterface::gethostbyname;
+    virtual nsapi_error_t gethostbyname(const char *name, SocketAddress *address, nsapi_version_t version = NSAPI_UNSPEC);
 
     /** Add a domain name server to list of servers to query
      *
@@ -198,6 +624,43 @@ public:
      */
     using NetworkInterface::add_dns_server;
 
+#if defined(SPWFSAXX_CMD_STATS)
+    /** Get latency statistics of an AT command class
+     *
+     *  @param cmd_class    AT command class
+     *  @param stats        Destination for the statistics
+     */
+    void get_cmd_stats(spwf_cmd_class_t cmd_class, spwf_cmd_stats_t *stats);
+
+    /** Reset latency statistics of all AT command classes
+     */
+    void reset_cmd_stats(void);
+
+    /** Print latency statistics (incl. histograms) of all AT command classes
+     */
+    void dump_cmd_stats(void);
+#endif // SPWFSAXX_CMD_STATS
+
+#if defined(SPWFSAXX_TRACE)
+    /** Print all records of the UART & driver event trace
+     *
+     *  @note does not acquire the driver mutex (i.e. might also be called when the driver is stuck)
+     */
+    void dump_trace(void);
+
+    /** Copy binary trace records (oldest first) for offline decoding (see `spwf_trace_hdr_t`)
+     *
+     *  @param buffer   Destination buffer
+     *  @param size     Size of destination buffer
+     *  @return         Number of bytes copied
+     */
+    size_t get_trace(void *buffer, size_t size);
+
+    /** Discard all trace records
+     */
+    void clear_trace(void);
+#endif // SPWFSAXX_TRACE
+
 private:
     /** Open a socket
      *  @param handle       Handle in which to store new socket
@@ -207,6 +670,11 @@ private:
     virtual nsapi_error_t socket_open(void **handle, nsapi_protocol_t proto);
 
     /** Close the socket
+     *
+     *  Closing a listening socket stops the module socket server, disconnecting all of its clients.
+     *  Closing an accepted socket disconnects the client on the module (`IDW04A1` only,
+     *  see `SPWFSA04::sockd_disconnect()` for the limitation of this).
+     *
      *  @param handle       Socket handle
      *  @return             `NSAPI_ERROR_OK` on success, negative on failure
      *  @note On failure, any memory associated with the socket must still
@@ -214,24 +682,29 @@ private:
      */
     virtual nsapi_error_t socket_close(void *handle);
 
-    /** Bind a server socket to a specific port - NOT SUPPORTED
+    /** Bind a server socket to a specific port
      *
-     *  This function is not supported and will return NSAPI_ERROR_UNSUPPORTED
+     *  Only supported for TCP sockets on `IDW04A1` (module socket server),
+     *  otherwise returns NSAPI_ERROR_UNSUPPORTED
      *
      *  @param handle       Socket handle
-     *  @param address      Local address to listen for incoming connections on
-     *  @return             Not supported, returns NSAPI_ERROR_UNSUPPORTED
+     *  @param address      Local address to listen for incoming connections on (only port is used)
+     *  @return             `NSAPI_ERROR_OK` on success, negative on failure
      */
     virtual nsapi_error_t socket_bind(void *handle, const SocketAddress &address);
 
-    /** Start listening for incoming connections - NOT SUPPORTED
+    /** Start listening for incoming connections
      *
-     *  This function is not supported and will return NSAPI_ERROR_UNSUPPORTED
+     *  Only supported for bound TCP sockets on `IDW04A1` (module socket server),
+     *  otherwise returns NSAPI_ERROR_UNSUPPORTED
      *
      *  @param handle       Socket handle
-     *  @param backlog      Number of pending connections that can be queued up at any
-     *                      one time [Default: 1]
-     *  @return             Not supported, returns NSAPI_ERROR_UNSUPPORTED
+     *  @param backlog      Ignored, at most `SPWFSA_SOCKD_BACKLOG` connections (of all servers)
+     *                      are queued up at any one time, further clients get disconnected by the
+     *                      next call to `socket_accept()` (clients exceeding another
+     *                      `SPWFSA_SOCKD_BACKLOG` in the meantime stay connected on the module until
+     *                      they go away or the server gets stopped)
+     *  @return             `NSAPI_ERROR_OK` on success, negative on failure
      */
     virtual nsapi_error_t socket_listen(void *handle, int backlog);
 
@@ -242,13 +715,17 @@ private:
      */
     virtual nsapi_error_t socket_connect(void *handle, const SocketAddress &address);
 
-    /** Accept a new connection - NOT SUPPORTED
+    /** Accept a new connection
      *
-     *  This function is not supported and will return NSAPI_ERROR_UNSUPPORTED
+     *  Only supported on `IDW04A1` (module socket server), otherwise returns NSAPI_ERROR_UNSUPPORTED.
+     *  Accepted sockets use one of the `SPWFSA_SOCKET_COUNT` socket handles, their data is
+     *  left on the module until received by the application.
      *
-     *  @param handle       Handle in which to store new socket
      *  @param server       Socket handle to server to accept from
-     *  @return             Not supported, returns NSAPI_ERROR_UNSUPPORTED
+     *  @param handle       Handle in which to store new socket
+     *  @param address      Destination for the remote address (port is not reported, i.e. `0`)
+     *  @return             `NSAPI_ERROR_OK` on success, `NSAPI_ERROR_WOULD_BLOCK` if no connection
+     *                      is pending, negative on failure
      */
     virtual nsapi_error_t socket_accept(void *handle, void **socket, SocketAddress *address);
 
@@ -296,6 +773,45 @@ private:
      */
     virtual nsapi_size_or_error_t socket_recvfrom(void *handle, SocketAddress *address, void *buffer, unsigned size);
 
+    /** Set socket options
+     *
+     *  Supported options:
+     *  - `NSAPI_SOCKET`/`NSAPI_RCVBUF`:                  (int) RX quota, i.e. max amount of received data (in bytes)
+     *                                                     buffered on the host for this socket
+     *  - `SPWFSA_SOCKOPT_LEVEL`/`SPWFSA_SOCKOPT_RX_WEIGHT`: (int) weight of this socket when reading in pending data
+     *  - `SPWFSA_SOCKOPT_LEVEL`/`SPWFSA_SOCKOPT_STATS_RESET`: reset statistics of this socket
+     *  - `SPWFSA_SOCKOPT_LEVEL`/`SPWFSA_SOCKOPT_TLS`: (int) let the module perform TLS for this (TCP) socket
+     *  - `SPWFSA_SOCKOPT_LEVEL`/`SPWFSA_SOCKOPT_TLS_DOMAIN`: (char[], not null-terminated) server name
+     *                                                     to be checked against the server certificate
+     *                                                     (must not contain `,` or control characters)
+     *  - `SPWFSA_SOCKOPT_LEVEL`/`SPWFSA_SOCKOPT_RCVTIMEO`: (int) time (in ms) receive calls block waiting for
+     *                                                     data of this socket (-1: forever, 0: don't block)
+     *
+     *  @param handle       Socket handle
+     *  @param level        Option level
+     *  @param optname      Level-specific option name
+     *  @param optval       Option value
+     *  @param optlen       Length of the option value
+     *  @return             `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    virtual nsapi_error_t setsockopt(nsapi_socket_t handle, int level,
+                                     int optname, const void *optval, unsigned optlen);
+
+    /** Get socket options
+     *
+     *  See `setsockopt()` for supported options, additionally:
+     *  - `SPWFSA_SOCKOPT_LEVEL`/`SPWFSA_SOCKOPT_STATS`: (spwf_socket_stats_t) statistics of this socket
+     *
+     *  @param handle       Socket handle
+     *  @param level        Option level
+     *  @param optname      Level-specific option name
+     *  @param optval       Destination for option value
+     *  @param optlen       Length of the option value
+     *  @return             `NSAPI_ERROR_OK` on success, negative on failure
+     */
+    virtual nsapi_error_t getsockopt(nsapi_socket_t handle, int level,
+                                     int optname, void *optval, unsigned *optlen);
+
     /** Register a callback on state change of the socket
      *  @param handle       Socket handle
      *  @param callback     Function to call on state change
@@ -322,8 +838,22 @@ private:
         int spwf_id;
         bool server_gone;
         bool no_more_data;
+        bool connection_reset;
         nsapi_protocol_t proto;
         SocketAddress addr;
+        uint32_t rx_quota;
+        uint32_t rx_weight;
+        uint32_t rx_deficit;
+        spwf_socket_stats_t stats;
+        bool tls;
+        char tls_domain[SPWFSA_TLS_DOMAIN_SIZE];
+        uint16_t local_port;    // set by `socket_bind()`
+        bool listening;         // socket server started by `socket_listen()` (`sockd_sid` valid)
+        bool sockd_client;      // client accepted by `socket_accept()` (`sockd_sid` & `sockd_cid` valid)
+        bool sockd_pending;     // pending data indicated for socket server client
+        int8_t sockd_sid;
+        int8_t sockd_cid;
+        int rcv_timeout;        // see `SPWFSA_SOCKOPT_RCVTIMEO`
     } spwf_socket_t;
 
     bool _socket_is_open(spwf_socket_t *sock) {
@@ -368,16 +898,22 @@ private:
         ap_sec = NSAPI_SECURITY_NONE;
     }
 
-#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW01M1
-    SPWFSA01 _spwf;
-#elif MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
-    SPWFSA04 _spwf;
-#endif
+    SpwfSABackend _spwf;
 
     bool _isInitialized;
     bool _dbg_on;
     bool _connected_to_network;
 
+    bool _blocking;
+    bool _connecting;
+    Timer _connect_timer;
+    nsapi_connection_status_t _conn_status;
+    Callback<void(nsapi_event_t, intptr_t)> _status_cb;
+    Callback<void(spwf_connect_progress_t)> _progress_cb;
+
+    bool _hf_recovery;
+    spwf_recovery_stats_t _recovery_stats;
+
     spwf_socket_t _ids[SPWFSA_SOCKET_COUNT];
     struct {
         void (*callback)(void *);
@@ -387,8 +923,49 @@ private:
 
 #if MBED_CONF_RTOS_PRESENT
     Mutex _spwf_mutex;
+
+    /* blocking receive: one flag per socket (`internal_id`) signalling data or connection state changes,
+     * plus `SPWFSA_RX_FLAG_UART` signalling UART activity (to be processed by one of the blocked receivers) */
+    EventFlags _rx_flags;
 #endif
 
+#if SPWFSA_DNS_CACHE_SIZE > 0
+    struct {
+        char name[SPWFSA_DNS_NAME_SIZE];    // empty if entry is unused
+        char addr[16];
+        uint32_t expires;                   // `_dns_now()` seconds
+    } _dns_cache[SPWFSA_DNS_CACHE_SIZE];
+
+    /* Note: a running `Timer` would lock deep sleep */
+    static uint32_t _dns_now(void) {
+#if MBED_CONF_RTOS_PRESENT
+        return (uint32_t)(Kernel::get_ms_count() / 1000);
+#else // !MBED_CONF_RTOS_PRESENT
+        /* Note: extends the wrapping microsecond ticker (`time()` does not advance unless the RTC has been set),
+         *       which requires being called at least once per wrap (i.e. every ~71 minutes) */
+        static uint32_t last_us, secs, rem_us;
+        uint32_t now_us = us_ticker_read();
+        uint64_t elapsed = (uint64_t)(uint32_t)(now_us - last_us) + rem_us;
+
+        last_us = now_us;
+        secs += (uint32_t)(elapsed / 1000000);
+        rem_us = (uint32_t)(elapsed % 1000000);
+        return secs;
+#endif // !MBED_CONF_RTOS_PRESENT
+    }
+
+    bool _dns_cache_lookup(const char *name, SocketAddress *address);
+    void _dns_cache_add(const char *name, const SocketAddress &address);
+#endif // SPWFSA_DNS_CACHE_SIZE > 0
+    void _dns_cache_flush(void);
+
+    nsapi_size_or_error_t _http_request(const char *host, const char *path, const char *form,
+                                        spwf_data_sink_t sink, int *status, int port, bool tls);
+    static bool _http_file_sink(FileHandle *file, const void *data, size_t len);
+    bool _fs_prepare(void);
+
+    Callback<void()> _ws_callback;
+
     char ap_ssid[33]; /* 32 is what 802.11 defines as longest possible name; +1 for the \0 */
     nsapi_security_t ap_sec;
     char ap_pass[64]; /* The longest allowed passphrase */
@@ -396,8 +973,28 @@ private:
 private:
     void event(void);
     nsapi_error_t init(void);
+    int _get_security_mode(const char **pass_phrase);
+    nsapi_size_or_error_t _sockd_recv(spwf_socket_t *socket, void *data, unsigned size);
+    short _socket_poll(spwf_socket_t *socket, short events);
+    nsapi_size_or_error_t _socket_recv_wait(spwf_socket_t *socket, void *data, unsigned size, bool datagram);
+    nsapi_error_t _socket_connect_module(spwf_socket_t *socket, const SocketAddress &addr);
+    bool _recover_sessions(void);
     nsapi_size_or_error_t _socket_recv(void *handle, void *data, unsigned size, bool datagram);
 
+    void _set_connection_status(nsapi_connection_status_t status) {
+        if(_conn_status == status) return;
+
+        _conn_status = status;
+        if((bool)_status_cb) {
+            _status_cb(NSAPI_EVENT_CONNECTION_STATUS_CHANGE, _conn_status);
+        }
+    }
+
+    void _report_connect_progress(spwf_connect_progress_t progress) {
+        if((bool)_progress_cb) {
+            _progress_cb(progress);
+        }
+    }
 
     int get_internal_id(int spwf_id) { // checks also if `spwf_id` is (still) "valid"
         if(((unsigned int)spwf_id) < ((unsigned int)SPWFSA_SOCKET_COUNT)) { // valid `spwf_id`
@@ -412,6 +1009,40 @@ private:
         }
     }
 
+#if MBED_CONF_RTOS_PRESENT
+#define SPWFSA_RX_FLAG_UART     (1UL << SPWFSA_SOCKET_COUNT)
+#define SPWFSA_RX_FLAGS_SOCKETS ((1UL << SPWFSA_SOCKET_COUNT) - 1)
+#endif
+
+    /* wake up receivers blocked in `_socket_recv_wait()` (might be called in IRQ context) */
+    void _rx_signal(int internal_id) {
+#if MBED_CONF_RTOS_PRESENT
+        _rx_flags.set(1UL << internal_id);
+#endif
+    }
+
+    void _rx_signal_all(void) {
+#if MBED_CONF_RTOS_PRESENT
+        _rx_flags.set(SPWFSA_RX_FLAGS_SOCKETS);
+#endif
+    }
+
+    void _rx_signal_uart(void) {
+#if MBED_CONF_RTOS_PRESENT
+        _rx_flags.set(SPWFSA_RX_FLAG_UART);
+#endif
+    }
+
+    int get_sockd_internal_id(int sid, int cid) { // socket server client accepted by `socket_accept()`
+        for(int internal_id = 0; internal_id < SPWFSA_SOCKET_COUNT; internal_id++) {
+            if(_socket_is_open(internal_id) && _ids[internal_id].sockd_client
+                    && (_ids[internal_id].sockd_sid == sid) && (_ids[internal_id].sockd_cid == cid)) {
+                return internal_id;
+            }
+        }
+        return SPWFSA_SOCKET_COUNT;
+    }
+
     /* Called at initialization or after module hard fault */
     void inner_constructor() {
         memset(_ids, 0, sizeof(_ids));
@@ -424,9 +1055,19 @@ private:
         }
 
         _spwf.attach(this, &SpwfSAInterface::event);
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+        _spwf._sockd_reset();
+        _spwf._wsock_reset();
+        _spwf._mqtt_reset();
+#endif
 
         _connected_to_network = false;
         _isInitialized = false;
+        _connecting = false;
+
+        _rx_signal_all(); // wake up blocked receivers
+
+        _set_connection_status(NSAPI_STATUS_DISCONNECTED);
     }
 
 private:
@@ -439,5 +1080,13 @@ private:
         if(!_connected_to_network) return NSAPI_ERROR_NO_CONNECTION; \
 } \
 
+/* report a connection reset (after module hard fault recovery) exactly once */
+#define CHECK_CONNECTION_RESET_ERR(sock) { \
+        if((sock)->connection_reset) { \
+            (sock)->connection_reset = false; \
+            return NSAPI_ERROR_CONNECTION_LOST; \
+        } \
+} \
+
 
 #endif
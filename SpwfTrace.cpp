@@ -0,0 +1,304 @@
+/* SPWFSAxx Devices
+ * Copyright (c) 2018 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(SPWFSAXX_TRACE)
+
+#include "SpwfTrace.h"
+
+static const char *const trace_type_names[SPWF_TRACE_TYPES] = {
+    "RX",
+    "TX",
+    "WIND",
+    "ERROR",
+    "PKT",
+    "CB",
+};
+
+SpwfTrace::SpwfTrace(FileHandle *fh)
+: _fh(fh), _paused(false)
+{
+    clear();
+}
+
+ssize_t SpwfTrace::read(void *buffer, size_t size)
+{
+    ssize_t ret = _fh->read(buffer, size);
+    if(ret > 0) _uart(SPWF_TRACE_UART_RX, buffer, ret);
+    return ret;
+}
+
+ssize_t SpwfTrace::write(const void *buffer, size_t size)
+{
+    ssize_t ret = _fh->write(buffer, size);
+    if(ret > 0) _uart(SPWF_TRACE_UART_TX, buffer, ret);
+    return ret;
+}
+
+off_t SpwfTrace::seek(off_t offset, int whence)
+{
+    return _fh->seek(offset, whence);
+}
+
+int SpwfTrace::close(void)
+{
+    return _fh->close();
+}
+
+int SpwfTrace::sync(void)
+{
+    return _fh->sync();
+}
+
+int SpwfTrace::isatty(void)
+{
+    return _fh->isatty();
+}
+
+off_t SpwfTrace::size(void)
+{
+    return _fh->size();
+}
+
+int SpwfTrace::set_blocking(bool blocking)
+{
+    return _fh->set_blocking(blocking);
+}
+
+bool SpwfTrace::is_blocking(void) const
+{
+    return _fh->is_blocking();
+}
+
+bool SpwfTrace::readable(void) const
+{
+    return _fh->readable();
+}
+
+bool SpwfTrace::writable(void) const
+{
+    return _fh->writable();
+}
+
+short SpwfTrace::poll(short events) const
+{
+    return _fh->poll(events);
+}
+
+void SpwfTrace::clear(void)
+{
+    core_util_critical_section_enter();
+    _head = _tail = _used = 0;
+    _last = 0;
+    _last_valid = false;
+    _last_us = 0;
+    core_util_critical_section_exit();
+}
+
+void SpwfTrace::_event(spwf_trace_type_t type, uint16_t arg, const void *data, uint8_t len)
+{
+    spwf_trace_hdr_t hdr;
+
+    if(_paused) return;
+
+    hdr.type = type;
+    hdr.len = len;
+    hdr.arg = arg;
+    hdr.us = us_ticker_read();
+
+    core_util_critical_section_enter();
+    if(_reserve(sizeof(hdr) + len)) {
+        _put(_head, &hdr, sizeof(hdr));
+        _put(_head + sizeof(hdr), data, len);
+        _head = (_head + sizeof(hdr) + len) % SPWFSAXX_TRACE_BUFFER_SIZE;
+        _used += sizeof(hdr) + len;
+        _last_valid = false;
+    }
+    core_util_critical_section_exit();
+}
+
+/* Note: consecutive bytes of the same direction get merged into one record,
+ *       only the first `SPWFSAXX_TRACE_MAX_DATA` bytes of which are stored
+ */
+void SpwfTrace::_uart(spwf_trace_type_t type, const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t*)data;
+    uint32_t now = us_ticker_read();
+    spwf_trace_hdr_t hdr;
+
+    if(_paused) return;
+
+    core_util_critical_section_enter();
+    while(size > 0) {
+        if(_last_valid) {
+            _get(_last, &hdr, sizeof(hdr));
+            if((hdr.type != type) || (hdr.arg == 0xFFFF) || ((now - _last_us) > SPWFXX_TRACE_COALESCE_US)) {
+                _last_valid = false;
+            }
+        }
+
+        if(!_last_valid) {
+            /* start new record */
+            if(!_reserve(sizeof(hdr))) break;
+
+            hdr.type = type;
+            hdr.len = 0;
+            hdr.arg = 0;
+            hdr.us = now;
+            _last = _head;
+            _last_valid = true;
+            _head = (_head + sizeof(hdr)) % SPWFSAXX_TRACE_BUFFER_SIZE;
+            _used += sizeof(hdr);
+        }
+
+        /* append data (as long as record has room for it) */
+        uint32_t chunk = 0xFFFF - hdr.arg;
+        if(chunk > size) chunk = size;
+        uint32_t to_store = SPWFSAXX_TRACE_MAX_DATA - hdr.len;
+        if(to_store > chunk) to_store = chunk;
+
+        if(to_store > 0) {
+            _reserve(to_store);
+            if(!_last_valid) continue; // record has been discarded to make room
+
+            _put(_head, bytes, to_store);
+            _head = (_head + to_store) % SPWFSAXX_TRACE_BUFFER_SIZE;
+            _used += to_store;
+            hdr.len += to_store;
+        }
+
+        /* account for all bytes (stored or not) */
+        hdr.arg += chunk;
+        _put(_last, &hdr, sizeof(hdr));
+
+        bytes += chunk;
+        size -= chunk;
+    }
+    _last_us = now;
+    core_util_critical_section_exit();
+}
+
+void SpwfTrace::_put(uint32_t pos, const void *data, uint32_t len)
+{
+    const uint8_t *src = (const uint8_t*)data;
+    for(uint32_t i = 0; i < len; i++) {
+        _ring[(pos + i) % SPWFSAXX_TRACE_BUFFER_SIZE] = src[i];
+    }
+}
+
+void SpwfTrace::_get(uint32_t pos, void *data, uint32_t len) const
+{
+    uint8_t *dst = (uint8_t*)data;
+    for(uint32_t i = 0; i < len; i++) {
+        dst[i] = _ring[(pos + i) % SPWFSAXX_TRACE_BUFFER_SIZE];
+    }
+}
+
+void SpwfTrace::_drop_oldest(void)
+{
+    spwf_trace_hdr_t hdr;
+    uint32_t rec_len;
+
+    MBED_ASSERT(_used >= sizeof(hdr));
+
+    _get(_tail, &hdr, sizeof(hdr));
+    rec_len = sizeof(hdr) + hdr.len;
+
+    if(_last_valid && (_last == _tail)) _last_valid = false;
+
+    _tail = (_tail + rec_len) % SPWFSAXX_TRACE_BUFFER_SIZE;
+    _used -= rec_len;
+}
+
+/* Make room for `len` bytes by discarding oldest records
+ *
+ * Note: must be called within a critical section
+ */
+bool SpwfTrace::_reserve(uint32_t len)
+{
+    if(len > SPWFSAXX_TRACE_BUFFER_SIZE) return false;
+
+    while((SPWFSAXX_TRACE_BUFFER_SIZE - _used) < len) {
+        _drop_oldest();
+    }
+    return true;
+}
+
+size_t SpwfTrace::get(void *buffer, size_t size)
+{
+    uint8_t *dst = (uint8_t*)buffer;
+    spwf_trace_hdr_t hdr;
+    uint32_t pos, done, copied = 0;
+
+    core_util_critical_section_enter();
+    for(pos = _tail, done = 0; done < _used; done += sizeof(hdr) + hdr.len) {
+        _get(pos, &hdr, sizeof(hdr));
+        if((copied + sizeof(hdr) + hdr.len) > size) break;
+
+        _get(pos, dst + copied, sizeof(hdr) + hdr.len);
+        copied += sizeof(hdr) + hdr.len;
+        pos = (pos + sizeof(hdr) + hdr.len) % SPWFSAXX_TRACE_BUFFER_SIZE;
+    }
+    core_util_critical_section_exit();
+
+    return copied;
+}
+
+/* Note: recording is paused while dumping */
+void SpwfTrace::dump(void)
+{
+    spwf_trace_hdr_t hdr;
+    uint8_t data[SPWFSAXX_TRACE_MAX_DATA];
+    uint32_t pos, done, first_us = 0;
+
+    pause(true);
+
+    printf("SPWF> trace (%lu bytes):\r\n", (unsigned long)_used);
+    for(pos = _tail, done = 0; done < _used; done += sizeof(hdr) + hdr.len) {
+        _get(pos, &hdr, sizeof(hdr));
+        _get(pos + sizeof(hdr), data, hdr.len);
+        pos = (pos + sizeof(hdr) + hdr.len) % SPWFSAXX_TRACE_BUFFER_SIZE;
+
+        if(done == 0) first_us = hdr.us;
+        printf("SPWF> %10lu %-5s %5u ", (unsigned long)(uint32_t)(hdr.us - first_us),
+               (hdr.type < SPWF_TRACE_TYPES) ? trace_type_names[hdr.type] : "?", hdr.arg);
+
+        switch(hdr.type) {
+            case SPWF_TRACE_UART_RX:
+            case SPWF_TRACE_UART_TX:
+                for(uint32_t i = 0; i < hdr.len; i++) {
+                    if((data[i] >= ' ') && (data[i] <= '~')) {
+                        printf("%c", data[i]);
+                    } else {
+                        printf("\\x%02x", data[i]);
+                    }
+                }
+                if(hdr.arg > hdr.len) printf("...");
+                break;
+            default:
+                if(hdr.len == sizeof(uint32_t)) {
+                    uint32_t value;
+                    memcpy(&value, data, sizeof(value));
+                    printf("%lu", (unsigned long)value);
+                }
+                break;
+        }
+        printf("\r\n");
+    }
+
+    pause(false);
+}
+
+#endif // SPWFSAXX_TRACE
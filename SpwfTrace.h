@@ -0,0 +1,126 @@
+/* SPWFSAxx Devices
+ * Copyright (c) 2018 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SPWF_TRACE_H
+#define SPWF_TRACE_H
+
+#include "mbed.h"
+
+#if !defined(SPWFSAXX_TRACE_BUFFER_SIZE)
+#define SPWFSAXX_TRACE_BUFFER_SIZE  (4096)
+#endif // !defined(SPWFSAXX_TRACE_BUFFER_SIZE)
+
+#if !defined(SPWFSAXX_TRACE_MAX_DATA)
+#define SPWFSAXX_TRACE_MAX_DATA     (64)    // max. number of UART bytes stored per record
+#endif // !defined(SPWFSAXX_TRACE_MAX_DATA)
+
+#define SPWFXX_TRACE_COALESCE_US    (1000)  // UART bytes closer than this are stored in the same record
+
+/* Trace record types */
+typedef enum {
+    SPWF_TRACE_UART_RX = 0,     // `arg`: number of bytes received, data: (first) bytes received
+    SPWF_TRACE_UART_TX,         // `arg`: number of bytes sent, data: (first) bytes sent
+    SPWF_TRACE_WIND,            // `arg`: WIND id
+    SPWF_TRACE_ERROR,           // `arg`: 0
+    SPWF_TRACE_PKT_QUEUED,      // `arg`: module socket id, value: packet length
+    SPWF_TRACE_CALLBACK,        // `arg`: 0
+    SPWF_TRACE_TYPES
+} spwf_trace_type_t;
+
+/* Trace record header
+ *
+ * Records are stored back to back (oldest first when retrieved using `SpwfTrace::get()`),
+ * each one consisting of this header (in target byte order) followed by `len` data bytes.
+ */
+typedef struct {
+    uint8_t type;       // see `spwf_trace_type_t`
+    uint8_t len;        // number of data bytes following the header
+    uint16_t arg;       // record type specific argument
+    uint32_t us;        // `us_ticker_read()` timestamp
+} spwf_trace_hdr_t;
+
+/* UART file handle wrapper recording all traffic & driver events into a fixed size RAM ring buffer
+ *
+ * Note: when the ring buffer is full the oldest records get discarded
+ */
+class SpwfTrace : public FileHandle {
+public:
+    SpwfTrace(FileHandle *fh);
+
+    /* FileHandle */
+    virtual ssize_t read(void *buffer, size_t size);
+    virtual ssize_t write(const void *buffer, size_t size);
+    virtual off_t seek(off_t offset, int whence = SEEK_SET);
+    virtual int close(void);
+    virtual int sync(void);
+    virtual int isatty(void);
+    virtual off_t size(void);
+    virtual int set_blocking(bool blocking);
+    virtual bool is_blocking(void) const;
+    virtual bool readable(void) const;
+    virtual bool writable(void) const;
+    virtual short poll(short events) const;
+
+    /* Record a driver event (might be called in IRQ context)
+     *
+     * Note: an event `value` is stored as `uint32_t` data
+     */
+    void event(spwf_trace_type_t type, uint16_t arg) {
+        _event(type, arg, NULL, 0);
+    }
+
+    void event(spwf_trace_type_t type, uint16_t arg, uint32_t value) {
+        _event(type, arg, &value, sizeof(value));
+    }
+
+    /* Pause/resume recording */
+    void pause(bool paused) {
+        _paused = paused;
+    }
+
+    /* Discard all records */
+    void clear(void);
+
+    /* Copy (whole) records into `buffer` (oldest first)
+     *
+     * @return number of bytes copied
+     */
+    size_t get(void *buffer, size_t size);
+
+    /* Print all records in human readable form */
+    void dump(void);
+
+private:
+    FileHandle *_fh;
+
+    uint8_t _ring[SPWFSAXX_TRACE_BUFFER_SIZE];
+    uint32_t _head;             // write position
+    uint32_t _tail;             // position of oldest record
+    uint32_t _used;             // number of bytes in use
+    uint32_t _last;             // position of last UART record (if `_last_valid`)
+    bool _last_valid;
+    uint32_t _last_us;          // timestamp of last byte stored into last UART record
+    volatile bool _paused;
+
+    void _event(spwf_trace_type_t type, uint16_t arg, const void *data, uint8_t len);
+    void _uart(spwf_trace_type_t type, const void *data, size_t size);
+    void _put(uint32_t pos, const void *data, uint32_t len);
+    void _get(uint32_t pos, void *data, uint32_t len) const;
+    bool _reserve(uint32_t len);
+    void _drop_oldest(void);
+};
+
+#endif // SPWF_TRACE_H
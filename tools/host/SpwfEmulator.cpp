@@ -0,0 +1,790 @@
+/* SPWFSAxx Devices
+ * Copyright (c) 2018 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SpwfSAInterface.h" /* for the AT strings of the configured expansion board */
+#include "SpwfEmulator.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <chrono>
+
+#define EMU_IP_ADDR     "192.168.1.100"
+#define EMU_GATEWAY     "192.168.1.1"
+#define EMU_NETMASK     "255.255.255.0"
+#define EMU_MAC_ADDR    "00:80:E1:00:00:01"
+#define EMU_FW_COMMIT   "c0ffee0"
+
+#define EMU_BOOT_MS     (5)     // delay between boot indications
+#define EMU_JOIN_MS     (10)    // delay between association indications
+
+/* Dialect specific replies not covered by `*_at_strings.h` */
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+#define EMU_VAR_FMT             "AT-S.Var:%s=%s\r\n"                        // see `SPWFXX_RECV_IP_ADDR`
+#define EMU_SOCKON_FMT          "AT-S.On:%s:%d\r\n"
+#define EMU_SOCKR_FMT           "AT-S.Reading:%u:%u\r\n"                    // "<received>:<cumulative>"
+#define EMU_PENDING_DATA_FMT    "+WIND:55:Pending Data::%d:%u:%u"           // see `SPWFXX_PENDING_DATA_FIELDS`
+#define EMU_SOCKET_CLOSED_FMT   "+WIND:58:Socket Closed:%d:0"               // see `SPWFXX_SOCKET_CLOSED_FIELDS`
+#define EMU_POWERON_FMT         "+WIND:1:Poweron:%s"
+#define EMU_COPYRIGHT           "+WIND:13:Copyright (c) 2012-2017 STMicroelectronics, Inc. All rights Reserved.:SPWF04Sx"
+#define EMU_SCAN_CMD            "AT+S.SCAN=s,"
+#define EMU_SOCKD_CLIENT_FMT    "+WIND:61:Incoming Socket Client:%s:%d:%d"  // see `SPWFXX_SOCKD_CLIENT_FIELDS`
+#define EMU_SOCKD_GONE_FMT      "+WIND:62:Socket Client Gone:%s:%d:%d"      // see `SPWFXX_SOCKD_CLIENT_FIELDS`
+#define EMU_SOCKD_DATA_FMT      "+WIND:64:Sockd Pending Data:%d:%d:%u:%u"   // see `SPWFXX_SOCKD_DATA_FIELDS`
+#define EMU_SOCKD_COUNT         (2)                                         // see `SpwfEmulator::_sockds`
+#define EMU_WSOCK_DATA_FMT      "+WIND:90:WebSocket Data:%d:1:%u:%u"        // see `SPWFXX_WSOCK_DATA_FIELDS` (one frame per message)
+#define EMU_WSOCK_CLOSED_FMT    "+WIND:89:WebSocket Closed:%d"              // see `SPWFXX_WSOCK_CLOSED_FIELDS`
+#else // MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW01M1
+#define EMU_VAR_FMT             "\r\n#  %s = %s\r\n"                        // see `SPWFXX_RECV_IP_ADDR`
+#define EMU_SOCKON_FMT          "%.0s\r\n ID: %02d\r\n"                     /* `addr` not echoed */
+#define EMU_SOCKR_FMT           ""                                          /* data only */
+#define EMU_PENDING_DATA_FMT    "+WIND:55:Pending Data:%d:%u"               // see `SPWFXX_PENDING_DATA_FIELDS`
+#define EMU_SOCKET_CLOSED_FMT   "+WIND:58:Socket Closed:%d"                 // see `SPWFXX_SOCKET_CLOSED_FIELDS`
+#define EMU_POWERON_FMT         "+WIND:1:Poweron (%s)"
+#define EMU_COPYRIGHT           "+WIND:13:ST SPWF01SA IWM: Copyright (c) 2012-2017 STMicroelectronics, Inc. All rights Reserved."
+#define EMU_SCAN_CMD            "AT+S.SCAN=a,s"
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW01M1
+
+static bool starts_with(const std::string &str, const char *prefix) {
+    return str.compare(0, strlen(prefix), prefix) == 0;
+}
+
+static std::string format(const char *fmt, ...) {
+    char buf[256];
+    va_list args;
+
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    return buf;
+}
+
+SpwfEmulator::SpwfEmulator()
+: _master(-1), _slave(-1), _running(false),
+  _baud(0), _latency_us(0), _peer_echo(true), _scan_count(0),
+  _in_reset(false), _boot_pending(false),
+  _rx_free_at(0), _tx_free_at(0), _connected(false),
+  _rx_bytes(0), _tx_bytes(0), _commands(0)
+{
+    _wake[0] = _wake[1] = -1;
+    for(int i = 0; i < 3; i++) _wind_masks[i] = 0;
+    for(int i = 0; i < 8; i++) {
+        _sockets[i].open = false;
+        _sockets[i].udp = false;
+    }
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    for(int i = 0; i < EMU_SOCKD_COUNT; i++) {
+        _sockds[i].open = false;
+        _sockds[i].port = 0;
+    }
+    for(int i = 0; i < SPWFSA_WSOCK_COUNT; i++) {
+        _wsocks[i].open = false;
+    }
+#endif
+}
+
+SpwfEmulator::~SpwfEmulator()
+{
+    stop();
+}
+
+bool SpwfEmulator::start(void)
+{
+    struct termios tio;
+    const char *name;
+
+    _master = posix_openpt(O_RDWR | O_NOCTTY);
+    if((_master < 0) || (grantpt(_master) != 0) || (unlockpt(_master) != 0)
+            || ((name = ptsname(_master)) == NULL)) {
+        perror("spwf_emulator: pseudo-terminal");
+        return false;
+    }
+    _device = name;
+
+    /* keep slave side open & raw (no echo of module output before the driver opens it) */
+    _slave = open(name, O_RDWR | O_NOCTTY);
+    if((_slave < 0) || (tcgetattr(_slave, &tio) != 0)) {
+        perror("spwf_emulator: pseudo-terminal slave");
+        return false;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(_slave, TCSANOW, &tio);
+
+    if(pipe(_wake) != 0) {
+        perror("spwf_emulator: pipe");
+        return false;
+    }
+
+    mbed_host_uart_device(name);
+    mbed_host_gpio_hook(&SpwfEmulator::_gpio_hook, this);
+
+    _running = true;
+    _thread = std::thread(&SpwfEmulator::_run, this);
+    return true;
+}
+
+void SpwfEmulator::stop(void)
+{
+    if(_running) {
+        _running = false;
+        _wakeup();
+        _thread.join();
+        mbed_host_gpio_hook(NULL, NULL);
+    }
+
+    if(_master >= 0) close(_master);
+    if(_slave >= 0) close(_slave);
+    if(_wake[0] >= 0) close(_wake[0]);
+    if(_wake[1] >= 0) close(_wake[1]);
+    _master = _slave = _wake[0] = _wake[1] = -1;
+}
+
+void SpwfEmulator::inject(const char *line, int delay_ms)
+{
+    std::string copy(line);
+
+    _schedule(delay_ms, true, [this, copy]() { _line(copy); });
+}
+
+void SpwfEmulator::peer_send(int id, const void *data, size_t len, int delay_ms)
+{
+    std::string copy((const char*)data, len);
+
+    _schedule(delay_ms, true, [this, id, copy]() { _pending_data(id, copy); });
+}
+
+void SpwfEmulator::peer_close(int id, int delay_ms)
+{
+    _schedule(delay_ms, true, [this, id]() {
+        if(!_sockets[id].open) return;
+
+        _sockets[id].open = false;
+        _sockets[id].pending.clear();
+        _line(format(EMU_SOCKET_CLOSED_FMT, id));
+    });
+}
+
+void SpwfEmulator::network_lost(int reconnect_ms)
+{
+    _schedule(0, true, [this]() {
+        _connected = false;
+        _line("+WIND:33:WiFi Network Lost");
+    });
+    _schedule(reconnect_ms, true, [this]() { _up(); });
+}
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+void SpwfEmulator::client_connect(int port, int cid, const char *addr, int delay_ms)
+{
+    std::string copy(addr);
+
+    _schedule(delay_ms, true, [this, port, cid, copy]() {
+        int sid = _sockd_find(port);
+        if((sid < 0) || (_sockds[sid].clients.count(cid) > 0)) return;
+
+        _sockds[sid].clients[cid].addr = copy;
+        _line(format(EMU_SOCKD_CLIENT_FMT, copy.c_str(), sid, cid));
+    });
+}
+
+void SpwfEmulator::client_send(int port, int cid, const void *data, size_t len, int delay_ms)
+{
+    std::string copy((const char*)data, len);
+
+    _schedule(delay_ms, true, [this, port, cid, copy]() {
+        int sid = _sockd_find(port);
+        if(sid >= 0) _sockd_pending_data(sid, cid, copy);
+    });
+}
+
+void SpwfEmulator::client_close(int port, int cid, int delay_ms)
+{
+    _schedule(delay_ms, true, [this, port, cid]() {
+        int sid = _sockd_find(port);
+        if((sid < 0) || (_sockds[sid].clients.count(cid) == 0)) return;
+
+        std::string addr = _sockds[sid].clients[cid].addr;
+        _sockds[sid].clients.erase(cid);
+        _line(format(EMU_SOCKD_GONE_FMT, addr.c_str(), sid, cid));
+    });
+}
+
+void SpwfEmulator::ws_peer_send(int id, const void *data, size_t len, int delay_ms)
+{
+    std::string copy((const char*)data, len);
+
+    _schedule(delay_ms, true, [this, id, copy]() {
+        if(!_wsocks[id].open) return;
+
+        _wsocks[id].pending += copy;
+        _line(format(EMU_WSOCK_DATA_FMT, id, (unsigned)copy.size(), (unsigned)_wsocks[id].pending.size()));
+    });
+}
+
+void SpwfEmulator::ws_peer_close(int id, int delay_ms)
+{
+    _schedule(delay_ms, true, [this, id]() {
+        if(!_wsocks[id].open) return;
+
+        _wsocks[id].open = false; // pending messages can still be read
+        _line(format(EMU_WSOCK_CLOSED_FMT, id));
+    });
+}
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+
+void SpwfEmulator::replay(const std::string &output, int delay_ms)
+{
+    _schedule(delay_ms, true, [this, output]() { _write(output); });
+}
+
+void SpwfEmulator::replay_reply(const char *command, const std::string &output)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _replies[command] = output;
+}
+
+void SpwfEmulator::_wakeup(void)
+{
+    char c = 0;
+
+    if(write(_wake[1], &c, 1) < 0) {
+        /* nothing to do: emulator thread is woken up anyway */
+    }
+}
+
+void SpwfEmulator::_schedule(int delay_ms, bool wind, std::function<void()> action)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        event_t event = { wind, action };
+        _events.insert(std::make_pair(_now_us() + (uint64_t)delay_ms * 1000, event));
+    }
+    _wakeup();
+}
+
+void SpwfEmulator::_gpio_hook(PinName pin, int value, void *context)
+{
+    SpwfEmulator *emu = (SpwfEmulator*)context;
+
+    if(pin != SPWFSAXX_RESET_PIN) return;
+
+    {
+        std::lock_guard<std::mutex> lock(emu->_mutex);
+        if(value == 0) {
+            emu->_in_reset = true;
+        } else if(emu->_in_reset) {
+            emu->_in_reset = false;
+            emu->_boot_pending = true;
+        }
+    }
+    emu->_wakeup();
+}
+
+uint64_t SpwfEmulator::_now_us(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SpwfEmulator::_sleep_until(uint64_t us)
+{
+    uint64_t now = _now_us();
+
+    if(us > now) std::this_thread::sleep_for(std::chrono::microseconds(us - now));
+}
+
+bool SpwfEmulator::_winds_off(void) const
+{
+    for(int i = 0; i < 3; i++) {
+        if(_wind_masks[i] == 0xFFFFFFFF) return true;
+    }
+    return false;
+}
+
+/* Run due events, return time (in ms) until the next one */
+int SpwfEmulator::_run_events(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    uint64_t now = _now_us();
+
+    for(auto it = _events.begin(); (it != _events.end()) && (it->first <= now); ) {
+        if(it->second.wind && _winds_off()) { // deferred until WINDs are switched on again
+            ++it;
+            continue;
+        }
+
+        std::function<void()> action = it->second.action;
+        _events.erase(it);
+
+        lock.unlock();
+        action();
+        lock.lock();
+
+        it = _events.begin();
+        now = _now_us();
+    }
+
+    for(auto it = _events.begin(); it != _events.end(); ++it) {
+        if(it->second.wind && _winds_off()) continue;
+        return (it->first > now) ? (int)((it->first - now + 999) / 1000) : 0;
+    }
+    return 100;
+}
+
+void SpwfEmulator::_run(void)
+{
+    char buf[4096];
+
+    while(_running) {
+        struct pollfd fds[2] = { { _master, POLLIN, 0 }, { _wake[0], POLLIN, 0 } };
+        bool in_reset, boot;
+
+        ::poll(fds, 2, _run_events());
+
+        if(fds[1].revents & POLLIN) {
+            if(read(_wake[0], buf, sizeof(buf)) < 0) continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            in_reset = _in_reset;
+            boot = _boot_pending;
+            _boot_pending = false;
+        }
+
+        if(fds[0].revents & POLLIN) {
+            ssize_t n = read(_master, buf, sizeof(buf));
+            if(n > 0) {
+                _rx_bytes += n;
+                _in.append(buf, n);
+
+                if(_baud > 0) { // time at which the last character has been received completely
+                    uint64_t now = _now_us();
+                    if(_rx_free_at < now) _rx_free_at = now;
+                    _rx_free_at += ((uint64_t)n * 10 * 1000000) / _baud;
+                }
+            }
+        }
+
+        if(in_reset) {
+            _in.clear();
+            continue;
+        }
+        if(boot) _boot();
+
+        while(_process_command());
+    }
+}
+
+/* Handle next complete command (incl. binary payload) in `_in` */
+bool SpwfEmulator::_process_command(void)
+{
+    size_t start = _in.find_first_not_of("\r\n");
+    size_t end, len = 0;
+
+    if(start == std::string::npos) {
+        _in.clear();
+        return false;
+    }
+    if((end = _in.find('\r', start)) == std::string::npos) return false;
+
+    std::string cmd = _in.substr(start, end - start);
+
+    /* commands followed by binary data of the length given as last argument */
+    if(starts_with(cmd, SPWFXX_SEND_SOCKW) || starts_with(cmd, SPWFXX_SEND_TLS_CERT)
+            || starts_with(cmd, SPWFXX_SEND_FS_APPEND)
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+            || starts_with(cmd, SPWFXX_SEND_SOCKD_W) || starts_with(cmd, SPWFXX_SEND_WSOCK_W)
+#endif
+       ) {
+        size_t comma = cmd.rfind(',');
+        if(comma != std::string::npos) len = strtoul(cmd.c_str() + comma + 1, NULL, 10);
+    }
+    if(_in.size() < (end + 1 + len)) return false;
+
+    std::string payload = _in.substr(end + 1, len);
+    _in.erase(0, end + 1 + len);
+
+    _sleep_until(_rx_free_at + _latency_us);
+    _commands++;
+    _handle(cmd, payload);
+    return true;
+}
+
+void SpwfEmulator::_handle(const std::string &cmd, const std::string &payload)
+{
+    unsigned id, amount;
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        for(auto it = _replies.begin(); it != _replies.end(); ++it) {
+            if(starts_with(cmd, it->first.c_str())) {
+                std::string reply = it->second;
+
+                lock.unlock();
+                _write(reply);
+                return;
+            }
+        }
+    }
+
+    if(cmd == SPWFXX_SEND_SW_RESET) { // no reply but boot indications
+        _boot();
+    } else if(starts_with(cmd, SPWFXX_SEND_WIND_OFF_HIGH)) {
+        _wind_masks[0] = strtoul(cmd.c_str() + sizeof(SPWFXX_SEND_WIND_OFF_HIGH) - 1, NULL, 16);
+        _ok();
+    } else if(starts_with(cmd, SPWFXX_SEND_WIND_OFF_MEDIUM)) {
+        _wind_masks[1] = strtoul(cmd.c_str() + sizeof(SPWFXX_SEND_WIND_OFF_MEDIUM) - 1, NULL, 16);
+        _ok();
+    } else if(starts_with(cmd, SPWFXX_SEND_WIND_OFF_LOW)) {
+        _wind_masks[2] = strtoul(cmd.c_str() + sizeof(SPWFXX_SEND_WIND_OFF_LOW) - 1, NULL, 16);
+        _ok();
+    } else if(starts_with(cmd, "AT+S.SCFG=")) {
+        size_t comma = cmd.find(',');
+        if(comma != std::string::npos) _config[cmd.substr(10, comma - 10)] = cmd.substr(comma + 1);
+        _ok();
+    } else if(starts_with(cmd, "AT+S.SSIDTXT=")) {
+        _ssid = cmd.substr(13);
+        _ok();
+    } else if(starts_with(cmd, "AT+S.STS=") || starts_with(cmd, "AT+S.GCFG=")) {
+        std::string name = cmd.substr(cmd.find('=') + 1);
+
+        if(name == "version") {
+            _var("version", format("%06u-" EMU_FW_COMMIT "-" SPWFXX_FW_PRODUCT, (unsigned)SPWFXX_FW_DATE_TESTED));
+        } else if(name == "ip_ipaddr") {
+            _var("ip_ipaddr", _connected ? EMU_IP_ADDR : "0.0.0.0");
+        } else if(name == "ip_gw") {
+            _var("ip_gw", EMU_GATEWAY);
+        } else if(name == "ip_netmask") {
+            _var("ip_netmask", EMU_NETMASK);
+        } else if(name == "nv_wifi_macaddr") {
+            _var("nv_wifi_macaddr", EMU_MAC_ADDR);
+        } else if(name.find("_speed") != std::string::npos) {
+            _var(name.c_str(), "115200");
+        } else {
+            _var(name.c_str(), (_config.count(name) > 0) ? _config[name] : "0");
+        }
+        _ok();
+    } else if(starts_with(cmd, "AT+S.PEERS=0,rx_rssi")) {
+        _var("0.rx_rssi", "-50");
+        _ok();
+    } else if(cmd == EMU_SCAN_CMD) {
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+        _write(format("AT-S.Parsing Networks:%u\r\n", _scan_count));
+#endif
+        for(unsigned i = 1; i <= _scan_count; i++) {
+            _write(format("%3u:\tBSS 00:80:E1:00:01:%02X CHAN: %02u RSSI: -%u SSID: 'spwf-ap-%u' CAPS: 0431 WPA2 \r\n",
+                          i, i & 0xFF, (i % 13) + 1, 40 + (i % 50), i));
+        }
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+        _write(std::string(SPWFXX_RECV_OK, sizeof(SPWFXX_RECV_OK) - 2) + "\r\n"); // list end is recognized by 'A'
+#else
+        _ok();
+#endif
+    } else if(starts_with(cmd, "AT+S.SOCKON=")) {
+        char addr[64], type;
+        int port;
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+        bool ok = (sscanf(cmd.c_str() + 12, "%63[^,],%d,%*[^,],%c", addr, &port, &type) == 3);
+#else
+        bool ok = (sscanf(cmd.c_str() + 12, "%63[^,],%d,%c", addr, &port, &type) == 3);
+#endif
+        for(id = 0; (id < 8) && _sockets[id].open; id++);
+
+        if(!ok || !_connected || (id >= 8)) {
+            _error(41, "Failed to open socket");
+        } else {
+            _sockets[id].open = true;
+            _sockets[id].udp = (type == 'u');
+            _sockets[id].pending.clear();
+            _write(format(EMU_SOCKON_FMT, addr, id));
+            _ok();
+        }
+    } else if(starts_with(cmd, SPWFXX_SEND_SOCKW)) {
+        if((sscanf(cmd.c_str() + sizeof(SPWFXX_SEND_SOCKW) - 1, "%u", &id) != 1) || (id >= 8) || !_sockets[id].open) {
+            _error(55, "Invalid socket ID");
+        } else {
+            if(_peer_echo) peer_send(id, payload.data(), payload.size());
+            _ok();
+        }
+    } else if(starts_with(cmd, SPWFXX_SEND_SOCKR)) {
+        if((sscanf(cmd.c_str() + sizeof(SPWFXX_SEND_SOCKR) - 1, "%u,%u", &id, &amount) != 2) || (id >= 8)) {
+            _error(55, "Invalid socket ID");
+        } else {
+            std::string &pending = _sockets[id].pending;
+            std::string data = pending.substr(0, amount);
+
+            pending.erase(0, data.size());
+            _write(format(EMU_SOCKR_FMT, (unsigned)data.size(), (unsigned)pending.size()) + data + SPWFXX_DATA_END);
+        }
+    } else if(starts_with(cmd, SPWFXX_SEND_SOCKQ)) {
+        if((sscanf(cmd.c_str() + sizeof(SPWFXX_SEND_SOCKQ) - 1, "%u", &id) != 1) || (id >= 8)) {
+            _error(55, "Invalid socket ID");
+        } else {
+            _write(format("\r\n" SPWFXX_RECV_DATALEN "%u\r\n", (unsigned)_sockets[id].pending.size()));
+            _ok();
+        }
+    } else if(starts_with(cmd, "AT+S.SOCKC=")) {
+        if((sscanf(cmd.c_str() + 11, "%u", &id) != 1) || (id >= 8)) {
+            _error(55, "Invalid socket ID");
+        } else {
+            _sockets[id].open = false;
+            _sockets[id].pending.clear();
+            _ok();
+        }
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    } else if(starts_with(cmd, "AT+S.SOCKD")) {
+        _handle_sockd(cmd, payload);
+    } else if(starts_with(cmd, "AT+S.WSOCK")) {
+        _handle_wsock(cmd, payload);
+#endif
+    } else { // e.g. `SPWFXX_SEND_FWCFG`, `SPWFXX_SEND_SAVE_SETTINGS`, "AT+S.WIFI=<0|1>"
+        _ok();
+    }
+}
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+/* Socket server commands: a TCP server per `SOCKDON`, clients are scripted (see `client_connect()`) */
+void SpwfEmulator::_handle_sockd(const std::string &cmd, const std::string &payload)
+{
+    int sid, cid, port;
+    unsigned amount;
+    char type;
+
+    if(starts_with(cmd, SPWFXX_SEND_SOCKD_ON)) {
+        bool ok = (sscanf(cmd.c_str() + sizeof(SPWFXX_SEND_SOCKD_ON) - 1, "%d,%c", &port, &type) == 2);
+
+        for(sid = 0; (sid < EMU_SOCKD_COUNT) && _sockds[sid].open; sid++);
+
+        if(!ok || (type != 't') || !_connected || (sid >= EMU_SOCKD_COUNT) || (_sockd_find(port) >= 0)) {
+            _error(41, "Failed to open socket");
+        } else {
+            _sockds[sid].open = true;
+            _sockds[sid].port = port;
+            _sockds[sid].clients.clear();
+            _write(format(EMU_SOCKON_FMT, format("%d", port).c_str(), sid));
+            _ok();
+        }
+        return;
+    }
+
+    /* remaining commands: "<sid>[,<cid>[,<amount>]]" */
+    int n = sscanf(cmd.c_str() + cmd.find('=') + 1, "%d,%d,%u", &sid, &cid, &amount);
+
+    if((n < 1) || ((unsigned)sid >= EMU_SOCKD_COUNT) || !_sockds[sid].open
+            || ((n > 1) && (_sockds[sid].clients.count(cid) == 0))) {
+        _error(55, "Invalid socket ID");
+    } else if(starts_with(cmd, SPWFXX_SEND_SOCKD_OFF)) { // also `SPWFXX_SEND_SOCKD_DISC` (client id given)
+        if(n > 1) {
+            _sockds[sid].clients.erase(cid);
+        } else {
+            _sockds[sid].open = false;
+            _sockds[sid].clients.clear();
+        }
+        _ok();
+    } else if(n < 2) {
+        _error(55, "Invalid socket ID");
+    } else if(starts_with(cmd, SPWFXX_SEND_SOCKD_W)) {
+        if(_peer_echo) client_send(_sockds[sid].port, cid, payload.data(), payload.size());
+        _ok();
+    } else if(starts_with(cmd, SPWFXX_SEND_SOCKD_Q)) {
+        _write(format("\r\n" SPWFXX_RECV_DATALEN "%u\r\n", (unsigned)_sockds[sid].clients[cid].pending.size()));
+        _ok();
+    } else if(starts_with(cmd, SPWFXX_SEND_SOCKD_R) && (n == 3)) {
+        std::string &pending = _sockds[sid].clients[cid].pending;
+        std::string data = pending.substr(0, amount);
+
+        pending.erase(0, data.size());
+        _write(format(EMU_SOCKR_FMT, (unsigned)data.size(), (unsigned)pending.size()) + data + SPWFXX_DATA_END);
+    } else {
+        _ok();
+    }
+}
+
+/* WebSocket client commands: the server echoes messages (or discards them, see `set_peer_echo()`) */
+void SpwfEmulator::_handle_wsock(const std::string &cmd, const std::string &payload)
+{
+    unsigned id, amount;
+
+    if(starts_with(cmd, SPWFXX_SEND_WSOCK_ON)) {
+        std::string host = cmd.substr(sizeof(SPWFXX_SEND_WSOCK_ON) - 1);
+
+        host = host.substr(0, host.find(','));
+        for(id = 0; (id < SPWFSA_WSOCK_COUNT) && (_wsocks[id].open || !_wsocks[id].pending.empty()); id++);
+
+        if(host.empty() || !_connected || (id >= SPWFSA_WSOCK_COUNT)) {
+            _error(41, "Failed to open socket");
+        } else {
+            _wsocks[id].open = true;
+            _write(format(EMU_SOCKON_FMT, host.c_str(), id));
+            _ok();
+        }
+    } else if((sscanf(cmd.c_str() + cmd.find('=') + 1, "%u", &id) != 1) || (id >= SPWFSA_WSOCK_COUNT)) {
+        _error(55, "Invalid socket ID");
+    } else if(starts_with(cmd, SPWFXX_SEND_WSOCK_OFF)) {
+        _wsocks[id].open = false;
+        _wsocks[id].pending.clear();
+        _ok();
+    } else if(starts_with(cmd, SPWFXX_SEND_WSOCK_W)) {
+        if(!_wsocks[id].open) {
+            _error(55, "Invalid socket ID");
+        } else {
+            if(_peer_echo) ws_peer_send(id, payload.data(), payload.size());
+            _ok();
+        }
+    } else if(starts_with(cmd, SPWFXX_SEND_WSOCK_R)
+              && (sscanf(cmd.c_str() + sizeof(SPWFXX_SEND_WSOCK_R) - 1, "%*u,%u", &amount) == 1)) {
+        std::string &pending = _wsocks[id].pending;
+        std::string data = pending.substr(0, amount);
+
+        pending.erase(0, data.size());
+        _write(format(EMU_SOCKR_FMT, (unsigned)data.size(), (unsigned)pending.size()) + data + SPWFXX_DATA_END);
+    } else {
+        _ok();
+    }
+}
+
+int SpwfEmulator::_sockd_find(int port) const
+{
+    for(int sid = 0; sid < EMU_SOCKD_COUNT; sid++) {
+        if(_sockds[sid].open && (_sockds[sid].port == port)) return sid;
+    }
+    return -1;
+}
+
+void SpwfEmulator::_sockd_pending_data(int sid, int cid, const std::string &data)
+{
+    if(_sockds[sid].clients.count(cid) == 0) return;
+
+    std::string &pending = _sockds[sid].clients[cid].pending;
+
+    pending += data;
+    _line(format(EMU_SOCKD_DATA_FMT, sid, cid, (unsigned)data.size(), (unsigned)pending.size()));
+}
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+
+/* Module (re)start: closes all sockets, joins the network in station mode */
+void SpwfEmulator::_boot(void)
+{
+    std::string version = format("%06u-" EMU_FW_COMMIT "-" SPWFXX_FW_PRODUCT, (unsigned)SPWFXX_FW_DATE_TESTED);
+    bool join = (_config["wifi_mode"] == "1") && !_ssid.empty();
+    std::string ssid = _ssid;
+    int delay = 0;
+
+    _in.clear();
+    _connected = false;
+    for(int i = 0; i < 8; i++) {
+        _sockets[i].open = false;
+        _sockets[i].pending.clear();
+    }
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    for(int i = 0; i < EMU_SOCKD_COUNT; i++) {
+        _sockds[i].open = false;
+        _sockds[i].clients.clear();
+    }
+    for(int i = 0; i < SPWFSA_WSOCK_COUNT; i++) {
+        _wsocks[i].open = false;
+        _wsocks[i].pending.clear();
+    }
+#endif
+
+    _schedule(delay += EMU_BOOT_MS, false, [this, version]() { _line(format(EMU_POWERON_FMT, version.c_str())); });
+    _schedule(delay, false, [this]() { _line(EMU_COPYRIGHT); });
+    _schedule(delay, false, [this]() { _line("+WIND:0:Console active"); });
+    _schedule(delay += EMU_BOOT_MS, false, [this]() { _line("+WIND:32:WiFi Hardware Started"); });
+
+    if(join) {
+        _schedule(delay += EMU_JOIN_MS, true, [this]() { _line("+WIND:21:WiFi Scanning"); });
+        _schedule(delay += EMU_JOIN_MS, true, [this]() { _line("+WIND:35:WiFi Scan Complete (0x0)"); });
+        _schedule(delay, true, [this]() { _line("+WIND:19:WiFi Join:" EMU_MAC_ADDR); });
+        _schedule(delay += EMU_JOIN_MS, true, [this, ssid]() {
+            _line("+WIND:25:WiFi Association with '" + ssid + "' successful");
+        });
+        _schedule(delay += EMU_JOIN_MS, true, [this]() { _up(); });
+    }
+}
+
+void SpwfEmulator::_up(void)
+{
+    _connected = true;
+    _line("+WIND:24:WiFi Up:" EMU_IP_ADDR);
+}
+
+/* Write to the driver, paced to the configured baud rate */
+void SpwfEmulator::_write(const std::string &out)
+{
+    const size_t chunk = (_baud > 0) ? 16 : out.size();
+
+    for(size_t pos = 0; pos < out.size(); ) {
+        size_t len = std::min(chunk, out.size() - pos);
+
+        if(_baud > 0) { // deliver characters once they would have been transmitted completely
+            uint64_t now = _now_us();
+            if(_tx_free_at < now) _tx_free_at = now;
+            _tx_free_at += ((uint64_t)len * 10 * 1000000) / _baud;
+            _sleep_until(_tx_free_at);
+        }
+
+        ssize_t n = ::write(_master, out.data() + pos, len);
+        if(n <= 0) return;
+
+        pos += n;
+        _tx_bytes += n;
+    }
+}
+
+void SpwfEmulator::_line(const std::string &line)
+{
+    _write(line + "\r\n");
+}
+
+void SpwfEmulator::_ok(void)
+{
+    _write(SPWFXX_DATA_END);
+}
+
+void SpwfEmulator::_error(int nr, const char *msg)
+{
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    _write(format(SPWFXX_OOB_ERROR "%d:%s\r\n", nr, msg));
+#else
+    (void)nr;
+    _write(format("\r\n" SPWFXX_OOB_ERROR " %s\r\n", msg));
+#endif
+}
+
+void SpwfEmulator::_var(const char *name, const std::string &value)
+{
+    _write(format(EMU_VAR_FMT, name, value.c_str()));
+}
+
+void SpwfEmulator::_pending_data(int id, const std::string &data)
+{
+    if(!_sockets[id].open) return;
+
+    _sockets[id].pending += data;
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    _line(format(EMU_PENDING_DATA_FMT, id, (unsigned)data.size(), (unsigned)_sockets[id].pending.size()));
+#else
+    _line(format(EMU_PENDING_DATA_FMT, id, (unsigned)_sockets[id].pending.size()));
+#endif
+}
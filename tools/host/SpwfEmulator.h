@@ -0,0 +1,178 @@
+/* SPWFSAxx Devices
+ * Copyright (c) 2018 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SPWF_EMULATOR_H
+#define SPWF_EMULATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "mbed.h"
+
+/* Scriptable SPWFSA01/SPWFSA04 module emulator on a pseudo-terminal
+ *
+ * Speaks the AT dialect of the expansion board the emulator is compiled for
+ * (`MBED_CONF_IDW0XX1_EXPANSION_BOARD`), using the strings of the corresponding `*_at_strings.h`.
+ * Sockets are connected to an emulated peer which either echoes or discards the data it gets,
+ * asynchronous indications ("+WIND:...") are only emitted while they are not switched off by the driver.
+ *
+ * Note: `start()` registers the emulator's pseudo-terminal & reset pin with the host mbed shim,
+ *       so it has to be called before constructing the `SpwfSAInterface`
+ */
+class SpwfEmulator {
+public:
+    SpwfEmulator();
+    ~SpwfEmulator();
+
+    /* configuration (call before `start()`, `set_peer_echo()` also later on) */
+    void set_baud(int baud) { _baud = baud; }                   // UART timing (0: none)
+    void set_latency(int us) { _latency_us = us; }              // processing time per command
+    void set_peer_echo(bool echo) { _peer_echo = echo; }        // peer echoes (default) or discards data
+    void set_scan_results(unsigned count) { _scan_count = count; }
+
+    bool start(void);
+    void stop(void);
+    const char *device(void) const { return _device.c_str(); }
+
+    /* script: asynchronous events, `delay_ms` counting from now */
+    void inject(const char *line, int delay_ms = 0);            // e.g. "+WIND:33:WiFi Network Lost" (w/o "\r\n")
+    void peer_send(int id, const void *data, size_t len, int delay_ms = 0); // data for socket `id` ("+WIND:55")
+    void peer_close(int id, int delay_ms = 0);                  // peer closes socket `id` ("+WIND:58")
+    void network_lost(int reconnect_ms);                        // "+WIND:33", "+WIND:24" after `reconnect_ms`
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    /* script: clients of the socket server listening on `port` (client ids `cid` are chosen by the script) */
+    void client_connect(int port, int cid, const char *addr, int delay_ms = 0); // "+WIND:61"
+    void client_send(int port, int cid, const void *data, size_t len, int delay_ms = 0); // "+WIND:64"
+    void client_close(int port, int cid, int delay_ms = 0);    // "+WIND:62"
+
+    /* script: WebSocket servers (messages sent by the driver are echoed if `set_peer_echo()`) */
+    void ws_peer_send(int id, const void *data, size_t len, int delay_ms = 0); // message for connection `id` ("+WIND:90")
+    void ws_peer_close(int id, int delay_ms = 0);               // server closes connection `id` ("+WIND:89")
+#endif
+
+    /* replay of recorded module output (see `corpora/`) */
+    void replay(const std::string &output, int delay_ms = 0);   // e.g. recorded WINDs, sent as a whole
+    void replay_reply(const char *command, const std::string &output); // reply to commands starting with `command`
+
+    /* counters */
+    uint64_t rx_bytes(void) const { return _rx_bytes; }         // received from the driver
+    uint64_t tx_bytes(void) const { return _tx_bytes; }         // sent to the driver
+    unsigned commands(void) const { return _commands; }
+
+private:
+    struct socket_t {
+        bool open;
+        bool udp;
+        std::string pending;                                    // peer data not yet read by the driver
+    };
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    struct sockd_client_t {
+        std::string addr;
+        std::string pending;                                    // client data not yet read by the driver
+    };
+
+    struct sockd_t {
+        bool open;
+        int port;
+        std::map<int, sockd_client_t> clients;                  // by client id
+    };
+
+    struct wsock_t {
+        bool open;
+        std::string pending;                                    // messages not yet read by the driver
+    };
+#endif
+
+    struct event_t {
+        bool wind;                                              // subject to the driver's WIND masks
+        std::function<void()> action;
+    };
+
+    void _run(void);
+    void _wakeup(void);
+    void _schedule(int delay_ms, bool wind, std::function<void()> action);
+    int _run_events(void);
+    bool _process_command(void);
+    void _handle(const std::string &cmd, const std::string &payload);
+    void _boot(void);
+    void _up(void);
+
+    void _write(const std::string &out);
+    void _line(const std::string &line);
+    void _ok(void);
+    void _error(int nr, const char *msg);
+    void _var(const char *name, const std::string &value);
+    void _pending_data(int id, const std::string &data);
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    void _handle_sockd(const std::string &cmd, const std::string &payload);
+    int _sockd_find(int port) const;
+    void _sockd_pending_data(int sid, int cid, const std::string &data);
+    void _handle_wsock(const std::string &cmd, const std::string &payload);
+#endif
+
+    bool _winds_off(void) const;
+    static void _gpio_hook(PinName pin, int value, void *context);
+    static uint64_t _now_us(void);
+    void _sleep_until(uint64_t us);
+
+    std::string _device;
+    int _master;
+    int _slave;
+    int _wake[2];
+    std::thread _thread;
+    volatile bool _running;
+
+    /* configuration */
+    int _baud;
+    int _latency_us;
+    volatile bool _peer_echo;
+    unsigned _scan_count;
+
+    /* shared with the script API & reset pin hook (protected by `_mutex`) */
+    std::mutex _mutex;
+    std::multimap<uint64_t, event_t> _events;
+    std::map<std::string, std::string> _replies;
+    bool _in_reset;
+    bool _boot_pending;
+
+    /* emulator thread only */
+    std::string _in;
+    uint64_t _rx_free_at;
+    uint64_t _tx_free_at;
+    socket_t _sockets[8];                                       // `SPWFSA_SOCKET_COUNT`
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    sockd_t _sockds[2];                                         // socket servers
+    wsock_t _wsocks[4];                                         // `SPWFSA_WSOCK_COUNT`
+#endif
+    std::map<std::string, std::string> _config;
+    std::string _ssid;
+    bool _connected;
+    uint32_t _wind_masks[3];
+
+    volatile uint64_t _rx_bytes;
+    volatile uint64_t _tx_bytes;
+    volatile unsigned _commands;
+};
+
+#endif // SPWF_EMULATOR_H
@@ -0,0 +1,76 @@
+/* SPWFSAxx Devices
+ * Copyright (c) 2018 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_HOST_ATCMDPARSER_H
+#define MBED_HOST_ATCMDPARSER_H
+
+#include "mbed.h"
+
+namespace mbed {
+
+/* Re-implementation of mbed OS' `ATCmdParser` (same matching semantics: newline simplification,
+ * OOB prefixes checked on every received character, `%n` based line matching) */
+class ATCmdParser {
+public:
+    ATCmdParser(FileHandle *fh, const char *output_delimiter = "\r",
+                int buffer_size = 256, int timeout = 8000, bool debug = false);
+    ~ATCmdParser();
+
+    void set_timeout(int timeout) { _timeout = timeout; }
+    void setTimeout(int timeout) { set_timeout(timeout); }
+    void set_delimiter(const char *output_delimiter);
+    void setDelimiter(const char *output_delimiter) { set_delimiter(output_delimiter); }
+    void debug_on(uint8_t on) { _dbg_on = (on) ? 1 : 0; }
+    void debugOn(uint8_t on) { debug_on(on); }
+
+    bool send(const char *command, ...);
+    bool vsend(const char *command, va_list args);
+    bool recv(const char *response, ...);
+    bool vrecv(const char *response, va_list args);
+
+    int putc(char c);
+    int getc();
+    int write(const char *data, int size);
+    int read(char *data, int size);
+
+    void oob(const char *prefix, mbed::Callback<void()> func);
+    bool process_oob(void);
+    void flush();
+    void abort();
+
+private:
+    struct oob_entry {
+        unsigned len;
+        const char *prefix;
+        mbed::Callback<void()> cb;
+        oob_entry *next;
+    };
+
+    FileHandle *_fh;
+    int _buffer_size;
+    char *_buffer;
+    int _timeout;
+    const char *_output_delimiter;
+    int _output_delim_length;
+    int _dbg_on;
+    bool _aborted;
+    int _in_prev;
+    oob_entry *_oobs;
+};
+
+} // namespace mbed
+
+#endif // MBED_HOST_ATCMDPARSER_H
@@ -0,0 +1,479 @@
+/* SPWFSAxx Devices
+ * Copyright (c) 2018 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Host (Linux) shim of the subset of the mbed OS 5 API used by the driver
+ *
+ * Note: only meant for running the driver against the module emulator (see `tools/host/README.md`),
+ *       `UARTSerial` talks to the (pseudo) terminal passed to `mbed_host_uart_device()`
+ */
+
+#ifndef MBED_HOST_H
+#define MBED_HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/types.h>
+
+#include <new>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+/* target configuration (normally generated into `mbed_config.h`) */
+#define MBED_MAJOR_VERSION  5
+#define MBED_MINOR_VERSION  9
+#define MBED_PATCH_VERSION  0
+#define MBED_ENCODE_VERSION(major, minor, patch) ((major)*10000 + (minor)*100 + (patch))
+#define MBED_VERSION MBED_ENCODE_VERSION(MBED_MAJOR_VERSION, MBED_MINOR_VERSION, MBED_PATCH_VERSION)
+
+#define MBED_CONF_RTOS_PRESENT              1
+#define DEVICE_SERIAL_FC                    1
+#define TARGET_FF_ARDUINO                   1
+#define TARGET_FF_MORPHO                    1
+
+#define MBED_CONF_IDW0XX1_TX                PA_9
+#define MBED_CONF_IDW0XX1_RX                PA_10
+#define MBED_CONF_IDW0XX1_PROVIDE_DEFAULT   0
+#if !defined(MBED_CONF_IDW0XX1_EXPANSION_BOARD)
+#error MBED_CONF_IDW0XX1_EXPANSION_BOARD must be defined on the command line (IDW01M1 or IDW04A1)
+#endif
+
+#define MBED_ASSERT(expr) ((expr) ? (void)0 : mbed_assert_internal(#expr, __FILE__, __LINE__))
+void mbed_assert_internal(const char *expr, const char *file, int line);
+
+typedef enum {
+    PA_9, PA_10, PC_8, PC_12, A3, D7,
+    NC = (int)0xFFFFFFFF
+} PinName;
+
+/* Hooks for the module emulator */
+void mbed_host_uart_device(const char *path);                                   // device opened by `UARTSerial`
+void mbed_host_gpio_hook(void (*hook)(PinName pin, int value, void *context), void *context);
+
+namespace mbed {
+
+template <typename F> class Callback;
+
+/* Note: unlike mbed's `Callback` it might allocate (`std::function`) */
+template <typename R, typename... A>
+class Callback<R(A...)> {
+public:
+    Callback() {}
+    Callback(R (*func)(A...)) {
+        if(func != NULL) _func = func;
+    }
+    template <typename T, typename U>
+    Callback(U *obj, R (T::*method)(A...)) : _func([obj, method](A... args) { return (obj->*method)(args...); }) {}
+    template <typename T, typename U>
+    Callback(U *obj, R (*func)(T*, A...)) : _func([obj, func](A... args) { return func(obj, args...); }) {}
+
+    R call(A... args) const { return _func(args...); }
+    R operator()(A... args) const { return _func(args...); }
+    operator bool() const { return (bool)_func; }
+
+private:
+    std::function<R(A...)> _func;
+};
+
+template <typename T, typename U, typename R, typename... A>
+Callback<R(A...)> callback(U *obj, R (T::*method)(A...)) {
+    return Callback<R(A...)>(obj, method);
+}
+
+class FileHandle {
+public:
+    virtual ~FileHandle() {}
+    virtual ssize_t read(void *buffer, size_t size) = 0;
+    virtual ssize_t write(const void *buffer, size_t size) = 0;
+    virtual off_t seek(off_t offset, int whence = SEEK_SET) = 0;
+    virtual int close() = 0;
+    virtual int sync() { return 0; }
+    virtual int isatty() { return 0; }
+    virtual off_t size() { return -1; }
+    virtual int set_blocking(bool blocking) { return blocking ? 0 : -1; }
+    virtual bool is_blocking() const { return true; }
+    virtual short poll(short events) const { return events & (POLLIN | POLLOUT); }
+    virtual bool readable() const { return poll(POLLIN) & POLLIN; }
+    virtual bool writable() const { return poll(POLLOUT) & POLLOUT; }
+    virtual void sigio(Callback<void()> func) { (void)func; }
+};
+
+class SerialBase {
+public:
+    enum Flow { Disabled = 0, RTS, CTS, RTSCTS };
+};
+
+/* Buffered serial on a host (pseudo) terminal
+ *
+ * Note: a reader thread plays the role of the RX interrupt (filling the RX buffer & calling `sigio`)
+ */
+class UARTSerial : public FileHandle {
+public:
+    UARTSerial(PinName tx, PinName rx, int baud);
+    virtual ~UARTSerial();
+
+    virtual ssize_t read(void *buffer, size_t size);
+    virtual ssize_t write(const void *buffer, size_t size);
+    virtual off_t seek(off_t offset, int whence = SEEK_SET) { (void)offset; (void)whence; return -1; }
+    virtual int close();
+    virtual int isatty() { return 1; }
+    virtual int set_blocking(bool blocking) { _blocking = blocking; return 0; }
+    virtual bool is_blocking() const { return _blocking; }
+    virtual short poll(short events) const;
+    virtual void sigio(Callback<void()> func);
+
+    void set_baud(int baud);
+    void set_flow_control(SerialBase::Flow type, PinName flow1 = NC, PinName flow2 = NC);
+
+private:
+    void _rx_thread(void);
+
+    int _fd;
+    bool _blocking;
+    volatile bool _running;
+    void *_thread;
+    mutable std::mutex _mutex;
+    Callback<void()> _sigio_cb;
+    uint8_t _rxbuf[4096];
+    size_t _rx_head, _rx_cnt;
+};
+
+class DigitalOut {
+public:
+    DigitalOut(PinName pin, int value = 0) : _pin(pin), _value(value) {}
+    void write(int value);
+    int read() { return _value; }
+    DigitalOut &operator=(int value) { write(value); return *this; }
+
+private:
+    PinName _pin;
+    int _value;
+};
+
+class Timer {
+public:
+    Timer() : _running(false), _start_us(0), _time_us(0) {}
+    void start();
+    void stop();
+    void reset();
+    float read() { return (float)read_high_resolution_us() / 1000000.0f; }
+    int read_ms() { return (int)(read_high_resolution_us() / 1000); }
+    int read_us() { return (int)read_high_resolution_us(); }
+    uint64_t read_high_resolution_us();
+
+private:
+    bool _running;
+    uint64_t _start_us;
+    uint64_t _time_us;
+};
+
+uint32_t us_ticker_read(void);
+void core_util_critical_section_enter(void);
+void core_util_critical_section_exit(void);
+
+} // namespace mbed
+
+using namespace mbed;
+
+void wait(float s);
+void wait_ms(int ms);
+void wait_us(int us);
+void error(const char *format, ...);
+
+namespace rtos {
+
+/* Note: CMSIS-RTOS mutexes are recursive */
+class Mutex {
+public:
+    void lock() { _mutex.lock(); }
+    bool trylock() { return _mutex.try_lock(); }
+    void unlock() { _mutex.unlock(); }
+
+private:
+    std::recursive_mutex _mutex;
+};
+
+class ScopedMutexLock {
+public:
+    ScopedMutexLock(Mutex &mutex) : _mutex(mutex) { _mutex.lock(); }
+    ~ScopedMutexLock() { _mutex.unlock(); }
+
+private:
+    Mutex &_mutex;
+};
+
+class EventFlags {
+public:
+    EventFlags() : _flags(0) {}
+    uint32_t set(uint32_t flags);
+    uint32_t clear(uint32_t flags = 0x7fffffff);
+    uint32_t get() const;
+    uint32_t wait_any(uint32_t flags = 0, uint32_t millisec = 0xFFFFFFFFU, bool clear = true);
+    uint32_t wait_all(uint32_t flags = 0, uint32_t millisec = 0xFFFFFFFFU, bool clear = true);
+
+private:
+    uint32_t _wait(uint32_t flags, uint32_t millisec, bool clear, bool all);
+
+    mutable std::mutex _mutex;
+    std::condition_variable _cond;
+    uint32_t _flags;
+};
+
+namespace Kernel {
+uint64_t get_ms_count(void);
+}
+
+} // namespace rtos
+
+using namespace rtos;
+
+#define osWaitForever       0xFFFFFFFFU
+#define osFlagsError        0x80000000U
+#define osFlagsErrorTimeout 0xFFFFFFFEU
+
+/* Network socket API */
+typedef int nsapi_error_t;
+typedef int nsapi_size_or_error_t;
+typedef unsigned int nsapi_size_t;
+
+enum nsapi_error {
+    NSAPI_ERROR_OK                  =  0,
+    NSAPI_ERROR_WOULD_BLOCK         = -3001,
+    NSAPI_ERROR_UNSUPPORTED         = -3002,
+    NSAPI_ERROR_PARAMETER           = -3003,
+    NSAPI_ERROR_NO_CONNECTION       = -3004,
+    NSAPI_ERROR_NO_SOCKET           = -3005,
+    NSAPI_ERROR_NO_ADDRESS          = -3006,
+    NSAPI_ERROR_NO_MEMORY           = -3007,
+    NSAPI_ERROR_NO_SSID             = -3008,
+    NSAPI_ERROR_DNS_FAILURE         = -3009,
+    NSAPI_ERROR_DHCP_FAILURE        = -3010,
+    NSAPI_ERROR_AUTH_FAILURE        = -3011,
+    NSAPI_ERROR_DEVICE_ERROR        = -3012,
+    NSAPI_ERROR_IN_PROGRESS         = -3013,
+    NSAPI_ERROR_ALREADY             = -3014,
+    NSAPI_ERROR_IS_CONNECTED        = -3015,
+    NSAPI_ERROR_CONNECTION_LOST     = -3016,
+    NSAPI_ERROR_CONNECTION_TIMEOUT  = -3017,
+    NSAPI_ERROR_ADDRESS_IN_USE      = -3018,
+    NSAPI_ERROR_TIMEOUT             = -3019,
+    NSAPI_ERROR_BUSY                = -3020,
+};
+
+typedef enum nsapi_version { NSAPI_UNSPEC, NSAPI_IPv4, NSAPI_IPv6 } nsapi_version_t;
+typedef enum nsapi_protocol { NSAPI_TCP, NSAPI_UDP } nsapi_protocol_t;
+
+typedef enum nsapi_security {
+    NSAPI_SECURITY_NONE = 0, NSAPI_SECURITY_WEP, NSAPI_SECURITY_WPA, NSAPI_SECURITY_WPA2,
+    NSAPI_SECURITY_WPA_WPA2, NSAPI_SECURITY_PAP, NSAPI_SECURITY_CHAP, NSAPI_SECURITY_EAP_TLS,
+    NSAPI_SECURITY_PEAP, NSAPI_SECURITY_UNKNOWN = 0xFF
+} nsapi_security_t;
+
+typedef enum nsapi_connection_status {
+    NSAPI_STATUS_LOCAL_UP, NSAPI_STATUS_GLOBAL_UP, NSAPI_STATUS_DISCONNECTED, NSAPI_STATUS_CONNECTING,
+    NSAPI_STATUS_ERROR_UNSUPPORTED = NSAPI_ERROR_UNSUPPORTED
+} nsapi_connection_status_t;
+
+typedef enum nsapi_event { NSAPI_EVENT_CONNECTION_STATUS_CHANGE = 0 } nsapi_event_t;
+
+typedef enum nsapi_option {
+    NSAPI_REUSEADDR, NSAPI_KEEPALIVE, NSAPI_KEEPIDLE, NSAPI_KEEPINTVL, NSAPI_LINGER, NSAPI_SNDBUF, NSAPI_RCVBUF
+} nsapi_option_t;
+
+enum nsapi_level { NSAPI_STACK, NSAPI_SOCKET = 7000 };
+
+typedef void *nsapi_socket_t;
+
+typedef struct nsapi_wifi_ap {
+    char ssid[33];
+    uint8_t bssid[6];
+    nsapi_security_t security;
+    int8_t rssi;
+    uint8_t channel;
+} nsapi_wifi_ap_t;
+
+/* Note: IPv4 only */
+class SocketAddress {
+public:
+    SocketAddress(const char *addr = NULL, uint16_t port = 0) : _port(port) {
+        set_ip_address(addr);
+    }
+    bool set_ip_address(const char *addr);
+    void set_port(uint16_t port) { _port = port; }
+    const char *get_ip_address() const { return (_ip[0] != '\0') ? _ip : NULL; }
+    uint16_t get_port() const { return _port; }
+    nsapi_version_t get_ip_version() const { return (_ip[0] != '\0') ? NSAPI_IPv4 : NSAPI_UNSPEC; }
+    operator bool() const { return _ip[0] != '\0'; }
+    bool operator==(const SocketAddress &other) const { return (strcmp(_ip, other._ip) == 0) && (_port == other._port); }
+    bool operator!=(const SocketAddress &other) const { return !(*this == other); }
+
+private:
+    char _ip[16];
+    uint16_t _port;
+};
+
+class WiFiAccessPoint {
+public:
+    WiFiAccessPoint() { memset(&_ap, 0, sizeof(_ap)); }
+    WiFiAccessPoint(nsapi_wifi_ap_t ap) : _ap(ap) {}
+    const char *get_ssid() const { return _ap.ssid; }
+    const uint8_t *get_bssid() const { return _ap.bssid; }
+    nsapi_security_t get_security() const { return _ap.security; }
+    int8_t get_rssi() const { return _ap.rssi; }
+    uint8_t get_channel() const { return _ap.channel; }
+
+private:
+    nsapi_wifi_ap_t _ap;
+};
+
+class NetworkStack {
+public:
+    virtual ~NetworkStack() {}
+    virtual nsapi_error_t gethostbyname(const char *host, SocketAddress *address, nsapi_version_t version = NSAPI_UNSPEC) {
+        (void)version;
+        return address->set_ip_address(host) ? NSAPI_ERROR_OK : NSAPI_ERROR_DNS_FAILURE;
+    }
+    virtual nsapi_error_t add_dns_server(const SocketAddress &address) { (void)address; return NSAPI_ERROR_UNSUPPORTED; }
+    virtual nsapi_error_t setsockopt(nsapi_socket_t handle, int level, int optname, const void *optval, unsigned optlen) {
+        (void)handle; (void)level; (void)optname; (void)optval; (void)optlen;
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+    virtual nsapi_error_t getsockopt(nsapi_socket_t handle, int level, int optname, void *optval, unsigned *optlen) {
+        (void)handle; (void)level; (void)optname; (void)optval; (void)optlen;
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+protected:
+    virtual nsapi_error_t socket_open(nsapi_socket_t *handle, nsapi_protocol_t proto) = 0;
+    virtual nsapi_error_t socket_close(nsapi_socket_t handle) = 0;
+    virtual nsapi_error_t socket_bind(nsapi_socket_t handle, const SocketAddress &address) = 0;
+    virtual nsapi_error_t socket_listen(nsapi_socket_t handle, int backlog) = 0;
+    virtual nsapi_error_t socket_connect(nsapi_socket_t handle, const SocketAddress &address) = 0;
+    virtual nsapi_error_t socket_accept(nsapi_socket_t server, nsapi_socket_t *handle, SocketAddress *address) = 0;
+    virtual nsapi_size_or_error_t socket_send(nsapi_socket_t handle, const void *data, nsapi_size_t size) = 0;
+    virtual nsapi_size_or_error_t socket_recv(nsapi_socket_t handle, void *data, nsapi_size_t size) = 0;
+    virtual nsapi_size_or_error_t socket_sendto(nsapi_socket_t handle, const SocketAddress &address, const void *data, nsapi_size_t size) = 0;
+    virtual nsapi_size_or_error_t socket_recvfrom(nsapi_socket_t handle, SocketAddress *address, void *data, nsapi_size_t size) = 0;
+    virtual void socket_attach(nsapi_socket_t handle, void (*callback)(void *), void *data) = 0;
+
+    friend class TCPSocket;
+    friend class TCPServer;
+};
+
+/* Note: thin wrapper only, no blocking/timeout handling of its own (see `SPWFSA_SOCKOPT_RCVTIMEO`) */
+class TCPSocket {
+public:
+    TCPSocket() : _stack(NULL), _handle(NULL) {}
+    ~TCPSocket() { close(); }
+
+    nsapi_error_t open(NetworkStack *stack) {
+        _stack = stack;
+        return stack->socket_open(&_handle, NSAPI_TCP);
+    }
+    nsapi_error_t close() {
+        nsapi_error_t ret = NSAPI_ERROR_NO_SOCKET;
+        if(_handle != NULL) ret = _stack->socket_close(_handle);
+        _handle = NULL;
+        return ret;
+    }
+    nsapi_error_t connect(const SocketAddress &address) { return _stack->socket_connect(_handle, address); }
+    nsapi_size_or_error_t send(const void *data, nsapi_size_t size) { return _stack->socket_send(_handle, data, size); }
+    nsapi_size_or_error_t recv(void *data, nsapi_size_t size) { return _stack->socket_recv(_handle, data, size); }
+    nsapi_error_t setsockopt(int level, int optname, const void *optval, unsigned optlen) {
+        return _stack->setsockopt(_handle, level, optname, optval, optlen);
+    }
+    nsapi_socket_t handle() const { return _handle; }    // host shim only (e.g. for `SpwfSAInterface::poll()`)
+
+private:
+    NetworkStack *_stack;
+    nsapi_socket_t _handle;
+
+    friend class TCPServer;
+};
+
+/* Note: thin wrapper only, `accept()` does not block (see `SpwfSAInterface::poll()`) */
+class TCPServer {
+public:
+    TCPServer() : _stack(NULL), _handle(NULL) {}
+    ~TCPServer() { close(); }
+
+    nsapi_error_t open(NetworkStack *stack) {
+        _stack = stack;
+        return stack->socket_open(&_handle, NSAPI_TCP);
+    }
+    nsapi_error_t close() {
+        nsapi_error_t ret = NSAPI_ERROR_NO_SOCKET;
+        if(_handle != NULL) ret = _stack->socket_close(_handle);
+        _handle = NULL;
+        return ret;
+    }
+    nsapi_error_t bind(uint16_t port) { return _stack->socket_bind(_handle, SocketAddress(NULL, port)); }
+    nsapi_error_t listen(int backlog = 1) { return _stack->socket_listen(_handle, backlog); }
+    nsapi_error_t accept(TCPSocket *connection, SocketAddress *address = NULL) {
+        nsapi_socket_t handle;
+        nsapi_error_t ret = _stack->socket_accept(_handle, &handle, address);
+
+        if(ret == NSAPI_ERROR_OK) {
+            connection->close();
+            connection->_stack = _stack;
+            connection->_handle = handle;
+        }
+        return ret;
+    }
+    nsapi_socket_t handle() const { return _handle; }    // host shim only (e.g. for `SpwfSAInterface::poll()`)
+
+private:
+    NetworkStack *_stack;
+    nsapi_socket_t _handle;
+};
+
+class NetworkInterface {
+public:
+    virtual ~NetworkInterface() {}
+    virtual nsapi_error_t gethostbyname(const char *host, SocketAddress *address, nsapi_version_t version = NSAPI_UNSPEC) {
+        return get_stack()->gethostbyname(host, address, version);
+    }
+    virtual nsapi_error_t add_dns_server(const SocketAddress &address) { return get_stack()->add_dns_server(address); }
+    virtual void attach(mbed::Callback<void(nsapi_event_t, intptr_t)> status_cb) { (void)status_cb; }
+    virtual nsapi_connection_status_t get_connection_status() const { return NSAPI_STATUS_ERROR_UNSUPPORTED; }
+    virtual nsapi_error_t set_blocking(bool blocking) { (void)blocking; return NSAPI_ERROR_UNSUPPORTED; }
+
+protected:
+    virtual NetworkStack *get_stack() = 0;
+};
+
+class WiFiInterface : public NetworkInterface {
+public:
+    virtual nsapi_error_t set_credentials(const char *ssid, const char *pass, nsapi_security_t security = NSAPI_SECURITY_NONE) = 0;
+    virtual nsapi_error_t set_channel(uint8_t channel) = 0;
+    virtual int8_t get_rssi() = 0;
+    virtual nsapi_error_t connect(const char *ssid, const char *pass, nsapi_security_t security = NSAPI_SECURITY_NONE, uint8_t channel = 0) = 0;
+    virtual nsapi_error_t connect() = 0;
+    virtual nsapi_error_t disconnect() = 0;
+    virtual nsapi_size_or_error_t scan(WiFiAccessPoint *res, nsapi_size_t count) = 0;
+    static WiFiInterface *get_default_instance();
+};
+
+#include "mbed_debug.h"
+#include "ATCmdParser.h"
+
+#endif // MBED_HOST_H
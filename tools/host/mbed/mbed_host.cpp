@@ -0,0 +1,624 @@
+/* SPWFSAxx Devices
+ * Copyright (c) 2018 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "mbed_debug.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#define CR 0x0D
+#define LF 0x0A
+
+static const std::chrono::steady_clock::time_point host_start = std::chrono::steady_clock::now();
+
+static uint64_t host_now_us(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - host_start).count();
+}
+
+/* Serial RX notification (`UARTSerial` reader threads -> `ATCmdParser` waiting for data) */
+static std::mutex io_mutex;
+static std::condition_variable io_cond;
+
+static void io_notify(void) {
+    std::lock_guard<std::mutex> lock(io_mutex);
+    io_cond.notify_all();
+}
+
+/* Note: `timeout` < 0 waits forever */
+static bool io_wait_readable(FileHandle *fh, int timeout) {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    std::unique_lock<std::mutex> lock(io_mutex);
+
+    while(!fh->readable()) {
+        if(timeout < 0) {
+            io_cond.wait(lock);
+        } else if(io_cond.wait_until(lock, deadline) == std::cv_status::timeout) {
+            return fh->readable();
+        }
+    }
+    return true;
+}
+
+void mbed_assert_internal(const char *expr, const char *file, int line) {
+    fprintf(stderr, "mbed assertation failed: %s, file: %s, line %d\n", expr, file, line);
+    abort();
+}
+
+void error(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    abort();
+}
+
+void wait(float s) {
+    std::this_thread::sleep_for(std::chrono::microseconds((uint64_t)(s * 1000000.0f)));
+}
+
+void wait_ms(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void wait_us(int us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+/* Emulator hooks */
+static std::string uart_device;
+static void (*gpio_hook)(PinName pin, int value, void *context) = NULL;
+static void *gpio_context = NULL;
+
+void mbed_host_uart_device(const char *path) {
+    uart_device = path;
+}
+
+void mbed_host_gpio_hook(void (*hook)(PinName pin, int value, void *context), void *context) {
+    gpio_hook = hook;
+    gpio_context = context;
+}
+
+namespace mbed {
+
+uint32_t us_ticker_read(void) {
+    return (uint32_t)host_now_us();
+}
+
+static std::recursive_mutex critical_section;
+
+void core_util_critical_section_enter(void) {
+    critical_section.lock();
+}
+
+void core_util_critical_section_exit(void) {
+    critical_section.unlock();
+}
+
+void DigitalOut::write(int value) {
+    _value = value;
+    if((gpio_hook != NULL) && (_pin != NC)) gpio_hook(_pin, value, gpio_context);
+}
+
+void Timer::start() {
+    if(_running) return;
+    _start_us = host_now_us();
+    _running = true;
+}
+
+void Timer::stop() {
+    if(!_running) return;
+    _time_us += host_now_us() - _start_us;
+    _running = false;
+}
+
+void Timer::reset() {
+    _start_us = host_now_us();
+    _time_us = 0;
+}
+
+uint64_t Timer::read_high_resolution_us() {
+    return _time_us + (_running ? (host_now_us() - _start_us) : 0);
+}
+
+static speed_t host_baud(int baud) {
+    switch(baud) {
+        case 9600:    return B9600;
+        case 19200:   return B19200;
+        case 38400:   return B38400;
+        case 57600:   return B57600;
+        case 230400:  return B230400;
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        default:      return B115200;
+    }
+}
+
+UARTSerial::UARTSerial(PinName tx, PinName rx, int baud)
+: _fd(-1), _blocking(true), _running(false), _thread(NULL), _rx_head(0), _rx_cnt(0)
+{
+    (void)tx; (void)rx;
+
+    if(uart_device.empty() && (getenv("SPWF_UART") != NULL)) {
+        uart_device = getenv("SPWF_UART");
+    }
+    if(uart_device.empty()) {
+        error("UARTSerial: no device (see `mbed_host_uart_device()` or `SPWF_UART`)\n");
+    }
+
+    _fd = ::open(uart_device.c_str(), O_RDWR | O_NOCTTY);
+    if(_fd < 0) {
+        error("UARTSerial: cannot open %s (%s)\n", uart_device.c_str(), strerror(errno));
+    }
+
+    struct termios tio;
+    if(tcgetattr(_fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(_fd, TCSANOW, &tio);
+    }
+    set_baud(baud);
+
+    _running = true;
+    _thread = new std::thread(&UARTSerial::_rx_thread, this);
+}
+
+UARTSerial::~UARTSerial() {
+    close();
+}
+
+void UARTSerial::_rx_thread(void) {
+    uint8_t buf[256];
+
+    while(_running) {
+        struct pollfd pfd = { _fd, POLLIN, 0 };
+        size_t room;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            room = sizeof(_rxbuf) - _rx_cnt;
+        }
+        if(room == 0) { // RX buffer full: hold back sender (as with HW flow control)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+
+        if(::poll(&pfd, 1, 20) <= 0) continue;
+
+        ssize_t n = ::read(_fd, buf, (room < sizeof(buf)) ? room : sizeof(buf));
+        if(n <= 0) {
+            if((n < 0) && (errno == EINTR || errno == EAGAIN)) continue;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1)); // peer closed (pty master)
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for(ssize_t i = 0; i < n; i++) {
+                _rxbuf[(_rx_head + _rx_cnt) % sizeof(_rxbuf)] = buf[i];
+                _rx_cnt++;
+            }
+        }
+
+        /* "RX interrupt" */
+        Callback<void()> cb;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            cb = _sigio_cb;
+        }
+        if(cb) cb();
+        io_notify();
+    }
+}
+
+ssize_t UARTSerial::read(void *buffer, size_t size) {
+    uint8_t *data = (uint8_t*)buffer;
+    size_t n = 0;
+
+    if(size == 0) return 0;
+
+    if(_blocking && !io_wait_readable(this, -1)) return -EAGAIN;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(_rx_cnt == 0) return -EAGAIN;
+
+    while((n < size) && (_rx_cnt > 0)) {
+        data[n++] = _rxbuf[_rx_head];
+        _rx_head = (_rx_head + 1) % sizeof(_rxbuf);
+        _rx_cnt--;
+    }
+    return n;
+}
+
+ssize_t UARTSerial::write(const void *buffer, size_t size) {
+    const uint8_t *data = (const uint8_t*)buffer;
+    size_t n = 0;
+
+    while(n < size) {
+        ssize_t ret = ::write(_fd, data + n, size - n);
+        if(ret < 0) {
+            if(errno == EINTR || errno == EAGAIN) continue;
+            return -errno;
+        }
+        n += ret;
+    }
+    return n;
+}
+
+int UARTSerial::close() {
+    if(_thread != NULL) {
+        _running = false;
+        static_cast<std::thread*>(_thread)->join();
+        delete static_cast<std::thread*>(_thread);
+        _thread = NULL;
+    }
+    if(_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    return 0;
+}
+
+short UARTSerial::poll(short events) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    short revents = 0;
+
+    if(_rx_cnt > 0) revents |= POLLIN;
+    revents |= POLLOUT;
+
+    return revents & events;
+}
+
+void UARTSerial::sigio(Callback<void()> func) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sigio_cb = func;
+}
+
+void UARTSerial::set_baud(int baud) {
+    struct termios tio;
+
+    if(tcgetattr(_fd, &tio) == 0) {
+        cfsetspeed(&tio, host_baud(baud));
+        tcsetattr(_fd, TCSANOW, &tio);
+    }
+}
+
+void UARTSerial::set_flow_control(SerialBase::Flow type, PinName flow1, PinName flow2) {
+    struct termios tio;
+    (void)flow1; (void)flow2;
+
+    if(tcgetattr(_fd, &tio) == 0) {
+        if(type == SerialBase::RTSCTS) tio.c_cflag |= CRTSCTS;
+        else tio.c_cflag &= ~CRTSCTS;
+        tcsetattr(_fd, TCSANOW, &tio);
+    }
+}
+
+/*
+ * ATCmdParser
+ */
+ATCmdParser::ATCmdParser(FileHandle *fh, const char *output_delimiter, int buffer_size, int timeout, bool debug)
+: _fh(fh), _buffer_size(buffer_size), _timeout(timeout), _dbg_on(debug ? 1 : 0), _aborted(false), _in_prev(0), _oobs(NULL)
+{
+    _buffer = new char[buffer_size];
+    set_delimiter(output_delimiter);
+}
+
+ATCmdParser::~ATCmdParser() {
+    while(_oobs != NULL) {
+        oob_entry *next = _oobs->next;
+        delete _oobs;
+        _oobs = next;
+    }
+    delete[] _buffer;
+}
+
+void ATCmdParser::set_delimiter(const char *output_delimiter) {
+    _output_delimiter = output_delimiter;
+    _output_delim_length = strlen(output_delimiter);
+}
+
+int ATCmdParser::putc(char c) {
+    return (_fh->write(&c, 1) == 1) ? (unsigned char)c : -1;
+}
+
+int ATCmdParser::getc() {
+    unsigned char c;
+
+    if(!io_wait_readable(_fh, _timeout)) return -1;
+    return (_fh->read(&c, 1) == 1) ? c : -1;
+}
+
+void ATCmdParser::flush() {
+    while(_fh->readable()) {
+        unsigned char c;
+        _fh->read(&c, 1);
+    }
+}
+
+int ATCmdParser::write(const char *data, int size) {
+    for(int i = 0; i < size; i++) {
+        if(putc(data[i]) < 0) return -1;
+    }
+    return size;
+}
+
+int ATCmdParser::read(char *data, int size) {
+    for(int i = 0; i < size; i++) {
+        int c = getc();
+        if(c < 0) return -1;
+        data[i] = c;
+    }
+    return size;
+}
+
+bool ATCmdParser::send(const char *command, ...) {
+    va_list args;
+    va_start(args, command);
+    bool res = vsend(command, args);
+    va_end(args);
+    return res;
+}
+
+bool ATCmdParser::vsend(const char *command, va_list args) {
+    if(vsnprintf(_buffer, _buffer_size, command, args) < 0) return false;
+
+    for(int i = 0; _buffer[i]; i++) {
+        if(putc(_buffer[i]) < 0) return false;
+    }
+    for(int i = 0; _output_delimiter[i]; i++) {
+        if(putc(_output_delimiter[i]) < 0) return false;
+    }
+
+    debug_if(_dbg_on, "AT> %s\n", _buffer);
+    return true;
+}
+
+bool ATCmdParser::recv(const char *response, ...) {
+    va_list args;
+    va_start(args, response);
+    bool res = vrecv(response, args);
+    va_end(args);
+    return res;
+}
+
+bool ATCmdParser::vrecv(const char *response, va_list args) {
+restart:
+    _aborted = false;
+
+    /* iterate through each line in the expected response */
+    while(response[0]) {
+        /* copy line of response into buffer, replacing conversions by non-storing ones (`%*`) */
+        int i = 0;
+        int offset = 0;
+        bool whole_line_wanted = false;
+
+        while(response[i]) {
+            if(response[i] == '%' && response[i + 1] != '%' && response[i + 1] != '*') {
+                _buffer[offset++] = '%';
+                _buffer[offset++] = '*';
+                i++;
+            } else {
+                _buffer[offset++] = response[i++];
+                /* find line breaks (not the ones in a `%[^\n]` conversion) */
+                if(response[i - 1] == '\n' && !(i >= 3 && response[i - 3] == '[' && response[i - 2] == '^')) {
+                    whole_line_wanted = true;
+                    break;
+                }
+            }
+        }
+
+        /* `%n` tells whether the whole received line got matched */
+        _buffer[offset++] = '%';
+        _buffer[offset++] = 'n';
+        _buffer[offset++] = 0;
+
+        debug_if(_dbg_on, "AT? %s\n", _buffer);
+
+        int j = 0;
+
+        while(true) {
+            int c = getc();
+            if(c < 0) {
+                debug_if(_dbg_on, "AT(Timeout)\n");
+                return false;
+            }
+
+            /* simplify newlines */
+            if((c == CR && _in_prev != LF) || (c == LF && _in_prev != CR)) {
+                _in_prev = c;
+                c = '\n';
+            } else if((c == CR && _in_prev == LF) || (c == LF && _in_prev == CR)) {
+                _in_prev = c;
+                continue; // onto next character
+            } else {
+                _in_prev = c;
+            }
+            _buffer[offset + j++] = c;
+            _buffer[offset + j] = 0;
+
+            /* check for OOB data */
+            for(oob_entry *o = _oobs; o != NULL; o = o->next) {
+                if(((unsigned)j == o->len) && (memcmp(o->prefix, _buffer + offset, o->len) == 0)) {
+                    debug_if(_dbg_on, "AT! %s\n", o->prefix);
+                    o->cb();
+
+                    if(_aborted) {
+                        debug_if(_dbg_on, "AT(Aborted)\n");
+                        return false;
+                    }
+                    /* OOB handler might have used the buffer */
+                    goto restart;
+                }
+            }
+
+            /* check for match (waiting for the line end if the response contains it) */
+            int count = -1;
+            if(!(whole_line_wanted && (c != '\n'))) {
+                sscanf(_buffer + offset, _buffer, &count);
+            }
+
+            if(count == j) {
+                debug_if(_dbg_on, "AT= %s\n", _buffer + offset);
+
+                /* store the results */
+                memcpy(_buffer, response, i);
+                _buffer[i] = 0;
+                vsscanf(_buffer + offset, _buffer, args);
+
+                response += i;
+                break;
+            }
+
+            /* clear the buffer at line end or when running out of space (e.g. binary data) */
+            if((c == '\n') || (j + 1 >= _buffer_size - offset)) {
+                debug_if(_dbg_on, "AT< %s", _buffer + offset);
+                j = 0;
+            }
+        }
+    }
+
+    return true;
+}
+
+void ATCmdParser::oob(const char *prefix, Callback<void()> cb) {
+    oob_entry *o = new oob_entry;
+    o->len = strlen(prefix);
+    o->prefix = prefix;
+    o->cb = cb;
+    o->next = _oobs;
+    _oobs = o;
+}
+
+bool ATCmdParser::process_oob(void) {
+    if(!_fh->readable()) return false;
+
+    int i = 0;
+    while(true) {
+        int c = getc();
+        if(c < 0) return false;
+
+        /* simplify newlines */
+        if((c == CR && _in_prev != LF) || (c == LF && _in_prev != CR)) {
+            _in_prev = c;
+            c = '\n';
+        } else if((c == CR && _in_prev == LF) || (c == LF && _in_prev == CR)) {
+            _in_prev = c;
+            continue; // onto next character
+        } else {
+            _in_prev = c;
+        }
+        _buffer[i++] = c;
+        _buffer[i] = 0;
+
+        for(oob_entry *o = _oobs; o != NULL; o = o->next) {
+            if(((unsigned)i == o->len) && (memcmp(o->prefix, _buffer, o->len) == 0)) {
+                debug_if(_dbg_on, "AT! %s\n", o->prefix);
+                o->cb();
+                return !_aborted;
+            }
+        }
+
+        if(((i + 1) >= _buffer_size) || (c == '\n')) {
+            debug_if(_dbg_on, "AT< %s", _buffer);
+            i = 0;
+        }
+    }
+}
+
+void ATCmdParser::abort() {
+    _aborted = true;
+}
+
+} // namespace mbed
+
+/*
+ * RTOS
+ */
+namespace rtos {
+
+uint32_t EventFlags::set(uint32_t flags) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _flags |= flags;
+    _cond.notify_all();
+    return _flags;
+}
+
+uint32_t EventFlags::clear(uint32_t flags) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint32_t ret = _flags;
+    _flags &= ~flags;
+    return ret;
+}
+
+uint32_t EventFlags::get() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _flags;
+}
+
+uint32_t EventFlags::wait_any(uint32_t flags, uint32_t millisec, bool clear) {
+    return _wait(flags, millisec, clear, false);
+}
+
+uint32_t EventFlags::wait_all(uint32_t flags, uint32_t millisec, bool clear) {
+    return _wait(flags, millisec, clear, true);
+}
+
+uint32_t EventFlags::_wait(uint32_t flags, uint32_t millisec, bool clear, bool all) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(millisec);
+
+    while(!(all ? ((_flags & flags) == flags) : ((_flags & flags) != 0))) {
+        if(millisec == osWaitForever) {
+            _cond.wait(lock);
+        } else if(_cond.wait_until(lock, deadline) == std::cv_status::timeout) {
+            return osFlagsErrorTimeout;
+        }
+    }
+
+    uint32_t ret = _flags;
+    if(clear) _flags &= ~flags;
+    return ret;
+}
+
+namespace Kernel {
+uint64_t get_ms_count(void) {
+    return host_now_us() / 1000;
+}
+}
+
+} // namespace rtos
+
+/*
+ * Network socket API
+ */
+bool SocketAddress::set_ip_address(const char *addr) {
+    unsigned int n[4];
+    char end;
+
+    _ip[0] = '\0';
+    if((addr == NULL) || (addr[0] == '\0')) return false;
+    if(sscanf(addr, "%u.%u.%u.%u%c", &n[0], &n[1], &n[2], &n[3], &end) != 4) return false;
+    if((n[0] > 255) || (n[1] > 255) || (n[2] > 255) || (n[3] > 255)) return false;
+
+    snprintf(_ip, sizeof(_ip), "%u.%u.%u.%u", n[0], n[1], n[2], n[3]);
+    return true;
+}
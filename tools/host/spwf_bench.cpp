@@ -0,0 +1,619 @@
+/* SPWFSAxx Devices
+ * Copyright (c) 2018 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Send/receive throughput & latency of the driver talking to the module emulator
+ *
+ * Usage: spwf_bench [-b <baud>] [-l <latency us>] [-n <bytes>] [-c <corpora directory>] [-r <repetitions>] [-d]
+ *
+ * `-b 0` (default) runs without UART timing, i.e. measures the driver (and emulator) overhead only.
+ *
+ * Beforehand the parsing of `<dialect>/winds.txt` (see `corpora/README.md`) is timed from memory, i.e. without
+ * pseudo-terminal & emulator, once per "+WIND:" prefix & line parser of the driver and once per `ATCmdParser`
+ * OOB & format of previous driver versions, followed by the formatting of the `SOCKW`, `SOCKR` & `SOCKQ` commands
+ * by `SpwfCmd` & by `vsnprintf()` (as in `ATCmdParser::vsend()`).
+ *
+ * On SPWFSA04 the socket server is timed as well: accepting scripted clients & answering their requests,
+ * as well as echoed WebSocket messages, framed by the module or by the host (sent through a TCP socket).
+ */
+
+#include "SpwfSAInterface.h"
+#include "SpwfEmulator.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#define BENCH_SSID          "spwf-bench"
+#define BENCH_PASS          "spwf-bench-pass"
+#define BENCH_PEER          "192.168.1.10"
+#define BENCH_PORT          (7)
+#define BENCH_RCVTIMEO      (5000)
+#define BENCH_PING_SIZE     (32)
+#define BENCH_PING_COUNT    (50)
+#define BENCH_SEGMENT       (1460)
+#define BENCH_FORMAT_COUNT  (1000000)
+#define BENCH_SERVER_PORT   (8080)
+#define BENCH_CLIENT        "192.168.1.20"
+#define BENCH_CLIENTS       (10)
+#define BENCH_REQUESTS      (10)    // per client
+#define BENCH_REQUEST_SIZE  (64)
+#define BENCH_RESPONSE_SIZE (512)
+#define BENCH_WS_MESSAGES   (200)
+#define BENCH_WS_SIZE       (125)   // largest payload with a 2 bytes frame header
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+#define BENCH_DIALECT       "SPWFSA04"
+#define BENCH_CORPUS        "spwfsa04/winds.txt"
+/* OOBs & formats of previous driver versions */
+#define OLD_OOB_WIFI_UP     "+WIND:24:WiFi Up::"
+#define OLD_RECV_PENDING    "::%u:%*u:%u\n"
+#define OLD_RECV_CLOSED     ":%u:%*u\n"
+#else
+#define BENCH_DIALECT       "SPWFSA01"
+#define BENCH_CORPUS        "spwfsa01/winds.txt"
+#define OLD_RECV_PENDING    ":%u:%u\n"
+#define OLD_RECV_CLOSED     ":%u\n"
+#endif
+
+static double now_ms(void) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool recv_all(TCPSocket &sock, char *buf, unsigned size) {
+    unsigned got = 0;
+
+    while(got < size) {
+        nsapi_size_or_error_t ret = sock.recv(buf + got, size - got);
+        if(ret <= 0) {
+            fprintf(stderr, "spwf_bench: receive failed (%d) after %u of %u bytes\n", (int)ret, got, size);
+            return false;
+        }
+        got += ret;
+    }
+    return true;
+}
+
+static bool send_all(TCPSocket &sock, const char *buf, unsigned size) {
+    unsigned sent = 0;
+
+    while(sent < size) {
+        nsapi_size_or_error_t ret = sock.send(buf + sent, size - sent);
+        if(ret <= 0) {
+            fprintf(stderr, "spwf_bench: send failed (%d) after %u of %u bytes\n", (int)ret, sent, size);
+            return false;
+        }
+        sent += ret;
+    }
+    return true;
+}
+
+static bool open_socket(SpwfSAInterface &wifi, TCPSocket &sock) {
+    int timeout = BENCH_RCVTIMEO;
+
+    if((sock.open(&wifi) != NSAPI_ERROR_OK)
+            || (sock.connect(SocketAddress(BENCH_PEER, BENCH_PORT)) != NSAPI_ERROR_OK)
+            || (sock.setsockopt(SPWFSA_SOCKOPT_LEVEL, SPWFSA_SOCKOPT_RCVTIMEO, &timeout, sizeof(timeout)) != NSAPI_ERROR_OK)) {
+        fprintf(stderr, "spwf_bench: opening socket failed\n");
+        return false;
+    }
+    return true;
+}
+
+/* Module output served from memory (readable until consumed) */
+class MemoryInput : public FileHandle {
+public:
+    MemoryInput(const std::string &data) : _data(data), _pos(0) {}
+
+    void rewind(void) { _pos = 0; }
+
+    virtual ssize_t read(void *buffer, size_t size) {
+        size = std::min(size, _data.size() - _pos);
+        memcpy(buffer, _data.data() + _pos, size);
+        _pos += size;
+        return size;
+    }
+    virtual ssize_t write(const void *buffer, size_t size) { (void)buffer; return size; }
+    virtual off_t seek(off_t offset, int whence) { (void)offset; (void)whence; return -1; }
+    virtual int close() { return 0; }
+    virtual short poll(short events) const { return events & ((_pos < _data.size()) ? (POLLIN | POLLOUT) : POLLOUT); }
+
+private:
+    const std::string &_data;
+    size_t _pos;
+};
+
+/* Parses indications like the driver does (see `SPWFSAxx::_wind_handler()`) or like previous driver versions did
+ * (one `ATCmdParser` OOB per indication, arguments read with `ATCmdParser::recv()`), summing up what got parsed */
+class SpwfParserBench {
+public:
+    SpwfParserBench(MemoryInput &input) : _input(input), _parser(&input, "\r", 256, 0) {}
+
+    uint64_t run_driver(unsigned reps) {
+        _parser.oob(SPWFXX_OOB_WIND, callback(this, &SpwfParserBench::_wind));
+        return _run(reps);
+    }
+
+    uint64_t run_old(unsigned reps) {
+        _parser.oob("+WIND:55:Pending Data", callback(this, &SpwfParserBench::_old_pending_data));
+        _parser.oob("+WIND:58:Socket Closed", callback(this, &SpwfParserBench::_old_socket_closed));
+        _parser.oob("+WIND:33:WiFi Network Lost", callback(this, &SpwfParserBench::_old_skip));
+        _parser.oob("+WIND:8:Hard Fault", callback(this, &SpwfParserBench::_old_skip));
+        _parser.oob("+WIND:5:WiFi Hardware Failure", callback(this, &SpwfParserBench::_old_skip));
+        _parser.oob(SPWFXX_OOB_ERROR, callback(this, &SpwfParserBench::_old_skip));
+#ifdef OLD_OOB_WIFI_UP
+        _parser.oob(OLD_OOB_WIFI_UP, callback(this, &SpwfParserBench::_old_skip));
+#endif
+        return _run(reps);
+    }
+
+private:
+    uint64_t _run(unsigned reps) {
+        _sum = 0;
+        for(unsigned i = 0; i < reps; i++) {
+            _input.rewind();
+            while(_input.readable()) _parser.process_oob();
+        }
+        return _sum;
+    }
+
+    void _count(uint32_t wind_id, uint32_t id, uint32_t amount) {
+        _sum += (wind_id << 24) + (id << 16) + amount;
+    }
+
+    /* see `SPWFSAxx::_recv_line()` */
+    int _recv_line(char *buf, int size) {
+        int len = 0;
+        int c;
+
+        while((c = _parser.getc()) != '\n') {
+            if(c < 0) return -1;
+            if(c == '\r') continue;
+            if(len < (size - 1)) buf[len++] = (char)c;
+        }
+        buf[len] = '\0';
+        return len;
+    }
+
+    /* see `SPWFSAxx::_wind_dispatch()`, `SPWFSAxx::_packet_handler_th()` & `SPWFSAxx::_server_gone_handler()` */
+    void _wind(void) {
+        char line[SPWFXX_WIND_LINE_SIZE];
+        char *args, *fields[SPWFXX_PENDING_DATA_FIELDS];
+        uint32_t wind_id, id, amount;
+
+        if((_recv_line(line, sizeof(line)) < 0) || ((args = strchr(line, ':')) == NULL)) return;
+        *args++ = '\0';
+        if(!SPWFSAxx::_parse_uint(line, &wind_id)) return;
+
+        switch(wind_id) {
+            case SPWFXX_WIND_PENDING_DATA:
+                if(((args = strchr(args, ':')) != NULL)
+                        && (SPWFSAxx::_split_fields(args, ':', fields, SPWFXX_PENDING_DATA_FIELDS) == SPWFXX_PENDING_DATA_FIELDS)
+                        && SPWFSAxx::_parse_uint(fields[SPWFXX_PENDING_DATA_ID], &id)
+                        && SPWFSAxx::_parse_uint(fields[SPWFXX_PENDING_DATA_AMOUNT], &amount)) {
+                    _count(wind_id, id, amount);
+                }
+                break;
+            case SPWFXX_WIND_SOCKET_CLOSED:
+                if(((args = strchr(args, ':')) != NULL)
+                        && (SPWFSAxx::_split_fields(args, ':', fields, SPWFXX_SOCKET_CLOSED_FIELDS) == SPWFXX_SOCKET_CLOSED_FIELDS)
+                        && SPWFSAxx::_parse_uint(fields[SPWFXX_SOCKET_CLOSED_ID], &id)) {
+                    _count(wind_id, id, 0);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void _old_pending_data(void) {
+        unsigned int id, amount;
+
+        if(_parser.recv(OLD_RECV_PENDING, &id, &amount)) _count(SPWFXX_WIND_PENDING_DATA, id, amount);
+    }
+
+    void _old_socket_closed(void) {
+        unsigned int id;
+
+        if(_parser.recv(OLD_RECV_CLOSED, &id)) _count(SPWFXX_WIND_SOCKET_CLOSED, id, 0);
+    }
+
+    void _old_skip(void) {
+        char line[256];
+
+        _parser.recv("%255[^\n]\n", line);
+    }
+
+    MemoryInput &_input;
+    ATCmdParser _parser;
+    uint64_t _sum;
+};
+
+/* Note: corpora are stored with LF line ends, module output uses CR LF */
+static bool load_corpus(const std::string &path, std::string *out) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    std::ostringstream raw;
+
+    if(!file) {
+        fprintf(stderr, "spwf_bench: cannot read %s\n", path.c_str());
+        return false;
+    }
+    raw << file.rdbuf();
+
+    out->clear();
+    for(char c : raw.str()) {
+        if(c == '\n') *out += '\r';
+        *out += c;
+    }
+    return true;
+}
+
+static bool bench_parser(const std::string &dir, unsigned reps) {
+    std::string corpus;
+    uint64_t sum_driver, sum_old;
+    double ms_driver, ms_old;
+
+    if(!load_corpus(dir + "/" BENCH_CORPUS, &corpus)) return false;
+
+    unsigned lines = std::count(corpus.begin(), corpus.end(), '\n') * reps;
+    MemoryInput input(corpus);
+    {
+        SpwfParserBench bench(input);
+        double start = now_ms();
+        sum_driver = bench.run_driver(reps);
+        ms_driver = now_ms() - start;
+    }
+    {
+        SpwfParserBench bench(input);
+        double start = now_ms();
+        sum_old = bench.run_old(reps);
+        ms_old = now_ms() - start;
+    }
+
+    printf("  parse WINDs:    %9.0f ns/line (ATCmdParser OOBs & formats: %.0f ns/line, %u lines)%s\n",
+           ms_driver * 1e6 / lines, ms_old * 1e6 / lines, lines, (sum_driver == sum_old) ? "" : " RESULTS DIFFER");
+    return sum_driver == sum_old;
+}
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+/* Socket server: accept latency (client connecting until accepted) & request/response latency
+ * (client sending a request until the response has been sent), peer echo has to be off */
+static bool bench_server(SpwfSAInterface &wifi, SpwfEmulator &emu, char *buf, const char *response) {
+    TCPServer server;
+    int timeout = BENCH_RCVTIMEO;
+    double acc_min = 1e9, acc_max = 0, acc_sum = 0;
+    double req_min = 1e9, req_max = 0, req_sum = 0;
+    nsapi_size_or_error_t ret = NSAPI_ERROR_DEVICE_ERROR;
+
+    if((server.open(&wifi) != NSAPI_ERROR_OK) || (server.bind(BENCH_SERVER_PORT) != NSAPI_ERROR_OK)
+            || (server.listen(SPWFSA_SOCKD_BACKLOG) != NSAPI_ERROR_OK)) {
+        fprintf(stderr, "spwf_bench: starting socket server failed\n");
+        return false;
+    }
+
+    for(int cid = 0; cid < BENCH_CLIENTS; cid++) {
+        spwf_pollfd_t fd = { server.handle(), SPWFSA_POLL_IN, 0 };
+        TCPSocket client;
+        double t = now_ms();
+
+        emu.client_connect(BENCH_SERVER_PORT, cid, BENCH_CLIENT);
+        if((wifi.poll(&fd, 1, BENCH_RCVTIMEO) != 1) || (server.accept(&client) != NSAPI_ERROR_OK)
+                || (client.setsockopt(SPWFSA_SOCKOPT_LEVEL, SPWFSA_SOCKOPT_RCVTIMEO, &timeout, sizeof(timeout)) != NSAPI_ERROR_OK)) {
+            fprintf(stderr, "spwf_bench: accepting client %d failed\n", cid);
+            return false;
+        }
+
+        t = now_ms() - t;
+        acc_sum += t;
+        if(t < acc_min) acc_min = t;
+        if(t > acc_max) acc_max = t;
+
+        for(int i = 0; i < BENCH_REQUESTS; i++) {
+            t = now_ms();
+
+            emu.client_send(BENCH_SERVER_PORT, cid, response, BENCH_REQUEST_SIZE);
+            if(!(recv_all(client, buf, BENCH_REQUEST_SIZE) && send_all(client, response, BENCH_RESPONSE_SIZE))) return false;
+
+            t = now_ms() - t;
+            req_sum += t;
+            if(t < req_min) req_min = t;
+            if(t > req_max) req_max = t;
+        }
+
+        if(cid < (BENCH_CLIENTS - 1)) continue;
+
+        /* last client goes away by itself ("+WIND:62") */
+        emu.client_close(BENCH_SERVER_PORT, cid);
+        ret = client.recv(buf, 1);
+    }
+
+    printf("  accept:         %9.3f ms avg, %.3f min, %.3f max (%d clients)\n",
+           acc_sum / BENCH_CLIENTS, acc_min, acc_max, BENCH_CLIENTS);
+    printf("  request:        %9.3f ms avg, %.3f min, %.3f max (%d requests, %d/%d bytes)\n",
+           req_sum / (BENCH_CLIENTS * BENCH_REQUESTS), req_min, req_max, BENCH_CLIENTS * BENCH_REQUESTS,
+           BENCH_REQUEST_SIZE, BENCH_RESPONSE_SIZE);
+    printf("  client gone:    %9s (recv %d)\n", (ret == 0) ? "detected" : "FAILED", (int)ret);
+    return ret == 0;
+}
+
+/* WebSocket frame of a binary message as sent by a client (RFC 6455: masked), `len` < 65536 */
+static unsigned ws_frame(uint8_t *frame, const char *msg, unsigned len, uint32_t key) {
+    unsigned pos = 0;
+
+    frame[pos++] = 0x82; // FIN, binary
+    if(len < 126) {
+        frame[pos++] = 0x80 | len;
+    } else {
+        frame[pos++] = 0x80 | 126;
+        frame[pos++] = (uint8_t)(len >> 8);
+        frame[pos++] = (uint8_t)len;
+    }
+
+    uint8_t *mask = frame + pos;
+    for(int i = 0; i < 4; i++) frame[pos++] = (uint8_t)(key >> (8 * i));
+    for(unsigned i = 0; i < len; i++) frame[pos++] = msg[i] ^ mask[i & 3];
+
+    return pos;
+}
+
+/* Receive a WebSocket frame into `msg` (unmasking it if masked, e.g. echoed by the emulated peer) */
+static bool ws_recv_frame(TCPSocket &sock, char *msg, unsigned size, unsigned *len) {
+    uint8_t hdr[4], mask[4] = { 0, 0, 0, 0 };
+
+    if(!recv_all(sock, (char*)hdr, 2)) return false;
+
+    *len = hdr[1] & 0x7F;
+    if(*len == 127) return false; // no 64 bit lengths here
+    if(*len == 126) {
+        if(!recv_all(sock, (char*)hdr + 2, 2)) return false;
+        *len = (hdr[2] << 8) | hdr[3];
+    }
+    if((*len > size) || ((hdr[1] & 0x80) && !recv_all(sock, (char*)mask, 4)) || !recv_all(sock, msg, *len)) return false;
+
+    for(unsigned i = 0; i < *len; i++) msg[i] ^= mask[i & 3];
+    return true;
+}
+
+/* Echoed WebSocket messages: framed by the module vs. framed by the host & sent through a TCP socket */
+static bool bench_websocket(SpwfSAInterface &wifi, SpwfEmulator &emu, char *buf, const char *msg) {
+    uint8_t frame[BENCH_WS_SIZE + 8];
+    double start, ms_module, ms_host, deadline;
+    nsapi_size_or_error_t ret = NSAPI_ERROR_DEVICE_ERROR;
+    TCPSocket sock;
+    unsigned len;
+    int ws_id;
+
+    if(wifi.ws_open(BENCH_PEER, "/", &ws_id) != NSAPI_ERROR_OK) {
+        fprintf(stderr, "spwf_bench: opening WebSocket failed\n");
+        return false;
+    }
+
+    start = now_ms();
+    for(int i = 0; i < BENCH_WS_MESSAGES; i++) {
+        if(wifi.ws_send(ws_id, msg + i, BENCH_WS_SIZE) != BENCH_WS_SIZE) return false;
+
+        /* `ws_recv()` does not block */
+        for(deadline = now_ms() + BENCH_RCVTIMEO; now_ms() < deadline; ) {
+            if((ret = wifi.ws_recv(ws_id, buf, BENCH_WS_SIZE)) != NSAPI_ERROR_WOULD_BLOCK) break;
+        }
+        if((ret != BENCH_WS_SIZE) || (memcmp(buf, msg + i, BENCH_WS_SIZE) != 0)) {
+            fprintf(stderr, "spwf_bench: WebSocket message %d not echoed (%d)\n", i, (int)ret);
+            return false;
+        }
+    }
+    ms_module = now_ms() - start;
+
+    /* server closing the connection ("+WIND:89") */
+    emu.ws_peer_close(ws_id);
+    for(deadline = now_ms() + BENCH_RCVTIMEO; now_ms() < deadline; ) {
+        if((ret = wifi.ws_recv(ws_id, buf, BENCH_WS_SIZE)) != NSAPI_ERROR_WOULD_BLOCK) break;
+    }
+    wifi.ws_close(ws_id);
+
+    if(!open_socket(wifi, sock)) return false;
+
+    start = now_ms();
+    for(int i = 0; i < BENCH_WS_MESSAGES; i++) {
+        unsigned size = ws_frame(frame, msg + i, BENCH_WS_SIZE, 0x5A3C96E1U * (i + 1));
+
+        if(!(send_all(sock, (const char*)frame, size) && ws_recv_frame(sock, buf, BENCH_WS_SIZE, &len))) return false;
+        if((len != BENCH_WS_SIZE) || (memcmp(buf, msg + i, BENCH_WS_SIZE) != 0)) {
+            fprintf(stderr, "spwf_bench: WebSocket frame %d not echoed\n", i);
+            return false;
+        }
+    }
+    ms_host = now_ms() - start;
+    sock.close();
+
+    printf("  websocket:      %9.0f msg/s (host framing over TCP: %.0f msg/s, %d echoed %d bytes messages)\n",
+           BENCH_WS_MESSAGES * 1000.0 / ms_module, BENCH_WS_MESSAGES * 1000.0 / ms_host, BENCH_WS_MESSAGES, BENCH_WS_SIZE);
+    printf("  websocket gone: %9s (recv %d)\n", (ret == NSAPI_ERROR_CONNECTION_LOST) ? "detected" : "FAILED", (int)ret);
+    return ret == NSAPI_ERROR_CONNECTION_LOST;
+}
+#endif // MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+
+/* Formatting of previous driver versions (`ATCmdParser::send()`) */
+static int old_format(char *buf, size_t size, const char *format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    int len = vsnprintf(buf, size, format, args);
+    va_end(args);
+    return len;
+}
+
+/* `nargs` arguments: socket id & length (`SOCKW`, `SOCKR`) or socket id only (`SOCKQ`) */
+template <size_t N>
+static bool bench_format(const char *name, const char (&prefix)[N], const char *old, int nargs) {
+    char buf[256];
+    uint64_t sum_new = 0, sum_old = 0;
+    double start, ms_new, ms_old;
+    bool same = true;
+
+    /* same commands for both? */
+    for(uint32_t i = 0; i < BENCH_SEGMENT; i++) {
+        SpwfCmd cmd(prefix);
+        uint32_t id = i % SPWFSA_SOCKET_COUNT;
+
+        if(nargs > 1) cmd.arg(id).arg(i);
+        else cmd.arg(id);
+        old_format(buf, sizeof(buf), old, id, i);
+        same = same && (strcmp(cmd.terminate('\0'), buf) == 0);
+    }
+
+    start = now_ms();
+    for(uint32_t i = 0; i < BENCH_FORMAT_COUNT; i++) {
+        SpwfCmd cmd(prefix);
+        uint32_t id = i % SPWFSA_SOCKET_COUNT;
+
+        if(nargs > 1) cmd.arg(id).arg(i % (BENCH_SEGMENT + 1));
+        else cmd.arg(id);
+        sum_new += cmd.terminate('\r')[cmd.length() - 1] + cmd.length();
+    }
+    ms_new = now_ms() - start;
+
+    start = now_ms();
+    for(uint32_t i = 0; i < BENCH_FORMAT_COUNT; i++) {
+        int len = old_format(buf, sizeof(buf), old, i % SPWFSA_SOCKET_COUNT, i % (BENCH_SEGMENT + 1));
+        sum_old += buf[len - 1] + len;
+    }
+    ms_old = now_ms() - start;
+
+    same = same && (sum_new == sum_old);
+    printf("  format %s:   %9.1f ns/command (vsnprintf: %.1f ns/command)%s\n", name,
+           ms_new * 1e6 / BENCH_FORMAT_COUNT, ms_old * 1e6 / BENCH_FORMAT_COUNT, same ? "" : " COMMANDS DIFFER");
+    return same;
+}
+
+int main(int argc, char **argv) {
+    SpwfEmulator emu;
+    int baud = 0, latency = 0, opt;
+    unsigned total = 64 * 1024, reps = 20;
+    const char *corpora = "corpora";
+    bool debug = false;
+    double start, min = 1e9, max = 0, sum = 0;
+
+    while((opt = getopt(argc, argv, "b:l:n:c:r:d")) != -1) {
+        switch(opt) {
+            case 'b': baud = atoi(optarg); break;
+            case 'l': latency = atoi(optarg); break;
+            case 'n': total = strtoul(optarg, NULL, 0); break;
+            case 'c': corpora = optarg; break;
+            case 'r': reps = strtoul(optarg, NULL, 0); break;
+            case 'd': debug = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-b <baud>] [-l <latency us>] [-n <bytes>] [-c <corpora directory>] [-r <repetitions>] [-d]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    emu.set_baud(baud);
+    emu.set_latency(latency);
+    if(!emu.start()) return 1;
+
+    SpwfSAInterface wifi(MBED_CONF_IDW0XX1_TX, MBED_CONF_IDW0XX1_RX, SPWFSAXX_RTS_PIN, SPWFSAXX_CTS_PIN, debug);
+    TCPSocket sock;
+    char *out = new char[total];
+    char *in = new char[total];
+
+    for(unsigned i = 0; i < total; i++) out[i] = (char)(i * 7 + 1);
+
+    if(baud > 0) {
+        printf("%s dialect, %d baud, %d us/command\n", BENCH_DIALECT, baud, latency);
+    } else {
+        printf("%s dialect, no UART timing, %d us/command\n", BENCH_DIALECT, latency);
+    }
+
+    if(!bench_parser(corpora, reps)) return 1;
+    if(!(bench_format("SOCKW", SPWFXX_SEND_SOCKW, "AT+S.SOCKW=%d,%d", 2)
+            && bench_format("SOCKR", SPWFXX_SEND_SOCKR, "AT+S.SOCKR=%d,%d", 2)
+            && bench_format("SOCKQ", SPWFXX_SEND_SOCKQ, "AT+S.SOCKQ=%d", 1))) return 1;
+
+    start = now_ms();
+    if(wifi.connect(BENCH_SSID, BENCH_PASS, NSAPI_SECURITY_WPA2) != NSAPI_ERROR_OK) {
+        fprintf(stderr, "spwf_bench: connect failed\n");
+        return 1;
+    }
+    printf("  connect:        %9.1f ms (%s)\n", now_ms() - start, wifi.get_ip_address());
+
+    if(!open_socket(wifi, sock)) return 1;
+
+    /* round trip latency: small echoed messages */
+    for(int i = 0; i < BENCH_PING_COUNT; i++) {
+        double t = now_ms();
+
+        if(!(send_all(sock, out, BENCH_PING_SIZE) && recv_all(sock, in, BENCH_PING_SIZE))) return 1;
+
+        t = now_ms() - t;
+        sum += t;
+        if(t < min) min = t;
+        if(t > max) max = t;
+    }
+    printf("  echo %3d bytes: %9.3f ms avg, %.3f min, %.3f max (%d round trips)\n",
+           BENCH_PING_SIZE, sum / BENCH_PING_COUNT, min, max, BENCH_PING_COUNT);
+
+    /* send throughput: peer discards data */
+    emu.set_peer_echo(false);
+    start = now_ms();
+    if(!send_all(sock, out, total)) return 1;
+    double ms = now_ms() - start;
+    printf("  send:           %9.1f KiB/s (%u bytes in %.1f ms)\n", total / 1.024 / ms, total, ms);
+
+    /* receive throughput: peer pushes data in TCP segments (module socket id 0: only socket open) */
+    for(unsigned pos = 0; pos < total; pos += BENCH_SEGMENT) {
+        emu.peer_send(0, out + pos, std::min((unsigned)BENCH_SEGMENT, total - pos));
+    }
+    start = now_ms();
+    if(!recv_all(sock, in, total)) return 1;
+    ms = now_ms() - start;
+    printf("  receive:        %9.1f KiB/s (%u bytes in %.1f ms)%s\n", total / 1.024 / ms, total, ms,
+           (memcmp(in, out, total) == 0) ? "" : " DATA MISMATCH");
+    emu.set_peer_echo(true);
+
+    /* scripted indications: network lost & recovered ("+WIND:33"), peer closing the socket ("+WIND:58") */
+    emu.network_lost(50);
+    wait_ms(100);
+    bool ok = send_all(sock, out, BENCH_PING_SIZE) && recv_all(sock, in, BENCH_PING_SIZE);
+    printf("  network lost:   %9s\n", ok ? "recovered" : "FAILED");
+
+    emu.peer_close(0);
+    wait_ms(20);
+    nsapi_size_or_error_t ret = sock.recv(in, 1);
+    printf("  peer close:     %9s (recv %d)\n", (ret == 0) ? "detected" : "FAILED", (int)ret);
+    sock.close();
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+    emu.set_peer_echo(false);
+    ok = bench_server(wifi, emu, in, out) && ok;
+    emu.set_peer_echo(true);
+    ok = bench_websocket(wifi, emu, in, out) && ok;
+#else
+    printf("  accept:         %9s (no socket server on SPWFSA01)\n", "n.a.");
+    printf("  websocket:      %9s (no WebSocket client on SPWFSA01)\n", "n.a.");
+#endif
+
+    printf("  emulator:       %9u commands, %llu bytes in, %llu bytes out\n", emu.commands(),
+           (unsigned long long)emu.rx_bytes(), (unsigned long long)emu.tx_bytes());
+
+    wifi.disconnect();
+    emu.stop();
+
+    delete[] out;
+    delete[] in;
+    return (ok && (ret == 0)) ? 0 : 1;
+}
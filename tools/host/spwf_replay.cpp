@@ -0,0 +1,213 @@
+/* SPWFSAxx Devices
+ * Copyright (c) 2018 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Parsing & dispatch throughput of the driver replaying recorded module output at maximum speed
+ *
+ * Usage: spwf_replay [-c <corpora directory>] [-r <repetitions>]
+ *
+ * Replays (see `corpora/README.md`):
+ *  - `<dialect>/winds.txt`:  asynchronous indications, handled by `SPWFSAxx::_process_winds()`
+ *  - `<dialect>/scan.txt`:   reply to the scan command, parsed by `SPWFSAxx::_recv_ap()`
+ *  - `stream.txt`:           TCP stream read in through "+WIND:55" & `SOCKR` (`SPWFSAxx::_read_in()`)
+ */
+
+#include "SpwfSAInterface.h"
+#include "SpwfEmulator.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#define REPLAY_RCVTIMEO     (5000)
+#define REPLAY_SEGMENT      (730)   // module TCP MSS
+#define REPLAY_MAX_APS      (64)
+
+#if MBED_CONF_IDW0XX1_EXPANSION_BOARD == IDW04A1
+#define REPLAY_DIALECT      "spwfsa04"
+#else
+#define REPLAY_DIALECT      "spwfsa01"
+#endif
+
+static double now_ms(void) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* Note: corpora are stored with LF line ends, module output uses CR LF (except for raw data) */
+static bool load(const std::string &path, bool text, std::string *out) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    std::ostringstream raw;
+
+    if(!file) {
+        fprintf(stderr, "spwf_replay: cannot read %s\n", path.c_str());
+        return false;
+    }
+    raw << file.rdbuf();
+
+    out->clear();
+    for(char c : raw.str()) {
+        if(text && (c == '\n')) *out += '\r';
+        *out += c;
+    }
+    return true;
+}
+
+static void report(const char *name, uint64_t bytes, unsigned units, const char *unit, double ms) {
+    printf("  %-22s %8.3f MB/s, %9.0f %s/s (%llu bytes in %.1f ms)\n", name, bytes / 1000.0 / ms,
+           units * 1000.0 / ms, unit, (unsigned long long)bytes, ms);
+}
+
+static bool open_socket(SpwfSAInterface &wifi, TCPSocket &sock) {
+    int timeout = REPLAY_RCVTIMEO;
+
+    if((sock.open(&wifi) != NSAPI_ERROR_OK)
+            || (sock.connect(SocketAddress("192.168.1.10", 7)) != NSAPI_ERROR_OK)
+            || (sock.setsockopt(SPWFSA_SOCKOPT_LEVEL, SPWFSA_SOCKOPT_RCVTIMEO, &timeout, sizeof(timeout)) != NSAPI_ERROR_OK)) {
+        fprintf(stderr, "spwf_replay: opening socket failed\n");
+        return false;
+    }
+    return true;
+}
+
+/* Asynchronous indications: replay followed by closing the socket, done once the driver reports the hang-up */
+static bool replay_winds(SpwfEmulator &emu, SpwfSAInterface &wifi, const std::string &winds, int reps) {
+    unsigned lines = 0;
+    double ms = 0;
+
+    for(char c : winds) {
+        if(c == '\n') lines++;
+    }
+
+    for(int i = 0; i < reps; i++) {
+        TCPSocket sock;
+        spwf_pollfd_t pfd;
+
+        if(!open_socket(wifi, sock)) return false;
+        pfd.handle = sock.handle();
+        pfd.events = SPWFSA_POLL_IN;
+
+        double start = now_ms();
+        emu.replay(winds);
+        emu.peer_close(0); // socket opened last gets module socket id 0
+
+        do {
+            if(wifi.poll(&pfd, 1, REPLAY_RCVTIMEO) <= 0) {
+                fprintf(stderr, "spwf_replay: indications not processed\n");
+                return false;
+            }
+        } while(!(pfd.revents & SPWFSA_POLL_HUP));
+        ms += now_ms() - start;
+    }
+
+    report("winds (_process_winds)", (uint64_t)winds.size() * reps, lines * reps, "WINDs", ms);
+    return true;
+}
+
+/* Scan results: recorded reply to the scan command */
+static bool replay_scan(SpwfEmulator &emu, SpwfSAInterface &wifi, const std::string &scan, int reps) {
+    WiFiAccessPoint aps[REPLAY_MAX_APS];
+    unsigned found = 0;
+
+    emu.replay_reply("AT+S.SCAN", scan);
+
+    double start = now_ms();
+    for(int i = 0; i < reps; i++) {
+        nsapi_size_or_error_t ret = wifi.scan(aps, REPLAY_MAX_APS);
+        if(ret <= 0) {
+            fprintf(stderr, "spwf_replay: scan failed (%d)\n", (int)ret);
+            return false;
+        }
+        found += ret;
+    }
+    double ms = now_ms() - start;
+
+    report("scan (_recv_ap)", (uint64_t)scan.size() * reps, found, "APs", ms);
+    return true;
+}
+
+/* TCP stream: data announced by "+WIND:55" per segment, read in with `SOCKR` */
+static bool replay_stream(SpwfEmulator &emu, SpwfSAInterface &wifi, const std::string &stream, int reps) {
+    TCPSocket sock;
+    std::string in(stream.size(), '\0');
+    uint64_t out_start = emu.tx_bytes();
+
+    if(!open_socket(wifi, sock)) return false;
+
+    double start = now_ms();
+    for(int i = 0; i < reps; i++) {
+        for(size_t pos = 0; pos < stream.size(); pos += REPLAY_SEGMENT) {
+            emu.peer_send(0, stream.data() + pos, std::min((size_t)REPLAY_SEGMENT, stream.size() - pos));
+        }
+
+        for(size_t got = 0; got < stream.size(); ) {
+            nsapi_size_or_error_t ret = sock.recv(&in[got], stream.size() - got);
+            if(ret <= 0) {
+                fprintf(stderr, "spwf_replay: receive failed (%d)\n", (int)ret);
+                return false;
+            }
+            got += ret;
+        }
+        if(in != stream) {
+            fprintf(stderr, "spwf_replay: received data differs from stream\n");
+            return false;
+        }
+    }
+    double ms = now_ms() - start;
+
+    report("SOCKR (module output)", emu.tx_bytes() - out_start, (unsigned)((stream.size() * reps) / 1024), "KiB payload", ms);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    SpwfEmulator emu;
+    std::string dir = "corpora", winds, scan, stream;
+    int reps = 20, opt;
+
+    while((opt = getopt(argc, argv, "c:r:")) != -1) {
+        switch(opt) {
+            case 'c': dir = optarg; break;
+            case 'r': reps = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-c <corpora directory>] [-r <repetitions>]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    if(!(load(dir + "/" REPLAY_DIALECT "/winds.txt", true, &winds)
+            && load(dir + "/" REPLAY_DIALECT "/scan.txt", true, &scan)
+            && load(dir + "/stream.txt", false, &stream))) {
+        return 1;
+    }
+
+    if(!emu.start()) return 1;
+
+    SpwfSAInterface wifi(MBED_CONF_IDW0XX1_TX, MBED_CONF_IDW0XX1_RX, SPWFSAXX_RTS_PIN, SPWFSAXX_CTS_PIN);
+
+    if(wifi.connect("spwf-replay", "spwf-replay-pass", NSAPI_SECURITY_WPA2) != NSAPI_ERROR_OK) {
+        fprintf(stderr, "spwf_replay: connect failed\n");
+        return 1;
+    }
+
+    printf("%s replay, %d repetitions\n", REPLAY_DIALECT, reps);
+    bool ok = replay_winds(emu, wifi, winds, reps)
+              && replay_scan(emu, wifi, scan, reps)
+              && replay_stream(emu, wifi, stream, reps);
+
+    wifi.disconnect();
+    emu.stop();
+    return ok ? 0 : 1;
+}
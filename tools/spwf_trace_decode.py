@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+# SPWFSAxx Devices
+# Copyright (c) 2018 ARM Limited
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Decode binary trace records retrieved with `SpwfSAInterface::get_trace()`.
+
+Records are stored back to back, each one consisting of a `spwf_trace_hdr_t`
+header (8 bytes, target byte order) followed by `len` data bytes:
+
+    uint8_t type; uint8_t len; uint16_t arg; uint32_t us;
+
+The output follows the format of `SpwfSAInterface::dump_trace()`.
+
+Usage:
+    spwf_trace_decode.py [--big-endian] [--hex] [--absolute] [file]
+
+`file` (default: stdin) holds the raw bytes copied by `get_trace()`, or - with
+`--hex` - the same bytes as hex digits (whitespace and line breaks are ignored).
+"""
+
+import argparse
+import struct
+import sys
+
+TRACE_TYPES = ("RX", "TX", "WIND", "ERROR", "PKT", "CB")
+TRACE_UART_RX = 0
+TRACE_UART_TX = 1
+
+HDR_SIZE = 8
+
+
+def escape(data):
+    out = []
+    for b in data:
+        if 0x20 <= b <= 0x7e:
+            out.append(chr(b))
+        else:
+            out.append("\\x%02x" % b)
+    return "".join(out)
+
+
+def records(raw, endian):
+    hdr_fmt = endian + "BBHI"
+    pos = 0
+    while pos + HDR_SIZE <= len(raw):
+        rtype, rlen, arg, us = struct.unpack_from(hdr_fmt, raw, pos)
+        pos += HDR_SIZE
+        if pos + rlen > len(raw):
+            sys.stderr.write("spwf_trace_decode: truncated record at offset %d\n" % (pos - HDR_SIZE))
+            return
+        yield rtype, arg, us, raw[pos:pos + rlen]
+        pos += rlen
+    if pos != len(raw):
+        sys.stderr.write("spwf_trace_decode: %d trailing bytes ignored\n" % (len(raw) - pos))
+
+
+def decode(raw, endian, absolute, out):
+    first_us = None
+    value_fmt = endian + "I"
+
+    out.write("SPWF> trace (%d bytes):\n" % len(raw))
+    for rtype, arg, us, data in records(raw, endian):
+        if first_us is None:
+            first_us = us
+        ts = us if absolute else (us - first_us) & 0xffffffff
+        name = TRACE_TYPES[rtype] if rtype < len(TRACE_TYPES) else "?"
+
+        line = "SPWF> %10u %-5s %5u " % (ts, name, arg)
+        if rtype in (TRACE_UART_RX, TRACE_UART_TX):
+            line += escape(data)
+            if arg > len(data):
+                line += "..."
+        elif len(data) == 4:
+            line += "%u" % struct.unpack(value_fmt, data)[0]
+        out.write(line + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode SPWFSAxx binary trace records")
+    parser.add_argument("file", nargs="?", help="trace dump (default: stdin)")
+    parser.add_argument("--big-endian", action="store_true", help="target is big endian (default: little endian)")
+    parser.add_argument("--hex", action="store_true", help="input is a hex dump instead of raw bytes")
+    parser.add_argument("--absolute", action="store_true", help="print absolute `us_ticker_read()` timestamps")
+    args = parser.parse_args()
+
+    if args.file:
+        with open(args.file, "rb") as f:
+            raw = f.read()
+    else:
+        raw = sys.stdin.buffer.read()
+
+    if args.hex:
+        raw = bytes.fromhex("".join(raw.decode("ascii").split()))
+
+    decode(raw, ">" if args.big_endian else "<", args.absolute, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())